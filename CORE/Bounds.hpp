@@ -0,0 +1,88 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <algorithm>
+
+// Axis aligned box
+struct Aabb {
+	glm::vec3 min = glm::vec3(0.0f);
+	glm::vec3 max = glm::vec3(0.0f);
+
+	Aabb() = default;
+	Aabb(const glm::vec3& min, const glm::vec3& max) : min(min), max(max) {}
+
+	static Aabb fromCenter(const glm::vec3& center, const glm::vec3& halfExtents) {
+		return Aabb(center - halfExtents, center + halfExtents);
+	}
+
+	// Box around `local` once moved by `matrix`, the extents go through |upper 3x3|
+	static Aabb transformed(const glm::mat4& matrix, const Aabb& local) {
+		glm::vec3 center = glm::vec3(matrix * glm::vec4(local.getCenter(), 1.0f));
+		glm::vec3 half = local.getHalfExtents();
+		glm::vec3 extent(0.0f);
+		for (int c = 0; c < 3; c++) {
+			extent += glm::abs(glm::vec3(matrix[c])) * half[c];
+		}
+		return fromCenter(center, extent);
+	}
+
+	glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+	glm::vec3 getHalfExtents() const { return (max - min) * 0.5f; }
+
+	void merge(const Aabb& other) {
+		min = glm::min(min, other.min);
+		max = glm::max(max, other.max);
+	}
+
+	bool intersects(const Aabb& other) const {
+		return min.x <= other.max.x && other.min.x <= max.x
+			&& min.y <= other.max.y && other.min.y <= max.y
+			&& min.z <= other.max.z && other.min.z <= max.z;
+	}
+
+	bool intersectsSphere(const glm::vec3& center, float radius) const {
+		glm::vec3 d = center - glm::clamp(center, min, max);
+		return glm::dot(d, d) <= radius * radius;
+	}
+
+	// Slab test, inverseDirection = 1 / direction. `distance` is where the ray enters, 0 from inside
+	bool intersectsRay(const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& distance) const {
+		glm::vec3 t0 = (min - origin) * inverseDirection;
+		glm::vec3 t1 = (max - origin) * inverseDirection;
+		glm::vec3 tMin = glm::min(t0, t1);
+		glm::vec3 tMax = glm::max(t0, t1);
+		float enter = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+		float exit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDistance));
+		distance = enter;
+		return enter <= exit;
+	}
+};
+
+// Six inward planes (normal, d) of a projection * view matrix, OpenGL clip space
+struct Frustum {
+	glm::vec4 planes[6];
+
+	explicit Frustum(const glm::mat4& viewProjection) {
+		glm::mat4 rows = glm::transpose(viewProjection);
+		planes[0] = rows[3] + rows[0]; // left
+		planes[1] = rows[3] - rows[0]; // right
+		planes[2] = rows[3] + rows[1]; // bottom
+		planes[3] = rows[3] - rows[1]; // top
+		planes[4] = rows[3] + rows[2]; // near
+		planes[5] = rows[3] - rows[2]; // far
+		for (glm::vec4& plane : planes) {
+			plane /= glm::length(glm::vec3(plane));
+		}
+	}
+
+	// Conservative: false only when the box lies fully behind one plane
+	bool intersects(const Aabb& box) const {
+		for (const glm::vec4& plane : planes) {
+			glm::vec3 farthest(plane.x >= 0.0f ? box.max.x : box.min.x,
+				plane.y >= 0.0f ? box.max.y : box.min.y,
+				plane.z >= 0.0f ? box.max.z : box.min.z);
+			if (glm::dot(glm::vec3(plane), farthest) + plane.w < 0.0f)
+				return false;
+		}
+		return true;
+	}
+};
@@ -10,6 +10,7 @@
 
 
 class Camera : public Transform, public Component {
+	COMPONENT_TYPE(Camera, Component)
 public:
 	Camera(float fov = 45.0f, float aspectRatio = 16.0f / 9.0f, float nearPlane = 0.1f, float farPlane = 1000.0f);
 
@@ -1,18 +1,110 @@
 #pragma once
+#include <cstdint>
 
 class GameObject;
+class ComponentRegistry;
+struct PhysicsEvent;
+
+// Compile-time ids of the component types. GameObject keeps a bitmask of the types it
+// holds and the slot of the first component of each, so getComponent<T>() is O(1) and
+// needs no RTTI. Base classes have ids too: a CubePhysics sets the CubePhysics,
+// PhysicsComponent and Component bits, and getComponent<PhysicsComponent>() finds it.
+namespace ComponentType
+{
+	enum : uint32_t {
+		Component,
+		PhysicsComponent,
+		CubePhysics,
+		SpherePhysics,
+		MeshPhysics,
+		RenderComponent,
+		CubeRenderer,
+		SphereRenderer,
+		ModelRenderer,
+		CubeMap,
+		UICursorComponent,
+		Camera,
+		Light,
+
+		FirstUser,     // game components declare themselves with COMPONENT_TYPE_ID(Type, Base, FirstUser + n)
+		Count = 32     // bits of the mask
+	};
+}
+
+// Declares the id and hierarchy mask of a component class, at the top of its body.
+// getComponent<T>() refuses types that did not declare themselves.
+#define COMPONENT_TYPE_ID(Type, BaseType, Id) \
+public: \
+	using ComponentSelf = Type; \
+	static constexpr uint32_t componentTypeId = Id; \
+	static constexpr uint32_t componentTypeMask = (1u << (Id)) | BaseType::componentTypeMask; \
+	static_assert((Id) < ComponentType::Count, "Too many component types for the mask");
+
+#define COMPONENT_TYPE(Type, BaseType) COMPONENT_TYPE_ID(Type, BaseType, ComponentType::Type)
+
+// Where Component::update runs in Scene::update: before the physics step, after it
+// (bodies synced back), or once the world matrices are up to date
+enum class UpdatePhase : uint8_t { PRE_PHYSICS, POST_PHYSICS, PRE_RENDER, Count };
+
+// State outside the component itself that an update reads or writes
+namespace ComponentAccess
+{
+	enum : uint32_t {
+		NONE = 0,
+		TRANSFORM = 1 << 0, // the owner's transform, world values are only clean in PRE_RENDER
+		PHYSICS = 1 << 1,   // PhysX actors and the recorder, writes are serialized
+		RENDER = 1 << 2,    // GL objects and shaders
+		LIGHTS = 1 << 3,    // LightManager
+		SCENE = 1 << 4,     // other objects, spawning, destroying, parenting
+		ALL = 0xFFFFFFFFu
+	};
+}
+
+struct ComponentUpdate {
+	UpdatePhase phase;
+	uint32_t reads;
+	uint32_t writes;
+	bool parallel;
+};
+
+// Declares the phase and access sets of the update of a component type, after
+// COMPONENT_TYPE. The components of the type are then updated in parallel chunks on
+// the JobSystem when the sets allow it (see ComponentRegistry::update). Derived
+// types inherit the declaration, a subclass doing more in update redeclares it.
+#define COMPONENT_UPDATE(Phase, Reads, Writes) \
+public: \
+	static constexpr ComponentUpdate componentUpdate{ UpdatePhase::Phase, Reads, Writes, true };
 
 class Component
 {
 public:
+	using ComponentSelf = Component;
+	static constexpr uint32_t componentTypeId = ComponentType::Component;
+	static constexpr uint32_t componentTypeMask = 1u << ComponentType::Component;
+	// Undeclared updates may touch anything: serial, after the physics step
+	static constexpr ComponentUpdate componentUpdate{ UpdatePhase::POST_PHYSICS, ComponentAccess::ALL, ComponentAccess::ALL, false };
+
 	virtual ~Component() = default;
 	virtual void init() {};
 	virtual void update(float dt) {};
+	// Batch of contact / trigger / sleep events after a physics step, see PhysicsComponent::subscribe
+	virtual void onPhysicsEvents(const PhysicsEvent* events, uint32_t count) {};
 
 	GameObject* getGameObject() { return m_gameObject; }
+	// Most derived declared type (ComponentType id)
+	uint32_t getTypeId() const { return m_typeId; }
 	void setGameObject(GameObject* gameObject) { m_gameObject = gameObject; }
 protected:
 
 	GameObject* m_gameObject;
 
+private:
+	friend class GameObject;
+	friend class ComponentRegistry;
+
+	// Exact type and its update declaration, set by GameObject::addComponent, and position in the scene ComponentRegistry
+	uint32_t m_typeId = ComponentType::Component;
+	const ComponentUpdate* m_update = &Component::componentUpdate;
+	uint32_t m_registryIndex = UINT32_MAX;
+
 }; // class Component
@@ -0,0 +1,38 @@
+#include "ComponentPool.hpp"
+#include <algorithm>
+#include <new>
+
+
+namespace ComponentPools
+{
+	SlabPool::SlabPool(size_t slotSize, size_t alignment, size_t slotsPerChunk)
+		: m_alignment(std::max(alignment, alignof(void*))), m_slotsPerChunk(slotsPerChunk) {
+		// Free slots hold the next pointer of the free list
+		size_t size = std::max(slotSize, sizeof(void*));
+		m_slotSize = (size + m_alignment - 1) / m_alignment * m_alignment;
+	}
+
+	void* SlabPool::allocate() {
+		if (!m_freeList) {
+			char* chunk = static_cast<char*>(::operator new(m_slotSize * m_slotsPerChunk, std::align_val_t(m_alignment)));
+			m_chunks.push_back(chunk);
+			// Threaded back to front so the first allocations go in address order
+			for (size_t i = m_slotsPerChunk; i-- > 0;) {
+				void* slot = chunk + i * m_slotSize;
+				*static_cast<void**>(slot) = m_freeList;
+				m_freeList = slot;
+			}
+		}
+
+		void* slot = m_freeList;
+		m_freeList = *static_cast<void**>(slot);
+		m_live++;
+		return slot;
+	}
+
+	void SlabPool::deallocate(void* slot) {
+		*static_cast<void**>(slot) = m_freeList;
+		m_freeList = slot;
+		m_live--;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Contiguous storage for components. GameObject::addComponent allocates every component
+// (with its shared_ptr control block) from a slab of its own size class, so components
+// of one type sit next to each other instead of wherever make_shared put them.
+namespace ComponentPools
+{
+	// Fixed-size slots carved from chunks. Chunks are kept for the whole run and freed
+	// slots are reused first, so a type that is spawned and destroyed stays packed.
+	class SlabPool {
+	public:
+		SlabPool(size_t slotSize, size_t alignment, size_t slotsPerChunk = 256);
+
+		void* allocate();
+		void deallocate(void* slot);
+
+		size_t getLiveCount() const { return m_live; }
+		size_t getCapacity() const { return m_chunks.size() * m_slotsPerChunk; }
+
+	private:
+		size_t m_slotSize;
+		size_t m_alignment;
+		size_t m_slotsPerChunk;
+		std::vector<void*> m_chunks;
+		void* m_freeList = nullptr;
+		size_t m_live = 0;
+	};
+
+	// One pool per size class. Never destroyed: components held by statics may be
+	// released after the other globals are gone.
+	template<size_t Size, size_t Align>
+	SlabPool& slabFor() {
+		static SlabPool* pool = new SlabPool(Size, Align);
+		return *pool;
+	}
+
+	// std::allocate_shared allocator, rebound by the library to its control block type
+	template<typename T>
+	struct Allocator {
+		using value_type = T;
+
+		Allocator() = default;
+		template<typename U>
+		Allocator(const Allocator<U>&) {}
+
+		T* allocate(size_t n) {
+			if (n == 1)
+				return static_cast<T*>(slabFor<sizeof(T), alignof(T)>().allocate());
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+
+		void deallocate(T* p, size_t n) {
+			if (n == 1)
+				slabFor<sizeof(T), alignof(T)>().deallocate(p);
+			else
+				::operator delete(p);
+		}
+
+		template<typename U>
+		bool operator==(const Allocator<U>&) const { return true; }
+		template<typename U>
+		bool operator!=(const Allocator<U>&) const { return false; }
+	};
+
+	template<typename T, typename... Args>
+	std::shared_ptr<T> make(Args&&... args) {
+		return std::allocate_shared<T>(Allocator<T>(), std::forward<Args>(args)...);
+	}
+}
@@ -0,0 +1,128 @@
+#include "ComponentRegistry.hpp"
+#include "Jobs/JobSystem.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+	// Components per job, updates are small
+	constexpr size_t updateGrainSize = 512;
+
+	// A transform write reaches the children, and a child reads its parent
+	bool isLinked(const GameObject* owner) {
+		return owner->getParent() || !owner->getChildren().empty();
+	}
+}
+
+
+void ComponentRegistry::add(Component* component, GameObject* owner, uint32_t mask) {
+	if (component->m_registryIndex != UINT32_MAX) return;
+
+	Table& table = m_tables[component->m_typeId];
+	m_tableMasks[component->m_typeId] = mask;
+	m_tableUpdates[component->m_typeId] = component->m_update;
+	component->m_registryIndex = static_cast<uint32_t>(table.components.size());
+	table.components.push_back(component);
+	table.owners.push_back(owner);
+}
+
+void ComponentRegistry::remove(Component* component) {
+	uint32_t index = component->m_registryIndex;
+	if (index == UINT32_MAX) return;
+
+	Table& table = m_tables[component->m_typeId];
+	Component* last = table.components.back();
+	table.components[index] = last;
+	table.owners[index] = table.owners.back();
+	last->m_registryIndex = index;
+	table.components.pop_back();
+	table.owners.pop_back();
+	component->m_registryIndex = UINT32_MAX;
+}
+
+bool ComponentRegistry::isParallelSafe(const ComponentUpdate& update) {
+	if (!update.parallel) return false;
+	if (update.writes & ~ComponentAccess::TRANSFORM) return false;
+	return !((update.writes & ComponentAccess::TRANSFORM) && (update.reads & ComponentAccess::SCENE));
+}
+
+void ComponentRegistry::update(UpdatePhase phase, float dt) {
+	for (uint32_t type = 0; type < ComponentType::Count; type++) {
+		Table& table = m_tables[type];
+		if (table.components.empty() || m_tableUpdates[type]->phase != phase) continue;
+
+		const ComponentUpdate& declared = *m_tableUpdates[type];
+		bool parallel = m_parallelEnabled && isParallelSafe(declared);
+		if (parallel && m_validation) {
+			validate(type, dt);
+			continue;
+		}
+
+		if (!parallel || JobSystem::getThreadCount() == 0 || table.components.size() <= updateGrainSize) {
+			// Indexed, an update may spawn objects and grow the table
+			for (size_t i = 0; i < table.components.size(); i++) {
+				table.components[i]->update(dt);
+			}
+			continue;
+		}
+
+		bool writesTransform = (declared.writes & ComponentAccess::TRANSFORM) != 0;
+		JobSystem::parallelFor(table.components.size(), updateGrainSize, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				if (writesTransform && isLinked(table.owners[i])) continue;
+				table.components[i]->update(dt);
+			}
+		});
+		if (writesTransform) {
+			for (size_t i = 0; i < table.components.size(); i++) {
+				if (isLinked(table.owners[i])) table.components[i]->update(dt);
+			}
+		}
+	}
+}
+
+void ComponentRegistry::validate(uint32_t type, float dt) {
+	Table& table = m_tables[type];
+	const ComponentUpdate& declared = *m_tableUpdates[type];
+
+	// Chunks would write one transform from two threads
+	if (declared.writes & ComponentAccess::TRANSFORM) {
+		m_ownersScratch.assign(table.owners.begin(), table.owners.end());
+		std::sort(m_ownersScratch.begin(), m_ownersScratch.end());
+		auto duplicate = std::adjacent_find(m_ownersScratch.begin(), m_ownersScratch.end());
+		if (duplicate != m_ownersScratch.end())
+			reportConflict(type, "writes the transform of one object from two components", *duplicate);
+	}
+
+	size_t totalBefore = getTotalCount();
+	for (size_t i = 0; i < table.components.size(); i++) {
+		GameObject* owner = table.owners[i];
+		glm::vec3 position = owner->getPosition();
+		glm::quat rotation = owner->getRotationQuaternion();
+		glm::vec3 scale = owner->getScale();
+
+		table.components[i]->update(dt);
+
+		if (!(declared.writes & ComponentAccess::TRANSFORM) &&
+			(owner->getPosition() != position || owner->getRotationQuaternion() != rotation || owner->getScale() != scale))
+			reportConflict(type, "writes the transform without declaring TRANSFORM", owner);
+	}
+	if (getTotalCount() != totalBefore)
+		reportConflict(type, "adds or removes components, a SCENE write", nullptr);
+}
+
+void ComponentRegistry::reportConflict(uint32_t type, const char* what, GameObject* owner) {
+	m_conflictCount++;
+	if (m_reportedTypes & (1u << type)) return;
+	m_reportedTypes |= 1u << type;
+
+	std::cerr << "ComponentRegistry: component type " << type << " " << what;
+	if (owner) std::cerr << " (object '" << owner->getName() << "')";
+	std::cerr << ", it cannot be updated in parallel" << std::endl;
+}
+
+size_t ComponentRegistry::getTotalCount() const {
+	size_t count = 0;
+	for (const Table& table : m_tables) count += table.components.size();
+	return count;
+}
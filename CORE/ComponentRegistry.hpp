@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "Component.hpp"
+#include "GameObject.hpp"
+
+// Packed per-type tables of the components of one Scene. Each table stores its
+// component pointers and their owners in two parallel arrays (structure of arrays),
+// so systems walk dense memory instead of going object by object through
+// GameObject::m_components. Removal swaps the last entry in, order is not kept.
+class ComponentRegistry {
+public:
+	// `mask` is the componentTypeMask of the exact component type
+	void add(Component* component, GameObject* owner, uint32_t mask);
+	void remove(Component* component);
+
+	// Calls f(GameObject&, A&, Rest&...) for every component of type A (derived types
+	// included) whose object also holds every type in Rest.
+	template<typename A, typename... Rest, typename F>
+	void view(F&& f) {
+		static_assert(std::is_same<typename A::ComponentSelf, A>::value, "A must declare itself with COMPONENT_TYPE");
+		const uint32_t bit = 1u << A::componentTypeId;
+		for (uint32_t type = 0; type < ComponentType::Count; type++) {
+			if (!(m_tableMasks[type] & bit)) continue;
+
+			Table& table = m_tables[type];
+			for (size_t i = 0; i < table.components.size(); i++) {
+				GameObject* owner = table.owners[i];
+				if (!(owner->hasComponent<Rest>() && ...)) continue;
+				f(*owner, *static_cast<A*>(table.components[i]), *owner->getComponentPtr<Rest>()...);
+			}
+		}
+	}
+
+	// Component::update of the components declared for `phase`, one type after the
+	// other in type id order. A type whose COMPONENT_UPDATE sets pass isParallelSafe is
+	// split in chunks on the JobSystem. Since a transform write marks the children
+	// dirty, owners with a parent or children are updated serially after the chunks.
+	void update(UpdatePhase phase, float dt);
+
+	// Parallel types may write nothing but their owner's transform, and then must not
+	// read other objects
+	static bool isParallelSafe(const ComponentUpdate& update);
+
+	// Off: every type is updated serially
+	void setParallelEnabled(bool enabled) { m_parallelEnabled = enabled; }
+	bool isParallelEnabled() const { return m_parallelEnabled; }
+
+	// Validation runs the parallel types serially and checks their declarations: two
+	// components of the type on one owner, undeclared transform writes, components
+	// added or removed. Each offending type is reported once.
+	void setValidation(bool enabled) { m_validation = enabled; }
+	bool isValidationEnabled() const { return m_validation; }
+	uint32_t getConflictCount() const { return m_conflictCount; }
+
+	size_t getCount(uint32_t typeId) const { return m_tables[typeId].components.size(); }
+	size_t getTotalCount() const;
+
+private:
+	struct Table {
+		std::vector<Component*> components;
+		std::vector<GameObject*> owners;
+	};
+
+	void validate(uint32_t type, float dt);
+	void reportConflict(uint32_t type, const char* what, GameObject* owner);
+
+	std::array<Table, ComponentType::Count> m_tables;
+	// Hierarchy mask and update declaration of the exact type stored in each table
+	std::array<uint32_t, ComponentType::Count> m_tableMasks{};
+	std::array<const ComponentUpdate*, ComponentType::Count> m_tableUpdates{};
+
+	bool m_parallelEnabled = true;
+	bool m_validation = false;
+	uint32_t m_conflictCount = 0;
+	uint32_t m_reportedTypes = 0;
+	std::vector<GameObject*> m_ownersScratch;
+};
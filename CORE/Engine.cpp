@@ -1,5 +1,6 @@
 #include "Engine.hpp"
 #include "Physics.hpp"
+#include "Jobs/JobSystem.hpp"
 #include "Shader.hpp"
 #include "Prefabs/SomePrefabs.hpp"
 #include <iostream>
@@ -8,7 +9,9 @@
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "UI/SceneObjectEditor.hpp"
+#include "UI/PhysicsStatsPanel.hpp"
 #include "Scene.hpp"
+#include "SceneFile.hpp"
 
 #include <chrono>
 
@@ -17,6 +20,7 @@ high_resolution_clock::time_point lastTime = high_resolution_clock::now();
 
 namespace Engine {
 	bool m_isRunning = false;
+	bool m_isHeadless = false;
 	float m_dt = 0;
 
 
@@ -31,6 +35,7 @@ namespace Engine {
 
 	void init() {
 		registerPrefabs();
+		SceneFile::registerBuiltinComponents();
 
 		Window::WindowProps props;
 		props.title = "CLC";
@@ -40,14 +45,34 @@ namespace Engine {
 		std::cout << Window::isVSync() << std::endl;
 		Input::init();
 		ShaderManager::loadConfigs("../../../Config/shaders.json");
-		Physics::init();
+		JobSystem::init();
+		Physics::init(Physics::loadConfig("../../../Config/physics.json"));
+		PrefabManager::warmPools();
 		LightManager::init();
 
 	}
 
+	void initHeadless() {
+		m_isHeadless = true;
+		registerPrefabs();
+		SceneFile::registerBuiltinComponents();
+		JobSystem::init();
+		Physics::init(Physics::loadConfig("../../../Config/physics.json"));
+		PrefabManager::warmPools();
+	}
+
+	bool isHeadless() { return m_isHeadless; }
+
 	void shutdown() {
+		if (m_isHeadless) {
+			Physics::shutdown();
+			JobSystem::shutdown();
+			m_isRunning = false;
+			return;
+		}
 		LightManager::shutdown();
 		Physics::shutdown();
+		JobSystem::shutdown();
 		ShaderManager::cleanup();
 		TextureManager::clear();
 		Input::shutdown();
@@ -90,6 +115,7 @@ namespace Engine {
 		// Render UI
 		UI::renderImGuiSceneHierarchy(scene);
 		UI::renderImGuiObjectEditor();
+		UI::renderImGuiPhysicsStats(scene);
 
 		// Render ImGui
 		ImGui::Render();
@@ -97,6 +123,7 @@ namespace Engine {
 
 	}
 	void render(Scene* scene) {
+		LightManager::updateIndex();
 		renderFrame(scene, LightManager::getShadowMapper());
 		// Render scene normally
 		scene->renderMainPass();
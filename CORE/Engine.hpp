@@ -10,6 +10,10 @@ class Scene;
 namespace Engine{
 
     void init();
+    // Physics, jobs and prefabs only: no window, GL context, shaders or UI.
+    // Prefabs skip their render components in this mode.
+    void initHeadless();
+    bool isHeadless();
     void update(Scene* scene = nullptr);
     void shutdown();
 
@@ -1,7 +1,55 @@
 #include "GameObject.hpp"
 #include "PhysicsComponents/PhysicsComponent.hpp"
+#include "ComponentRegistry.hpp"
 
 
+std::shared_ptr<GameObject> GameObject::create(const char* name) {
+	if (SceneMemory* memory = SceneMemory::getCurrent())
+		return std::allocate_shared<GameObject>(std::pmr::polymorphic_allocator<GameObject>(memory), name, memory);
+	return std::make_shared<GameObject>(name);
+}
+
+GameObject::~GameObject() {
+	setRegistry(nullptr);
+}
+
+void GameObject::setRegistry(ComponentRegistry* registry) {
+	if (registry == m_registry) return;
+
+	if (m_registry) {
+		for (auto& component : m_components)
+			m_registry->remove(component.get());
+	}
+	m_registry = registry;
+	if (m_registry) {
+		for (size_t i = 0; i < m_components.size(); i++)
+			m_registry->add(m_components[i].get(), this, m_componentMasks[i]);
+	}
+}
+
+void GameObject::addToRegistry(Component* component, uint32_t mask) {
+	m_registry->add(component, this, mask);
+}
+
+Aabb GameObject::getWorldBounds() const {
+	const glm::mat4& model = getModelMatrix();
+	Aabb bounds;
+	bool found = false;
+	const uint32_t bit = 1u << RenderComponent::componentTypeId;
+	for (size_t i = 0; i < m_components.size(); i++) {
+		Aabb local;
+		if (!(m_componentMasks[i] & bit) || !static_cast<const RenderComponent*>(m_components[i].get())->getLocalBounds(local))
+			continue;
+		Aabb world = Aabb::transformed(model, local);
+		if (found) bounds.merge(world);
+		else bounds = world;
+		found = true;
+	}
+	if (!found)
+		bounds = Aabb::transformed(model, Aabb(glm::vec3(-0.5f), glm::vec3(0.5f)));
+	return bounds;
+}
+
 // Update all components
 void GameObject::update(float dt) {
 	for (auto& component : m_components) {
@@ -22,13 +70,13 @@ void GameObject::render(std::shared_ptr<Camera> cam) {
 	}
 }
 
-// Set position and update physics component if exists
+// Set position, the physics body follows in the batched write before the next step
 void GameObject::setPosition(const glm::vec3& position, bool update_physx){
 
 	Transform::setPosition(position);
 	if (update_physx) {
 		if (auto physicsComponent = getComponent<PhysicsComponent>()) {
-			physicsComponent->setPosition(position);
+			physicsComponent->queuePoseWrite();
 		}
 	}
 }
@@ -40,7 +88,7 @@ void GameObject::setRotation(const glm::vec3& rotation, bool update_physx) {
 
 	if (update_physx) {
 		if (auto physicsComponent = getComponent<PhysicsComponent>())
-			physicsComponent->setRotation(rotation);
+			physicsComponent->queuePoseWrite();
 	}
 }
 
@@ -52,7 +100,7 @@ void GameObject::setRotationQuaternion(const glm::quat& rotation, bool update_ph
 		// Update physics component if it exists
 		auto physicsComponent = getComponent<PhysicsComponent>();
 		if (physicsComponent) {
-			physicsComponent->updatePhysX();
+			physicsComponent->queuePoseWrite();
 		}
 	}
 }
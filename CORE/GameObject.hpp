@@ -2,13 +2,30 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <array>
+#include <memory_resource>
 #include "Debug.hpp"
 #include "Component.hpp"
+#include "ComponentPool.hpp"
+#include "SceneMemory.hpp"
 #include "Transform.hpp"
 #include "RenderComponents/RenderComponent.hpp"
 
 
 class PhysicsComponent;
+class Scene;
+
+// Weak reference to a scene object: the slot index plus the generation the slot had
+// when the handle was made. Scene::resolve returns nullptr once the object is destroyed,
+// even if the slot was reused since.
+struct GameObjectHandle {
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+
+	bool isNull() const { return index == UINT32_MAX; }
+	bool operator==(const GameObjectHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const GameObjectHandle& other) const { return !(*this == other); }
+};
 
 class GameObject : public Transform
 {
@@ -16,13 +33,21 @@ public:
 	
 	GameObject() : Transform() {}
 	GameObject(const char* name) : Transform(), m_name(name) {}
+	// Components, name and component lists come from `memory`, see create
+	GameObject(const char* name, SceneMemory* memory)
+		: Transform(), m_memory(memory), m_components(memory), m_componentMasks(memory), m_name(name, memory) {}
+	~GameObject();
+
+	// Allocated in the SceneMemory of the current SceneMemory::Scope, on the heap without one
+	static std::shared_ptr<GameObject> create(const char* name = "");
+	SceneMemory* getMemory() const { return m_memory; }
 	template<typename T>
 	std::shared_ptr<T> addComponent()
 	{
 		static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
-		std::shared_ptr<T> component = std::make_shared<T>();
+		std::shared_ptr<T> component = makeComponent<T>();
 		component->setGameObject(this);
-		m_components.push_back(component);
+		registerComponent(component);
 		component->init();
 		return component;
 	}
@@ -32,36 +57,67 @@ public:
 	std::shared_ptr<T> addComponent(Args&&... args)
 	{
 		static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
-		std::shared_ptr<T> component = std::make_shared<T>(std::forward<Args>(args)...);
+		std::shared_ptr<T> component = makeComponent<T>(std::forward<Args>(args)...);
 		component->setGameObject(this);
-		m_components.push_back(component);
+		registerComponent(component);
 		component->init();
 		//if physx component put gameobject ptr as userdata
-		if (auto physicsComponent = std::dynamic_pointer_cast<PhysicsComponent>(component))
+		if constexpr ((T::componentTypeMask & (1u << ComponentType::PhysicsComponent)) != 0)
 		{
-			physicsComponent->setUserData(this);
+			static_cast<PhysicsComponent*>(component.get())->setUserData(this);
 		}
 		return component;
 	}	
 
 
+	// First component of type T or derived from it, in insertion order
 	template<typename T>
 	std::shared_ptr<T> getComponent()
 	{
-		for (auto& component : m_components)
+		static_assert(std::is_same<typename T::ComponentSelf, T>::value, "T must declare itself with COMPONENT_TYPE");
+		if (!hasComponent<T>())
+			return nullptr;
+		return std::static_pointer_cast<T>(m_components[m_componentSlots[T::componentTypeId]]);
+	}
+
+	// Same lookup without the shared_ptr copy, for per-frame loops
+	template<typename T>
+	T* getComponentPtr()
+	{
+		static_assert(std::is_same<typename T::ComponentSelf, T>::value, "T must declare itself with COMPONENT_TYPE");
+		if (!hasComponent<T>())
+			return nullptr;
+		return static_cast<T*>(m_components[m_componentSlots[T::componentTypeId]].get());
+	}
+
+	template<typename T>
+	bool hasComponent() const
+	{
+		return (m_componentMask & (1u << T::componentTypeId)) != 0;
+	}
+
+	// Calls f(T*) on every component of type T or derived from it
+	template<typename T, typename F>
+	void forEachComponent(F&& f)
+	{
+		static_assert(std::is_same<typename T::ComponentSelf, T>::value, "T must declare itself with COMPONENT_TYPE");
+		const uint32_t bit = 1u << T::componentTypeId;
+		if (!(m_componentMask & bit))
+			return;
+		for (size_t i = m_componentSlots[T::componentTypeId]; i < m_components.size(); i++)
 		{
-			std::shared_ptr<T> casted = std::dynamic_pointer_cast<T>(component);
-			if (casted)
-			{
-				return casted;
-			}
+			if (m_componentMasks[i] & bit)
+				f(static_cast<T*>(m_components[i].get()));
 		}
-		return nullptr;
 	}
 
 	// Update all components
 	void update(float dt);
 
+	// Scene tables the components are listed in (see ComponentRegistry), nullptr takes them out
+	void setRegistry(ComponentRegistry* registry);
+	ComponentRegistry* getRegistry() const { return m_registry; }
+
 	// Render if has RenderComponent
 	void render(const glm::mat4& view, const glm::mat4& projection);
 
@@ -81,45 +137,93 @@ public:
 	//set shader for all render components
 	void setShader(std::shared_ptr<ShaderProgram> shader)
 	{
-		for (auto& component : m_components)
-		{
-			if (auto renderComponent = std::dynamic_pointer_cast<RenderComponent>(component))
-			{
-				renderComponent->setShader(shader);
-			}
-		}
+		forEachComponent<RenderComponent>([&](RenderComponent* renderComponent) {
+			renderComponent->setShader(shader);
+		});
 	}
 
 	//render raw geometry for all render components
 	void renderRawGeometry(const glm::mat4& lightSpaceMatrix)
 	{
-		for (auto& component : m_components)
-		{
-			if (auto renderComponent = std::dynamic_pointer_cast<RenderComponent>(component))
-			{
-				renderComponent->renderRawGeometry(lightSpaceMatrix);
-			}
-		}
+		forEachComponent<RenderComponent>([&](RenderComponent* renderComponent) {
+			renderComponent->renderRawGeometry(lightSpaceMatrix);
+		});
 	}
 	//render with materials for all render components
 	void renderWithMaterials(const std::shared_ptr<Camera>& cam)
 	{
-		for (auto& component : m_components)
-		{
-			if (auto renderComponent = std::dynamic_pointer_cast<RenderComponent>(component))
-			{
-				renderComponent->renderWithMaterials(cam);
-			}
-		}
+		forEachComponent<RenderComponent>([&](RenderComponent* renderComponent) {
+			renderComponent->renderWithMaterials(cam);
+		});
 	}
 
 
 
+	// World box of the render components, a unit box around the object without any
+	Aabb getWorldBounds() const;
+
 	const char* getName() const { return m_name.c_str(); }
+
+	// Null until the object is added to a scene
+	GameObjectHandle getHandle() const { return m_handle; }
+	// Scene::destroyGameObject was called, the object goes away at the next flush
+	bool isPendingDestroy() const { return m_pendingDestroy; }
 	
 private:
-	std::vector<std::shared_ptr<Component>> m_components;
+	// Scene memory when the object has one, the shared slab pools otherwise
+	template<typename T, typename... Args>
+	std::shared_ptr<T> makeComponent(Args&&... args)
+	{
+		if (m_memory)
+			return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(m_memory), std::forward<Args>(args)...);
+		return ComponentPools::make<T>(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	void registerComponent(const std::shared_ptr<T>& component)
+	{
+		static_assert(std::is_same<typename T::ComponentSelf, T>::value, "T must declare itself with COMPONENT_TYPE");
+		ENGINE_ASSERT(m_components.size() < 255, "Too many components on one GameObject");
+		const uint32_t mask = T::componentTypeMask;
+		const uint8_t slot = static_cast<uint8_t>(m_components.size());
+
+		// Types seen for the first time point at this component
+		for (uint32_t type = 0; type < ComponentType::Count; type++)
+		{
+			if ((mask & ~m_componentMask) & (1u << type))
+				m_componentSlots[type] = slot;
+		}
+		m_componentMask |= mask;
+
+		component->m_typeId = T::componentTypeId;
+		component->m_update = &T::componentUpdate;
+		m_components.push_back(component);
+		m_componentMasks.push_back(mask);
+		if (m_registry)
+			addToRegistry(component.get(), mask);
+		// New geometry, the scene refreshes the world box as for a move
+		if constexpr ((T::componentTypeMask & (1u << ComponentType::RenderComponent)) != 0)
+			markWorldDirty();
+	}
+
+	void addToRegistry(Component* component, uint32_t mask);
+
+	// Before the containers that allocate from it
+	SceneMemory* m_memory = nullptr;
+	std::pmr::vector<std::shared_ptr<Component>> m_components;
+	// Type and base class bits of each component, parallel to m_components
+	std::pmr::vector<uint32_t> m_componentMasks;
+	// Union of the masks, and index of the first component of each type when its bit is set
+	uint32_t m_componentMask = 0;
+	std::array<uint8_t, ComponentType::Count> m_componentSlots{};
+	ComponentRegistry* m_registry = nullptr;
 	//gameobject name
-	std::string m_name;
+	std::pmr::string m_name;
+
+	friend class Scene;
+	GameObjectHandle m_handle;
+	bool m_pendingDestroy = false;
+	// Proxy in the scene SpatialIndex
+	uint32_t m_spatialId = UINT32_MAX;
 
 }; // class GameObject
@@ -0,0 +1,305 @@
+#include "JobSystem.hpp"
+#include "../Debug.hpp"
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <algorithm>
+
+namespace JobSystem
+{
+	namespace Internal
+	{
+		struct Task {
+			Job job;
+			Counter* counter = nullptr;
+		};
+
+		// Owner works at the back, thieves at the front
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		std::vector<std::thread> workers;
+		// Set before the threads start, workers.size() changes while they do
+		uint32_t workerCount = 0;
+		// One per worker, plus the shared one at the end for threads outside the pool
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::atomic<bool> running{ false };
+
+		// Tasks sitting in any queue, workers only sleep when it is zero
+		std::atomic<uint32_t> queued{ 0 };
+		std::atomic<uint32_t> sleeping{ 0 };
+		std::mutex sleepMutex;
+		std::condition_variable wakeCondition;
+
+		thread_local uint32_t threadIndex = UINT32_MAX;
+
+		// runBackground jobs, apart so waiting threads never pick one up
+		Queue background;
+		std::atomic<uint32_t> backgroundQueued{ 0 };
+		std::atomic<uint32_t> backgroundRunning{ 0 };
+		uint32_t backgroundLimit = 1;
+
+		bool backgroundReady() {
+			return backgroundQueued.load() > 0 && backgroundRunning.load() < backgroundLimit;
+		}
+
+		uint32_t queueOf(uint32_t index) {
+			return index < workerCount ? index : workerCount;
+		}
+
+		void retain(Counter* counter) {
+			if (counter)
+				counter->m_value.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void push(Task task);
+		void wakeOne();
+
+		// The last release queues the continuations. It happens under the counter mutex
+		// so waitForRelease can tell when the counter is no longer touched.
+		void release(Counter* counter) {
+			if (!counter)
+				return;
+
+			std::vector<std::pair<Job, Counter*>> continuations;
+			{
+				std::lock_guard<std::mutex> lock(counter->m_mutex);
+				if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					continuations.swap(counter->m_continuations);
+			}
+			for (auto& [job, jobCounter] : continuations) {
+				push({ std::move(job), jobCounter });
+			}
+		}
+
+		// False when dependency is already done, job is left untouched then
+		bool deferUntilDone(Counter& dependency, Job& job, Counter* counter) {
+			std::lock_guard<std::mutex> lock(dependency.m_mutex);
+			if (dependency.m_value.load(std::memory_order_acquire) == 0)
+				return false;
+			dependency.m_continuations.emplace_back(std::move(job), counter);
+			return true;
+		}
+
+		// Counter may live on the waiter's stack: wait for the last release to leave it
+		void waitForRelease(Counter& counter) {
+			std::lock_guard<std::mutex> lock(counter.m_mutex);
+		}
+
+		void execute(Task& task) {
+			task.job();
+			release(task.counter);
+		}
+
+		void push(Task task) {
+			// No pool to hand it to: run inline
+			if (!running.load() || workerCount == 0) {
+				execute(task);
+				return;
+			}
+
+			Queue& queue = *queues[queueOf(threadIndex)];
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				queue.tasks.push_back(std::move(task));
+			}
+			queued.fetch_add(1);
+			wakeOne();
+		}
+
+		// Own queue newest first, then the oldest task of the others
+		bool tryPop(uint32_t index, Task& out) {
+			size_t count = queues.size();
+			uint32_t own = queueOf(index);
+			{
+				Queue& queue = *queues[own];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.tasks.empty()) {
+					out = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+					queued.fetch_sub(1);
+					return true;
+				}
+			}
+
+			for (size_t i = 1; i < count; i++) {
+				Queue& victim = *queues[(own + i) % count];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (!victim.tasks.empty()) {
+					out = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+					queued.fetch_sub(1);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void wakeOne() {
+			if (sleeping.load() > 0) {
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				wakeCondition.notify_one();
+			}
+		}
+
+		// Oldest first, only below the limit
+		bool tryPopBackground(Task& out) {
+			std::lock_guard<std::mutex> lock(background.mutex);
+			if (background.tasks.empty() || backgroundRunning.load() >= backgroundLimit)
+				return false;
+			out = std::move(background.tasks.front());
+			background.tasks.pop_front();
+			backgroundQueued.fetch_sub(1);
+			backgroundRunning.fetch_add(1);
+			return true;
+		}
+
+		void workerLoop(uint32_t index) {
+			threadIndex = index;
+			while (true) {
+				Task task;
+				if (tryPop(index, task)) {
+					execute(task);
+					continue;
+				}
+				if (tryPopBackground(task)) {
+					execute(task);
+					backgroundRunning.fetch_sub(1);
+					// The next one may start now
+					if (backgroundQueued.load() > 0)
+						wakeOne();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(sleepMutex);
+				sleeping.fetch_add(1);
+				wakeCondition.wait(lock, [] { return queued.load() > 0 || backgroundReady() || !running.load(); });
+				sleeping.fetch_sub(1);
+				// Queued work is drained before leaving
+				if (!running.load() && queued.load() == 0 && backgroundQueued.load() == 0)
+					return;
+			}
+		}
+
+		void splitRange(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& fn, Counter& counter) {
+			// Keep the upper half for thieves, chunk boundaries stay multiples of grainSize
+			while (end - begin > grainSize) {
+				size_t chunks = (end - begin + grainSize - 1) / grainSize;
+				size_t mid = begin + (chunks / 2) * grainSize;
+				run([mid, end, grainSize, &fn, &counter] { splitRange(mid, end, grainSize, fn, counter); }, &counter);
+				end = mid;
+			}
+			fn(begin, end);
+		}
+	}
+
+	void init(uint32_t numThreads) {
+		if (Internal::running)
+			return;
+
+		if (numThreads == 0) {
+			uint32_t hw = std::thread::hardware_concurrency();
+			numThreads = hw > 1 ? hw - 1 : 1;
+		}
+
+		Internal::queues.clear();
+		for (uint32_t i = 0; i <= numThreads; i++) {
+			Internal::queues.push_back(std::make_unique<Internal::Queue>());
+		}
+
+		Internal::workerCount = numThreads;
+		Internal::backgroundLimit = std::max(1u, numThreads - 1);
+		Internal::running = true;
+		Internal::workers.reserve(numThreads);
+		for (uint32_t i = 0; i < numThreads; i++) {
+			Internal::workers.emplace_back(Internal::workerLoop, i);
+		}
+		LOG_OK("JobSystem started with " << numThreads << " workers");
+	}
+
+	void shutdown() {
+		{
+			std::lock_guard<std::mutex> lock(Internal::sleepMutex);
+			Internal::running = false;
+		}
+		Internal::wakeCondition.notify_all();
+		for (auto& worker : Internal::workers) {
+			if (worker.joinable())
+				worker.join();
+		}
+		Internal::workers.clear();
+		Internal::workerCount = 0;
+		Internal::queues.clear();
+		Internal::queued = 0;
+		Internal::background.tasks.clear();
+		Internal::backgroundQueued = 0;
+	}
+
+	uint32_t getThreadCount() {
+		return Internal::workerCount;
+	}
+
+	bool isInitialized() {
+		return Internal::running;
+	}
+
+	uint32_t getThreadIndex() {
+		return Internal::queueOf(Internal::threadIndex);
+	}
+
+	void run(Job job, Counter* counter) {
+		Internal::retain(counter);
+		Internal::push({ std::move(job), counter });
+	}
+
+	void runBackground(Job job) {
+		if (!Internal::running.load() || Internal::workerCount == 0) {
+			job();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(Internal::background.mutex);
+			Internal::background.tasks.push_back({ std::move(job), nullptr });
+		}
+		Internal::backgroundQueued.fetch_add(1);
+		Internal::wakeOne();
+	}
+
+	void runAfter(Counter& dependency, Job job, Counter* counter) {
+		Internal::retain(counter);
+		if (!Internal::deferUntilDone(dependency, job, counter))
+			Internal::push({ std::move(job), counter });
+	}
+
+	void waitFor(Counter& counter) {
+		uint32_t index = Internal::threadIndex;
+		while (!counter.isDone()) {
+			Internal::Task task;
+			if (Internal::running && Internal::tryPop(index, task))
+				Internal::execute(task);
+			else
+				std::this_thread::yield();
+		}
+		Internal::waitForRelease(counter);
+	}
+
+	void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fn) {
+		if (count == 0)
+			return;
+		if (grainSize == 0)
+			grainSize = 1;
+
+		// Not worth waking anyone: run inline
+		if (!Internal::running || Internal::workerCount == 0 || count <= grainSize) {
+			fn(0, count);
+			return;
+		}
+
+		Counter counter;
+		Internal::splitRange(0, count, grainSize, fn, counter);
+		waitFor(counter);
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Shared work-stealing pool, the threading backbone of the engine.
+// Every worker owns a deque: it pushes and pops its own jobs at the back (newest
+// first, still hot in cache) and steals the oldest ones at the front of the others
+// when it runs dry. Threads outside the pool submit to a shared queue.
+namespace JobSystem
+{
+	using Job = std::function<void()>;
+
+	class Counter;
+	namespace Internal
+	{
+		void retain(Counter* counter);
+		void release(Counter* counter);
+		bool deferUntilDone(Counter& dependency, Job& job, Counter* counter);
+		void waitForRelease(Counter& counter);
+	}
+
+	// Jobs in flight attached to it. Continuations registered with runAfter are queued
+	// the moment it drops back to zero. Must outlive the jobs it counts.
+	class Counter {
+	public:
+		Counter() = default;
+		Counter(const Counter&) = delete;
+		Counter& operator=(const Counter&) = delete;
+
+		bool isDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+		uint32_t getValue() const { return m_value.load(std::memory_order_acquire); }
+
+	private:
+		friend void Internal::retain(Counter* counter);
+		friend void Internal::release(Counter* counter);
+		friend bool Internal::deferUntilDone(Counter& dependency, Job& job, Counter* counter);
+		friend void Internal::waitForRelease(Counter& counter);
+
+		std::atomic<uint32_t> m_value{ 0 };
+		std::mutex m_mutex;
+		std::vector<std::pair<Job, Counter*>> m_continuations;
+	};
+
+	// numThreads == 0 uses hardware_concurrency - 1 workers (the caller thread also works)
+	void init(uint32_t numThreads = 0);
+	void shutdown();
+
+	uint32_t getThreadCount();
+	bool isInitialized();
+	// Pool index of the calling thread, getThreadCount() for threads outside the pool
+	uint32_t getThreadIndex();
+
+	// Queues job, counter (may be null) goes up now and back down once job returned.
+	// Without workers the job runs inline.
+	void run(Job job, Counter* counter = nullptr);
+
+	// Long jobs that must not hold up frame work (file reads, image decoding). They wait in
+	// a queue of their own, oldest first: workers only take them when no other job is
+	// queued, at most getThreadCount() - 1 at once (one with a single worker) so a worker
+	// stays free for the physics step, and waitFor / parallelFor never run them on the
+	// waiting thread.
+	// Without workers the job runs inline.
+	void runBackground(Job job);
+
+	// Queues job once dependency reaches zero, right away if it already did
+	void runAfter(Counter& dependency, Job job, Counter* counter = nullptr);
+
+	// Returns once counter reaches zero. The calling thread never blocks while jobs are
+	// queued: it runs them (its own first, then stolen ones) until the counter is done.
+	void waitFor(Counter& counter);
+
+	// Split [0, count) in chunks of grainSize and run fn(begin, end) on the workers.
+	// Ranges are halved recursively so a thief always takes the biggest piece left.
+	// Blocks until every chunk is done, the calling thread helps while waiting.
+	void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fn);
+}
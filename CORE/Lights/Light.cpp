@@ -4,7 +4,8 @@
 
 void Light::update(float dt) {
     if (auto gameObject = this->getGameObject()) {
-        m_position = gameObject->getPosition();
+        // World position, the light may sit on a child object
+        m_position = gameObject->getWorldPosition();
 
     }
 }
\ No newline at end of file
@@ -12,6 +12,9 @@
 enum class LightType { POINT, DIRECTIONAL, SPOT };
 
 class Light : public Component, Transform {
+	COMPONENT_TYPE(Light, Component)
+	// Follows the world position of the owner, clean once the matrices are updated
+	COMPONENT_UPDATE(PRE_RENDER, ComponentAccess::TRANSFORM, ComponentAccess::NONE)
 public:
     Light(LightType type, glm::vec3 position, glm::vec3 direction, glm::vec3 color, float intensity)
         : Transform(position, direction), type(type), color(color), intensity(intensity) {}
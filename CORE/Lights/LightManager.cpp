@@ -1,7 +1,9 @@
 #include "LightManager.hpp"
 #include <iostream>
 #include "../Cameras/Camera.hpp"
+#include "../SpatialIndex.hpp"
 #include <glm/glm.hpp>
+#include <algorithm>
 
 
 namespace LightManager
@@ -15,6 +17,24 @@ namespace LightManager
 	std::vector<std::shared_ptr<Light>> s_lights;
 	std::unordered_map<std::string, std::shared_ptr<Texture>> lights; //TODO: update imple it use this instead of s_lights
 
+	// Point boxes of s_lights, same order
+	std::unique_ptr<SpatialIndex> s_lightIndex;
+	std::vector<SpatialIndex::Id> s_lightIds;
+	std::vector<glm::vec3> s_indexedPositions;
+	// Bumped when a light is added, removed or moved
+	uint32_t s_lightVersion = 0;
+
+	struct RelevantLights {
+		const Camera* camera = nullptr;
+		glm::vec3 position = glm::vec3(0.0f);
+		float distance = -1.0f;
+		int maxLights = 0;
+		uint32_t version = 0;
+		std::vector<std::shared_ptr<Light>> lights;
+	};
+	RelevantLights s_relevant;
+	std::vector<SpatialIndex::Id> s_queryIds;
+
 
 	void init() {
 		//init shadow mapper
@@ -26,7 +46,7 @@ namespace LightManager
 		for (auto& light : s_lights) {
 			light.reset();
 		}
-		s_lights.clear();
+		clearLights();
 		std::cout << "LightManager shutdown complete." << std::endl;
 	}
 
@@ -60,18 +80,47 @@ namespace LightManager
 	}
 
 	std::vector<std::shared_ptr<Light>> getRelevantLights(const std::shared_ptr<Camera> cam, int maxLights) {
+		const glm::vec3 cameraPosition = cam->getPosition();
+		const float maxDistance = cam->getMaxLightDistance();
+		if (s_relevant.camera == cam.get() && s_relevant.position == cameraPosition && s_relevant.distance == maxDistance
+			&& s_relevant.maxLights == maxLights && s_relevant.version == s_lightVersion)
+			return s_relevant.lights;
+
+		s_relevant.camera = cam.get();
+		s_relevant.position = cameraPosition;
+		s_relevant.distance = maxDistance;
+		s_relevant.maxLights = maxLights;
+		s_relevant.version = s_lightVersion;
+		s_relevant.lights.clear();
+		if (!s_lightIndex || maxLights <= 0) return s_relevant.lights;
+
+		s_queryIds.clear();
+		s_lightIndex->querySphere(cameraPosition, maxDistance, s_queryIds);
+		auto distance2 = [&](SpatialIndex::Id id) {
+			glm::vec3 d = s_lightIndex->getBounds(id).min - cameraPosition;
+			return glm::dot(d, d);
+		};
+		// Nearest first when there are more than the shader takes
+		size_t count = std::min(s_queryIds.size(), static_cast<size_t>(maxLights));
+		std::partial_sort(s_queryIds.begin(), s_queryIds.begin() + count, s_queryIds.end(),
+			[&](SpatialIndex::Id a, SpatialIndex::Id b) { return distance2(a) < distance2(b); });
+
+		for (size_t i = 0; i < count; i++) {
+			size_t index = reinterpret_cast<size_t>(s_lightIndex->getUserData(s_queryIds[i]));
+			s_relevant.lights.push_back(s_lights[index]);
+		}
+		return s_relevant.lights;
+	}
 
-		std::vector<std::shared_ptr<Light>> relevantLights;
-		for (const auto& light : s_lights) {
-			// Add logging to verify lights are present
-
-			float distance = glm::distance(light->getPosition(), cam->getPosition());
-			if (distance < cam->getMaxLightDistance()) {
-				relevantLights.push_back(light);
-			}
-			if (relevantLights.size() >= maxLights) break;
+	void updateIndex() {
+		if (!s_lightIndex) return;
+		for (size_t i = 0; i < s_lights.size(); i++) {
+			glm::vec3 position = s_lights[i]->getPosition();
+			if (position == s_indexedPositions[i]) continue;
+			s_indexedPositions[i] = position;
+			s_lightIndex->update(s_lightIds[i], Aabb(position, position));
+			s_lightVersion++;
 		}
-		return relevantLights;
 	}
 
 	void addLight(const std::shared_ptr<Light> light) {
@@ -79,10 +128,48 @@ namespace LightManager
 		std::cout << "Adding light. Current size before: " << s_lights.size() << std::endl;
 		s_lights.push_back(light);
 		std::cout << "Adding light. Current size after: " << s_lights.size() << std::endl;
+
+		if (!s_lightIndex) {
+			SpatialIndex::Settings settings;
+			settings.cellSize = 32.0f;
+			s_lightIndex = SpatialIndex::create(settings);
+		}
+		// The user data is the position in s_lights
+		glm::vec3 position = light->getPosition();
+		s_lightIds.push_back(s_lightIndex->insert(reinterpret_cast<void*>(s_lights.size() - 1), Aabb(position, position)));
+		s_indexedPositions.push_back(position);
+		s_lightVersion++;
+	}
+
+	void removeLight(const Light* light) {
+		auto it = std::find_if(s_lights.begin(), s_lights.end(), [&](const std::shared_ptr<Light>& l) { return l.get() == light; });
+		if (it == s_lights.end()) return;
+
+		// Swap with the last one, whose user data (its position in s_lights) changes
+		size_t index = static_cast<size_t>(it - s_lights.begin());
+		size_t last = s_lights.size() - 1;
+		s_lightIndex->remove(s_lightIds[index]);
+		if (index != last) {
+			s_lightIndex->remove(s_lightIds[last]);
+			s_lights[index] = std::move(s_lights[last]);
+			s_indexedPositions[index] = s_indexedPositions[last];
+			s_lightIds[index] = s_lightIndex->insert(reinterpret_cast<void*>(index),
+				Aabb(s_indexedPositions[index], s_indexedPositions[index]));
+		}
+		s_lights.pop_back();
+		s_lightIds.pop_back();
+		s_indexedPositions.pop_back();
+		s_relevant.lights.clear();
+		s_lightVersion++;
 	}
 
 	void clearLights() {
 		s_lights.clear();
+		if (s_lightIndex) s_lightIndex->clear();
+		s_lightIds.clear();
+		s_indexedPositions.clear();
+		s_relevant.lights.clear();
+		s_lightVersion++;
 	}
 
 	const std::vector<std::shared_ptr<Light>>& getLights() {
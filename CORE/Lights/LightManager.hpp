@@ -126,8 +126,14 @@ namespace LightManager {
 
 
 
+	// Nearest lights within the camera max light distance, from the light index. Computed
+	// once per camera, position and light layout, the draws of a frame share the result.
 	std::vector<std::shared_ptr<Light>> getRelevantLights(const std::shared_ptr<Camera> cam, int maxLights);
+	// Moves the indexed lights to their current positions, once per frame before drawing
+	void updateIndex();
 	void addLight(const std::shared_ptr<Light> light); //TODO: added map and names to light so you can ask lightmanager for the light you want
+	// No-op when the light is not registered (streamed out objects, see WorldStreamer)
+	void removeLight(const Light* light);
 	//std::shared_ptr getLight(const char * name...
 	void clearLights();
 	const std::vector<std::shared_ptr<Light>>& getLights();
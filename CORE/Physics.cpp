@@ -1,4 +1,12 @@
 #include "Physics.hpp"
+#include "PhysicsMeshCache.hpp"
+#include "PhysicsStats.hpp"
+#include "PhysicsActorPool.hpp"
+#include "PhysicsEvents.hpp"
+#include "Jobs/JobSystem.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
 
 
 namespace Physics {
@@ -10,16 +18,67 @@ namespace Physics {
 		PxFoundation* gFoundation = nullptr;
 		PxPhysics* gPhysics = nullptr;
 		PxPvd* gPvd = nullptr;
+		PxPvdTransport* gPvdTransport = nullptr;
+		PxSerializationRegistry* gSerializationRegistry = nullptr;
+		PxMaterial* gDefaultMaterial = nullptr;
+
+		PhysicsConfig gConfig;
+
+		// Hands PhysX tasks to the JobSystem, a task is released once it ran
+		class JobDispatcher : public PxCpuDispatcher {
+		public:
+			void submitTask(PxBaseTask& task) override {
+				JobSystem::run([&task] {
+					task.run();
+					task.release();
+				});
+			}
+
+			uint32_t getWorkerCount() const override { return JobSystem::getThreadCount(); }
+		};
+
+		JobDispatcher gJobDispatcher;
 	}
 
+	PhysicsConfig loadConfig(const std::string& configPath) {
+		PhysicsConfig config;
 
-	void init() {
+		std::ifstream file(configPath);
+		if (!file.is_open()) {
+			std::cout << "No physics config at " << configPath << ", using defaults" << std::endl;
+			return config;
+		}
+
+		try {
+			auto json = nlohmann::json::parse(file, nullptr, true, true);
+			config.enablePvd = json.value("enablePvd", config.enablePvd);
+			config.pvdHost = json.value("pvdHost", config.pvdHost);
+			config.pvdPort = json.value("pvdPort", config.pvdPort);
+			config.enableProfiler = json.value("enableProfiler", config.enableProfiler);
+			config.statsCsvPath = json.value("statsCsvPath", config.statsCsvPath);
+			config.enhancedDeterminism = json.value("enhancedDeterminism", config.enhancedDeterminism);
+		}
+		catch (const nlohmann::json::exception& e) {
+			std::cerr << "Error loading physics config " << configPath << ": " << e.what() << std::endl;
+		}
+		return config;
+	}
+
+	void init(const PhysicsConfig& config) {
+		Internal::gConfig = config;
 
 		Internal::gFoundation = PxCreateFoundation(PX_PHYSICS_VERSION, Internal::gAllocator, Internal::gErrorCallback);
 
-		Internal::gPvd = PxCreatePvd(*Internal::gFoundation);
-		PxPvdTransport* transport = PxDefaultPvdSocketTransportCreate("localhost", 5425, 10);
-		Internal::gPvd->connect(*transport, PxPvdInstrumentationFlag::eALL);
+		// PVD is opt in: the socket costs a connection attempt and streaming overhead every frame
+		if (config.enablePvd) {
+			Internal::gPvd = PxCreatePvd(*Internal::gFoundation);
+			Internal::gPvdTransport = PxDefaultPvdSocketTransportCreate(config.pvdHost.c_str(), config.pvdPort, 10);
+			Internal::gPvd->connect(*Internal::gPvdTransport, PxPvdInstrumentationFlag::eALL);
+		}
+		else if (config.enableProfiler) {
+			// PVD installs its own profiler callback, ours only goes in without it
+			PhysicsProfiler::install();
+		}
 
 		Internal::gPhysics = PxCreatePhysics(PX_PHYSICS_VERSION, *Internal::gFoundation, PxTolerancesScale(), true, Internal::gPvd);
 		if (!Internal::gPhysics)
@@ -37,26 +96,141 @@ namespace Physics {
 
 	void shutdown()
 	{
+		PhysicsActorPool::clear();
+		PhysicsMeshCache::clear();
+		if (Internal::gDefaultMaterial) {
+			Internal::gDefaultMaterial->release();
+			Internal::gDefaultMaterial = nullptr;
+		}
+		if (Internal::gSerializationRegistry) {
+			Internal::gSerializationRegistry->release();
+			Internal::gSerializationRegistry = nullptr;
+		}
 		Internal::gPhysics->release();
-		Internal::gPvd->release();
+		PhysicsProfiler::uninstall();
+		if (Internal::gPvd) {
+			Internal::gPvd->release();
+			Internal::gPvd = nullptr;
+		}
+		if (Internal::gPvdTransport) {
+			Internal::gPvdTransport->release();
+			Internal::gPvdTransport = nullptr;
+		}
 		Internal::gFoundation->release();
 	}
-	PxScene* createScene()
+	const char* toString(BroadPhaseType type) {
+		switch (type) {
+		case BroadPhaseType::SAP: return "SAP";
+		case BroadPhaseType::MBP: return "MBP";
+		case BroadPhaseType::ABP: return "ABP";
+		case BroadPhaseType::PABP: return "PABP";
+		}
+		return "?";
+	}
+
+	const char* toString(SolverType type) {
+		return type == SolverType::TGS ? "TGS" : "PGS";
+	}
+
+	PxScene* createScene(const SceneConfig& config)
 	{
 		PxSceneDesc sceneDesc(Internal::gPhysics->getTolerancesScale());
-		sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
-		sceneDesc.cpuDispatcher = PxDefaultCpuDispatcherCreate(4);
-		sceneDesc.filterShader = PxDefaultSimulationFilterShader;
+		sceneDesc.gravity = PxVec3(config.gravity.x, config.gravity.y, config.gravity.z);
+		if (config.useJobSystem && JobSystem::isInitialized())
+			sceneDesc.cpuDispatcher = &Internal::gJobDispatcher;
+		else
+			sceneDesc.cpuDispatcher = PxDefaultCpuDispatcherCreate(config.dispatcherThreads);
+		sceneDesc.filterShader = eventFilterShader;
+
+		switch (config.broadPhase) {
+		case BroadPhaseType::SAP: sceneDesc.broadPhaseType = PxBroadPhaseType::eSAP; break;
+		case BroadPhaseType::MBP: sceneDesc.broadPhaseType = PxBroadPhaseType::eMBP; break;
+		case BroadPhaseType::ABP: sceneDesc.broadPhaseType = PxBroadPhaseType::eABP; break;
+		case BroadPhaseType::PABP: sceneDesc.broadPhaseType = PxBroadPhaseType::ePABP; break;
+		}
+
+		switch (config.friction) {
+		case FrictionType::PATCH: sceneDesc.frictionType = PxFrictionType::ePATCH; break;
+#if PX_PHYSICS_VERSION_MAJOR == 5 && PX_PHYSICS_VERSION_MINOR >= 4
+		default:
+			std::cerr << "Only patch friction is available in this PhysX version" << std::endl;
+			sceneDesc.frictionType = PxFrictionType::ePATCH;
+			break;
+#else
+		case FrictionType::ONE_DIRECTIONAL: sceneDesc.frictionType = PxFrictionType::eONE_DIRECTIONAL; break;
+		case FrictionType::TWO_DIRECTIONAL: sceneDesc.frictionType = PxFrictionType::eTWO_DIRECTIONAL; break;
+#endif
+		}
+
+		sceneDesc.solverType = config.solver == SolverType::TGS ? PxSolverType::eTGS : PxSolverType::ePGS;
+
+		if (config.enhancedDeterminism || Internal::gConfig.enhancedDeterminism)
+			sceneDesc.flags |= PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+
+		sceneDesc.limits.maxNbActors = config.maxActors;
+		sceneDesc.limits.maxNbBodies = config.maxBodies;
+		sceneDesc.limits.maxNbStaticShapes = config.maxStaticShapes;
+		sceneDesc.limits.maxNbDynamicShapes = config.maxDynamicShapes;
+		sceneDesc.limits.maxNbAggregates = config.maxAggregates;
+		sceneDesc.limits.maxNbConstraints = config.maxConstraints;
+		sceneDesc.limits.maxNbBroadPhaseOverlaps = config.maxBroadPhaseOverlaps;
 
 		PxScene* scene = Internal::gPhysics->createScene(sceneDesc);
+		if (!scene) {
+			std::cerr << "Error creating PhysX scene" << std::endl;
+			return nullptr;
+		}
+
+		// MBP only collides objects inside its regions
+		if (config.broadPhase == BroadPhaseType::MBP) {
+			if (!config.hasWorldBounds)
+				std::cerr << "MBP broadphase without world bounds, using the default extent" << std::endl;
+
+			PxBounds3 worldBounds(
+				PxVec3(config.worldMin.x, config.worldMin.y, config.worldMin.z),
+				PxVec3(config.worldMax.x, config.worldMax.y, config.worldMax.z));
+			PxU32 subdivisions = PxClamp<PxU32>(config.mbpSubdivisions, 1, 16);
+
+			PxBounds3 regionBounds[256];
+			PxU32 nbRegions = PxBroadPhaseExt::createRegionsFromWorldBounds(regionBounds, worldBounds, subdivisions);
+			for (PxU32 i = 0; i < nbRegions; i++) {
+				PxBroadPhaseRegion region;
+				region.mBounds = regionBounds[i];
+				region.mUserData = nullptr;
+				scene->addBroadPhaseRegion(region);
+			}
+		}
 		return scene;
 	}
 
+	PxCpuDispatcher* getJobDispatcher() {
+		return &Internal::gJobDispatcher;
+	}
+
 	PxPhysics* getPhysics()
 	{
 		return Internal::gPhysics;
 	}
 
+	PxMaterial* getDefaultMaterial()
+	{
+		if (!Internal::gDefaultMaterial)
+			Internal::gDefaultMaterial = Internal::gPhysics->createMaterial(0.5f, 0.5f, 0.2f); // Friction & restitution
+		return Internal::gDefaultMaterial;
+	}
+
+	const PhysicsConfig& getConfig()
+	{
+		return Internal::gConfig;
+	}
+
+	PxSerializationRegistry* getSerializationRegistry()
+	{
+		if (!Internal::gSerializationRegistry)
+			Internal::gSerializationRegistry = PxSerialization::createSerializationRegistry(*Internal::gPhysics);
+		return Internal::gSerializationRegistry;
+	}
+
 	bool raycast(PxScene *scene, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, PxRaycastHit& hitInfo) {
 		PxRaycastBuffer hit;
 		PxVec3 pxOrigin(origin.x, origin.y, origin.z);
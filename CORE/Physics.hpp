@@ -2,18 +2,80 @@
 
 #include <PxPhysicsAPI.h>
 #include <glm/glm.hpp>
+#include <string>
 
 using namespace physx;
 
 namespace Physics
 {
-	void init();
+	struct PhysicsConfig {
+		bool enablePvd = false;           // connect to the PhysX Visual Debugger
+		std::string pvdHost = "localhost";
+		int pvdPort = 5425;
+		bool enableProfiler = true;       // broad/narrow phase and solver timings in PhysicsStats
+		std::string statsCsvPath;         // dump every scene step to CSV, empty = off
+		bool enhancedDeterminism = false; // every scene gets PxSceneFlag::eENABLE_ENHANCED_DETERMINISM, needed to record sessions
+	};
+
+	// Missing file or fields keep the defaults
+	PhysicsConfig loadConfig(const std::string& configPath);
+
+	enum class BroadPhaseType { SAP, MBP, ABP, PABP };
+	enum class FrictionType { PATCH, ONE_DIRECTIONAL, TWO_DIRECTIONAL };
+	enum class SolverType { PGS, TGS };
+
+	// Creation settings of a PxScene, defaults match what PhysX picks on its own
+	struct SceneConfig {
+		glm::vec3 gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+		// PhysX tasks go to the JobSystem workers, dispatcherThreads private threads are only
+		// created when it is off or the pool is not running. Turn it off for scenes stepped
+		// from inside jobs (PhysicsWorldStepper): fetchResults blocks its thread without
+		// helping, enough of them would leave no worker to run the tasks they wait on.
+		bool useJobSystem = true;
+		uint32_t dispatcherThreads = 4;
+
+		BroadPhaseType broadPhase = BroadPhaseType::PABP;
+		// World extent, required by MBP which splits it in mbpSubdivisions x mbpSubdivisions regions (max 16)
+		bool hasWorldBounds = false;
+		glm::vec3 worldMin = glm::vec3(-1000.0f);
+		glm::vec3 worldMax = glm::vec3(1000.0f);
+		uint32_t mbpSubdivisions = 4;
+
+		FrictionType friction = FrictionType::PATCH;
+		SolverType solver = SolverType::PGS;
+
+		// Same results whatever the actor insertion history, required by PhysicsRecorder replays
+		bool enhancedDeterminism = false;
+
+		// Contact / trigger / sleep events buffered per step, extra ones are dropped
+		uint32_t maxEventsPerStep = 4096;
+
+		// PxSceneLimits preallocation hints, 0 = no hint
+		uint32_t maxActors = 0;
+		uint32_t maxBodies = 0;
+		uint32_t maxStaticShapes = 0;
+		uint32_t maxDynamicShapes = 0;
+		uint32_t maxAggregates = 0;
+		uint32_t maxConstraints = 0;
+		uint32_t maxBroadPhaseOverlaps = 0;
+	};
+
+	const char* toString(BroadPhaseType type);
+	const char* toString(SolverType type);
+
+	void init(const PhysicsConfig& config = PhysicsConfig{});
 	void update();
 	void shutdown();
 
-	PxScene* createScene();
+	PxScene* createScene(const SceneConfig& config = SceneConfig{});
+	// Dispatcher shared by the scenes running on the JobSystem, never released by them
+	PxCpuDispatcher* getJobDispatcher();
 
 	PxPhysics* getPhysics();
+	// Shared by every component shape, callers acquire their own reference
+	PxMaterial* getDefaultMaterial();
+	const PhysicsConfig& getConfig();
+	PxSerializationRegistry* getSerializationRegistry();
 	bool raycast(PxScene*scene, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, PxRaycastHit& hitInfo);
 }
 
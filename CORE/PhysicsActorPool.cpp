@@ -0,0 +1,166 @@
+#include "PhysicsActorPool.hpp"
+#include <vector>
+#include <iostream>
+
+namespace PhysicsActorPool {
+
+	namespace Internal {
+		// Shape signature of a poolable actor: one primitive shape on a static or dynamic body
+		struct Key {
+			PxGeometryType::Enum type = PxGeometryType::eINVALID;
+			PxVec3 dims = PxVec3(0.0f);
+			bool dynamic = false;
+
+			bool operator==(const Key& other) const {
+				return type == other.type && dynamic == other.dynamic && (dims - other.dims).magnitudeSquared() < 1e-10f;
+			}
+		};
+
+		struct Pool {
+			Key key;
+			uint32_t capacity = 0;
+			std::vector<PxRigidActor*> parked; // reserved to capacity, parking never allocates
+		};
+
+		// Few prefab shapes are pooled, a linear scan beats hashing float keys
+		std::vector<Pool> pools;
+		PoolStats stats;
+
+		bool makeKey(const PxGeometry& geometry, bool dynamic, Key& key) {
+			key.type = geometry.getType();
+			key.dynamic = dynamic;
+			switch (key.type) {
+			case PxGeometryType::eBOX:
+				key.dims = static_cast<const PxBoxGeometry&>(geometry).halfExtents;
+				return true;
+			case PxGeometryType::eSPHERE:
+				key.dims = PxVec3(static_cast<const PxSphereGeometry&>(geometry).radius, 0.0f, 0.0f);
+				return true;
+			case PxGeometryType::eCAPSULE: {
+				const PxCapsuleGeometry& capsule = static_cast<const PxCapsuleGeometry&>(geometry);
+				key.dims = PxVec3(capsule.radius, capsule.halfHeight, 0.0f);
+				return true;
+			}
+			default:
+				return false;
+			}
+		}
+
+		bool makeKey(PxRigidActor* actor, Key& key) {
+			if (!actor || actor->getNbShapes() != 1) return false;
+			PxShape* shape;
+			actor->getShapes(&shape, 1);
+			PxGeometryHolder holder = shape->getGeometry();
+			return makeKey(holder.any(), actor->is<PxRigidDynamic>() != nullptr, key);
+		}
+
+		Pool* findPool(const Key& key) {
+			for (Pool& pool : pools) {
+				if (pool.key == key) return &pool;
+			}
+			return nullptr;
+		}
+	}
+
+	bool prewarm(PxRigidActor* prototype, uint32_t capacity) {
+		Internal::Key key;
+		if (!Internal::makeKey(prototype, key)) {
+			std::cerr << "PhysicsActorPool: only single primitive shape actors can be pooled" << std::endl;
+			return false;
+		}
+
+		Internal::Pool* pool = Internal::findPool(key);
+		if (!pool) {
+			Internal::pools.emplace_back();
+			pool = &Internal::pools.back();
+			pool->key = key;
+			Internal::stats.pools++;
+		}
+		if (capacity > pool->capacity) {
+			pool->capacity = capacity;
+			pool->parked.reserve(capacity);
+		}
+
+		PxPhysics& physics = *Physics::getPhysics();
+		PxTransform pose(PxIdentity);
+		while (pool->parked.size() < pool->capacity) {
+			PxRigidActor* clone = nullptr;
+			if (PxRigidDynamic* dynamic = prototype->is<PxRigidDynamic>())
+				clone = PxCloneDynamic(physics, pose, *dynamic);
+			else
+				clone = PxCloneStatic(physics, pose, *prototype);
+			if (!clone) break;
+
+			// Components keep their own reference on the shapes they attach (see releaseAllShapes)
+			PxShape* shape;
+			clone->getShapes(&shape, 1);
+			shape->acquireReference();
+
+			pool->parked.push_back(clone);
+			Internal::stats.parked++;
+		}
+		return true;
+	}
+
+	PxRigidActor* acquire(const PxGeometry& geometry, bool dynamic) {
+		Internal::Key key;
+		Internal::Pool* pool = Internal::makeKey(geometry, dynamic, key) ? Internal::findPool(key) : nullptr;
+		if (!pool || pool->parked.empty()) {
+			Internal::stats.created++;
+			return nullptr;
+		}
+
+		PxRigidActor* actor = pool->parked.back();
+		pool->parked.pop_back();
+		Internal::stats.parked--;
+		Internal::stats.reused++;
+
+		// Back to the state of a freshly created actor, the caller sets pose and mass
+		actor->setActorFlag(PxActorFlag::eDISABLE_SIMULATION, false);
+		actor->setGlobalPose(PxTransform(PxIdentity));
+		if (PxRigidDynamic* body = actor->is<PxRigidDynamic>()) {
+			body->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, false);
+			body->setLinearVelocity(PxVec3(0.0f));
+			body->setAngularVelocity(PxVec3(0.0f));
+			body->setWakeCounter(0.4f);
+		}
+		return actor;
+	}
+
+	bool release(PxRigidActor* actor) {
+		Internal::Key key;
+		if (!Internal::makeKey(actor, key)) return false;
+
+		Internal::Pool* pool = Internal::findPool(key);
+		if (!pool || pool->parked.size() >= pool->capacity) return false;
+
+		// Leaving an aggregate puts the actor back in the scene on its own, remove it after
+		if (PxAggregate* aggregate = actor->getAggregate())
+			aggregate->removeActor(*actor);
+		if (PxScene* scene = actor->getScene())
+			scene->removeActor(*actor);
+		actor->userData = nullptr;
+		// The event listener of the previous owner must not leak to the next one
+		PxShape* shape;
+		actor->getShapes(&shape, 1);
+		shape->userData = nullptr;
+
+		pool->parked.push_back(actor);
+		Internal::stats.parked++;
+		return true;
+	}
+
+	const PoolStats& getStats() {
+		return Internal::stats;
+	}
+
+	void clear() {
+		for (Internal::Pool& pool : Internal::pools) {
+			for (PxRigidActor* actor : pool.parked) {
+				actor->release();
+			}
+		}
+		Internal::pools.clear();
+		Internal::stats = PoolStats();
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include "Physics.hpp"
+
+// Parks released single shape actors (removed from their scene, shape still attached)
+// so the next spawn of the same shape reuses them instead of creating a new actor.
+// Pools are opt in: only shapes registered through prewarm are kept.
+namespace PhysicsActorPool
+{
+	struct PoolStats {
+		uint32_t pools = 0;
+		uint32_t parked = 0;   // actors waiting in the pools
+		uint64_t reused = 0;   // acquire() served from a pool
+		uint64_t created = 0;  // acquire() misses
+	};
+
+	// Keeps up to `capacity` parked actors shaped like `prototype` (box, sphere or capsule)
+	// and fills the pool with clones of it. Returns false for actors that cannot be pooled
+	// (several shapes, meshes).
+	bool prewarm(PxRigidActor* prototype, uint32_t capacity);
+
+	// A parked actor with this geometry and type, reset to rest at the origin, or nullptr
+	PxRigidActor* acquire(const PxGeometry& geometry, bool dynamic);
+
+	// Removes the actor from its scene and parks it. Returns false when no pool
+	// takes it, the caller then releases the actor itself.
+	bool release(PxRigidActor* actor);
+
+	const PoolStats& getStats();
+
+	// Releases every parked actor, must run before Physics::shutdown
+	void clear();
+}
@@ -5,6 +5,7 @@
 
 
 class CubePhysics : public PhysicsComponent {
+	COMPONENT_TYPE(CubePhysics, PhysicsComponent)
 public:
 	CubePhysics(Type t = Type::STATIC) : PhysicsComponent(t) {	}
 
@@ -0,0 +1,85 @@
+#include "MeshPhysics.hpp"
+#include "../RenderComponents/ModelRenderer.hpp"
+#include "../PhysicsMeshCache.hpp"
+
+MeshPhysics::MeshPhysics(Type t, Shape shape) : PhysicsComponent(t), m_shape(shape) {
+	createBody();
+
+	if (m_shape == Shape::AUTO)
+		m_shape = isDynamic ? Shape::CONVEX : Shape::TRIANGLE_MESH;
+
+	if (m_shape == Shape::TRIANGLE_MESH && isDynamic) {
+		std::cerr << "MeshPhysics: triangle meshes cannot be dynamic, using convex hulls" << std::endl;
+		m_shape = Shape::CONVEX;
+	}
+}
+
+void MeshPhysics::init() {
+	if (!material) {
+		std::cerr << "Material creation failed!" << std::endl;
+		return;
+	}
+	if (!body) {
+		std::cerr << "Failed to create rigid body!" << std::endl;
+		return;
+	}
+
+	GameObject* gm = getGameObject();
+
+	PxVec3 position(gm->getPosition().x, gm->getPosition().y, gm->getPosition().z);
+	glm::quat rotation = gm->getRotationQuaternion();
+	PxTransform transform(position, PxQuat(rotation.x, rotation.y, rotation.z, rotation.w));
+
+	createShapes(gm->getScale());
+	body->setGlobalPose(transform);
+	applyEventFilter();
+}
+
+void MeshPhysics::applyScale(const glm::vec3& scale) {
+	if (!body) return;
+
+	createShapes(scale);
+
+	if (isDynamic) {
+		body->is<PxRigidDynamic>()->wakeUp();
+	}
+}
+
+void MeshPhysics::createShapes(const glm::vec3& scale) {
+	auto model = getGameObject()->getComponent<ModelRenderer>();
+	if (!model) {
+		std::cerr << "MeshPhysics on '" << getGameObject()->getName() << "' needs a ModelRenderer" << std::endl;
+		return;
+	}
+
+	releaseAllShapes();
+
+	// Cooked meshes are unscaled, the object scale goes in the geometry
+	PxMeshScale meshScale(PxVec3(scale.x, scale.y, scale.z));
+
+	for (const Mesh& mesh : model->getMeshes()) {
+		PxShape* shape = nullptr;
+
+		if (m_shape == Shape::TRIANGLE_MESH) {
+			PxTriangleMesh* triangleMesh = PhysicsMeshCache::getTriangleMesh(mesh);
+			if (!triangleMesh) continue;
+			shape = Physics::getPhysics()->createShape(PxTriangleMeshGeometry(triangleMesh, meshScale), *material, true);
+			triangleMesh->release(); // the shape holds its own reference
+		}
+		else {
+			PxConvexMesh* convexMesh = PhysicsMeshCache::getConvexMesh(mesh);
+			if (!convexMesh) continue;
+			shape = Physics::getPhysics()->createShape(PxConvexMeshGeometry(convexMesh, meshScale), *material, true);
+			convexMesh->release();
+		}
+
+		if (!shape) continue;
+		body->attachShape(*shape);
+		shapes.push_back(shape);
+	}
+
+	if (isDynamic && !shapes.empty()) {
+		PxRigidDynamic* dynamic = body->is<PxRigidDynamic>();
+		PxRigidBodyExt::updateMassAndInertia(*dynamic, mass);
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "PhysicsComponent.hpp"
+
+// Collider built from the meshes of the ModelRenderer on the same GameObject
+// (add the ModelRenderer first). Cooked data comes from PhysicsMeshCache.
+class MeshPhysics : public PhysicsComponent {
+	COMPONENT_TYPE(MeshPhysics, PhysicsComponent)
+public:
+	enum class Shape {
+		AUTO,          // TRIANGLE_MESH if static, CONVEX if dynamic
+		TRIANGLE_MESH, // exact, static only: PhysX cannot simulate dynamic triangle meshes
+		CONVEX         // one convex hull per sub mesh, a cheap convex decomposition
+	};
+
+	MeshPhysics(Type t = Type::STATIC, Shape shape = Shape::AUTO);
+
+	void init() override;
+	void applyScale(const glm::vec3& scale) override;
+
+	Shape getShape() const { return m_shape; }
+
+private:
+	void createShapes(const glm::vec3& scale);
+
+	Shape m_shape;
+};
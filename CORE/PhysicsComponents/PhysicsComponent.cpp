@@ -1,41 +1,91 @@
 #include "PhysicsComponent.hpp"
 #include "SpherePhysics.hpp"
+#include "../PhysicsActorPool.hpp"
+#include "../PhysicsRecorder.hpp"
+#include "../PhysicsEvents.hpp"
+#include "../PhysicsScene.hpp"
 
 PhysicsComponent::PhysicsComponent(Type t) {
-	material = Physics::getPhysics()->createMaterial(0.5f, 0.5f, 0.2f); // Friction & restitution
+	material = Physics::getDefaultMaterial();
+	material->acquireReference();
+	isDynamic = (t == Type::DYNAMIC);
+}
 
-	if (body)
-		body->release();
-	if (t == Type::DYNAMIC) {
+void PhysicsComponent::createBody() {
+	if (body) return;
+	if (isDynamic) {
 		body = Physics::getPhysics()->createRigidDynamic(PxTransform(PxIdentity));
 	}
 	else {
 		body = Physics::getPhysics()->createRigidStatic(PxTransform(PxIdentity));
 	}
-	isDynamic = (t == Type::DYNAMIC);
+}
+
+bool PhysicsComponent::createBody(const PxGeometry& geometry) {
+	releaseBody();
+	shapes.clear();
+
+	body = PhysicsActorPool::acquire(geometry, isDynamic);
+	if (body) {
+		// Parked actors keep their shape
+		shapes.resize(1);
+		body->getShapes(shapes.data(), 1);
+	}
+	else {
+		createBody();
+		if (!body) return false;
+
+		PxShape* shape = Physics::getPhysics()->createShape(geometry, *material, true);
+		if (!shape) return false;
+		body->attachShape(*shape);
+		shapes.push_back(shape);
+	}
+	poolable = true;
+	applyEventFilter();
+
+	GameObject* gm = getGameObject();
+	glm::vec3 position = gm->getPosition();
+	glm::quat rotation = gm->getRotationQuaternion();
+	body->setGlobalPose(PxTransform(PxVec3(position.x, position.y, position.z), PxQuat(rotation.x, rotation.y, rotation.z, rotation.w)));
+
+	if (isDynamic) {
+		PxRigidBodyExt::updateMassAndInertia(*body->is<PxRigidDynamic>(), mass);
+	}
+	return true;
+}
+
+void PhysicsComponent::releaseBody() {
+	if (!body) return;
+	if (!poolable || !PhysicsActorPool::release(body))
+		body->release();
+	body = nullptr;
+	poolable = false;
 }
 
 void PhysicsComponent::applyForce(const glm::vec3& force) {
 
-	if (isDynamic && body) {
+	if (isDynamic && body && simulationEnabled) {
 		body->is<PxRigidDynamic>()->addForce(PxVec3(force.x, force.y, force.z));
+		PhysicsRecorder::recordForce(getGameObject(), force);
 	}
 }
 
 void PhysicsComponent::applyTorque(const glm::vec3& torque) {
-	if (isDynamic && body) {
+	if (isDynamic && body && simulationEnabled) {
 		body->is<PxRigidDynamic>()->addTorque(PxVec3(torque.x, torque.y, torque.z));
+		PhysicsRecorder::recordTorque(getGameObject(), torque);
 	}
 }
 
 void PhysicsComponent::setMass(float m) {
 	mass = m;
-	if (isDynamic) {
+	if (isDynamic && body) {
 		PxRigidDynamic* dynamic = body->is<PxRigidDynamic>();
 		if (dynamic) {
 			PxRigidBodyExt::updateMassAndInertia(*dynamic, m);
 		}
 	}
+	PhysicsRecorder::recordMass(getGameObject(), m);
 }
 
 float PhysicsComponent::getMass() {
@@ -45,21 +95,30 @@ float PhysicsComponent::getMass() {
 //angular velocity
 void PhysicsComponent::setAngularVelocity(const glm::vec3& velocity) {
 	PxRigidDynamic* dynamic = body->is<PxRigidDynamic>();
-	if (dynamic) {
+	if (dynamic && !simulationEnabled) {
+		// Applied when the body simulates again
+		savedAngularVelocity = PxVec3(velocity.x, velocity.y, velocity.z);
+	}
+	else if (dynamic) {
 		dynamic->setAngularVelocity(PxVec3(velocity.x, velocity.y, velocity.z));
+		PhysicsRecorder::recordAngularVelocity(getGameObject(), velocity);
 	}
 }
 
 //linear velocity
 void PhysicsComponent::setLinearVelocity(const glm::vec3& velocity) {
 	PxRigidDynamic* dynamic = body->is<PxRigidDynamic>();
-	if (dynamic) {
+	if (dynamic && !simulationEnabled) {
+		savedLinearVelocity = PxVec3(velocity.x, velocity.y, velocity.z);
+	}
+	else if (dynamic) {
 		dynamic->setLinearVelocity(PxVec3(velocity.x, velocity.y, velocity.z));
+		PhysicsRecorder::recordLinearVelocity(getGameObject(), velocity);
 	}
 }
 
 void PhysicsComponent::updatePhysX() {
-	if (body) {
+	if (body || mergedActor) {
 		// Get the current transform from the game object
 		glm::vec3 position = getGameObject()->getPosition();
 		glm::quat rotation = getGameObject()->getRotationQuaternion();
@@ -70,13 +129,62 @@ void PhysicsComponent::updatePhysX() {
 			PxQuat(rotation.x, rotation.y, rotation.z, rotation.w)
 		);
 
-		// Update PhysX body
-		body->setGlobalPose(transform);
+		// Merged colliders move their shapes inside the region actor
+		if (mergedActor) {
+			updateMergedPose(transform);
+			return;
+		}
+
+		// Kinematic bodies are moved by the solver so contacts see their velocity,
+		// a teleport would push what they touch without it
+		PxRigidDynamic* dynamic = body->is<PxRigidDynamic>();
+		if (dynamic && dynamic->getScene()
+			&& dynamic->getRigidBodyFlags().isSet(PxRigidBodyFlag::eKINEMATIC)
+			&& !dynamic->getActorFlags().isSet(PxActorFlag::eDISABLE_SIMULATION)) {
+			dynamic->setKinematicTarget(transform);
+			PhysicsRecorder::recordKinematicTarget(getGameObject(), transform);
+		}
+		else {
+			body->setGlobalPose(transform);
+			PhysicsRecorder::recordPose(getGameObject(), transform);
+		}
 	}
 }
 
+void PhysicsComponent::queuePoseWrite() {
+	PxRigidActor* actor = mergedActor ? static_cast<PxRigidActor*>(mergedActor) : body;
+	if (!actor) return;
+	PxScene* scene = actor->getScene();
+	PhysicsScene* physicsScene = scene ? static_cast<PhysicsScene*>(scene->userData) : nullptr;
+	if (physicsScene)
+		physicsScene->queuePose(this);
+	else
+		updatePhysX();
+}
+
+void PhysicsComponent::cancelPoseWrite() {
+	// Only a move of our object queues us and none happens while it is destroyed,
+	// cancelPose checks the queue again under its lock
+	if (PhysicsScene* queue = poseQueue.load(std::memory_order_acquire))
+		queue->cancelPose(this);
+}
+
+
+void PhysicsComponent::update(float dt) {
+	// Culled bodies and bodies outside a scene do not move, isSleeping is invalid on them
+	PxRigidDynamic* dynamic = body ? body->is<PxRigidDynamic>() : nullptr;
+	if (!dynamic || !simulationEnabled || !dynamic->getScene()) return;
+
+	// The step a body falls asleep in may still have moved it, it is copied once more
+	bool sleeping = dynamic->isSleeping();
+	if (sleeping && !awakeLastUpdate) return;
+	awakeLastUpdate = !sleeping;
+	updateTransform();
+}
 
 void PhysicsComponent::updateTransform() {
+	// Moved by gameplay after the step, the body has not seen it yet
+	if (poseQueue.load(std::memory_order_acquire)) return;
 	if (body) {
 		PxTransform pxTransform = body->getGlobalPose();
 
@@ -88,9 +196,12 @@ void PhysicsComponent::updateTransform() {
 		pxQuat.normalize();
 		glm::quat rotation(pxQuat.w, pxQuat.x, pxQuat.y, pxQuat.z);
 
-		// Update GameObject with quaternion directly
-		getGameObject()->setPosition(position, false);
-		getGameObject()->setRotationQuaternion(rotation, false);
+		// Setters mark the object dirty, an unchanged pose leaves it alone
+		GameObject* gameObject = getGameObject();
+		if (gameObject->getPosition() != position)
+			gameObject->setPosition(position, false);
+		if (gameObject->getRotationQuaternion() != rotation)
+			gameObject->setRotationQuaternion(rotation, false);
 	}
 }
 
@@ -115,10 +226,13 @@ void PhysicsComponent::releaseAllShapes() {
 }
 
 
-void PhysicsComponent::setPosition(const glm::vec3& position) {
-	if (body) {
-		body->setGlobalPose(PxTransform(position.x, position.y, position.z));
-	}
+void PhysicsComponent::setScale(const glm::vec3& scale) {
+	// The region actor's shapes are shared geometry copies, merged colliders keep their size
+	if (mergedActor) return;
+	applyScale(scale);
+	// New shapes come without our filter data
+	applyEventFilter();
+	PhysicsRecorder::recordScale(getGameObject(), scale);
 }
 
 glm::vec3 PhysicsComponent::getScale() {
@@ -139,32 +253,167 @@ glm::vec3 PhysicsComponent::getScale() {
 	}
 }
 
-void PhysicsComponent::setRotation(const glm::vec3& eulerDegrees) {
+void PhysicsComponent::rebindActor(PxRigidActor* actor, std::shared_ptr<void> memory) {
+	if (!actor || actor == body) return;
+
+	// Deserialized actors live in the snapshot memory block, they never go to the pool
+	if (body)
+		body->release();
+	poolable = false;
+	if (material)
+		material->release();
+
+	// The previous block may go once its actor and material are released
+	serializedMemory = std::move(memory);
+	body = actor;
+	isDynamic = body->is<PxRigidDynamic>() != nullptr;
+	material = nullptr;
+
+	// A culled body may have been captured, it comes back simulating
+	body->setActorFlag(PxActorFlag::eDISABLE_SIMULATION, false);
+	simulationEnabled = true;
+
+	// Track the shapes and material the actor came with
+	shapes.resize(body->getNbShapes());
+	body->getShapes(shapes.data(), static_cast<PxU32>(shapes.size()));
+	if (!shapes.empty() && shapes[0]->getNbMaterials() > 0) {
+		shapes[0]->getMaterials(&material, 1);
+		material->acquireReference();
+	}
+
+	body->userData = getGameObject();
+	applyEventFilter();
+}
+
+bool PhysicsComponent::setSimulationEnabled(bool enabled) {
+	if (enabled == simulationEnabled) return false;
+	PxRigidDynamic* dynamic = body ? body->is<PxRigidDynamic>() : nullptr;
+	if (!dynamic || dynamic->getRigidBodyFlags().isSet(PxRigidBodyFlag::eKINEMATIC)) return false;
+
+	if (!enabled) {
+		// PhysX does not allow velocity calls on disabled bodies, keep them on our side
+		savedLinearVelocity = dynamic->getLinearVelocity();
+		savedAngularVelocity = dynamic->getAngularVelocity();
+		savedAwake = !dynamic->isSleeping();
+		dynamic->setActorFlag(PxActorFlag::eDISABLE_SIMULATION, true);
+	}
+	else {
+		dynamic->setActorFlag(PxActorFlag::eDISABLE_SIMULATION, false);
+		dynamic->setLinearVelocity(savedLinearVelocity, false);
+		dynamic->setAngularVelocity(savedAngularVelocity, false);
+		if (savedAwake)
+			dynamic->wakeUp();
+		else
+			dynamic->putToSleep();
+	}
+	simulationEnabled = enabled;
+	return true;
+}
+
+void PhysicsComponent::subscribe(Component* listener, uint32_t flags) {
+	eventListener = listener;
+	eventFlags = listener ? flags : 0;
+	applyEventFilter();
+}
+
+void PhysicsComponent::setTrigger(bool isTrigger) {
+	trigger = isTrigger;
+	applyEventFilter();
+}
+
+void PhysicsComponent::applyEventFilter() {
+	PxRigidActor* actor = body ? body : mergedActor;
+	if (!actor) return;
+
+	std::vector<PxShape*> current = mergedShapes;
 	if (body) {
-		// Convert to quaternion (world-space)
-		glm::quat worldRot = glm::quat(glm::radians(eulerDegrees));
+		current.resize(body->getNbShapes());
+		body->getShapes(current.data(), static_cast<PxU32>(current.size()));
+	}
+
+	for (PxShape* shape : current) {
+		PxFilterData filterData = shape->getSimulationFilterData();
+		filterData.word2 = eventFlags;
+		shape->setSimulationFilterData(filterData);
+		// Lets event delivery and raycast selection find us from a shape, even on merged actors
+		shape->userData = this;
+
+		if (trigger != shape->getFlags().isSet(PxShapeFlag::eTRIGGER_SHAPE)) {
+			// A shape cannot be both, the simulation flag has to go first
+			if (trigger) {
+				shape->setFlag(PxShapeFlag::eSIMULATION_SHAPE, false);
+				shape->setFlag(PxShapeFlag::eTRIGGER_SHAPE, true);
+			}
+			else {
+				shape->setFlag(PxShapeFlag::eTRIGGER_SHAPE, false);
+				shape->setFlag(PxShapeFlag::eSIMULATION_SHAPE, true);
+			}
+		}
+	}
+
+	if (body)
+		body->setActorFlag(PxActorFlag::eSEND_SLEEP_NOTIFIES, (eventFlags & PhysicsEventFlag::SLEEP_WAKE) != 0);
+
+	// Pairs PhysX already tracks keep their old report flags otherwise
+	if (PxScene* scene = actor->getScene())
+		scene->resetFiltering(*actor);
+}
+
+bool PhysicsComponent::mergeInto(PxRigidStatic* target) {
+	if (!body || isDynamic || mergedActor || !target) return false;
 
-		// Get current PhysX rotation
-		PxQuat currentPxRot = body->getGlobalPose().q;
-		glm::quat currentRot(currentPxRot.w, currentPxRot.x, currentPxRot.y, currentPxRot.z);
+	PxTransform actorPose = body->getGlobalPose();
+	PxTransform toTarget = target->getGlobalPose().getInverse() * actorPose;
 
-		// Convert to local-space rotation
-		glm::quat localRot = glm::inverse(currentRot) * worldRot;
+	std::vector<PxShape*> current(body->getNbShapes());
+	body->getShapes(current.data(), static_cast<PxU32>(current.size()));
 
-		// Apply to PhysX (as delta rotation)
-		PxQuat pxLocalRot(localRot.x, localRot.y, localRot.z, localRot.w);
-		pxLocalRot.normalize();
+	for (PxShape* shape : current) {
+		PxMaterial* materials[16];
+		PxU16 nbMaterials = static_cast<PxU16>(shape->getMaterials(materials, 16));
+		PxShape* copy = Physics::getPhysics()->createShape(shape->getGeometry(), materials, nbMaterials, true, shape->getFlags());
+		if (!copy) continue;
 
-		body->setGlobalPose(PxTransform(
-			body->getGlobalPose().p,
-			pxLocalRot * body->getGlobalPose().q
-		));
+		copy->setSimulationFilterData(shape->getSimulationFilterData());
+		copy->setQueryFilterData(shape->getQueryFilterData());
+		copy->setLocalPose(toTarget * shape->getLocalPose());
+		copy->userData = this;
+
+		target->attachShape(*copy);
+		copy->release(); // the merged actor owns it, we detach it when destroyed
+		mergedShapes.push_back(copy);
+		mergedLocalPoses.push_back(shape->getLocalPose());
+	}
+
+	releaseBody();
+	shapes.clear();
+	mergedActor = target;
+	return true;
+}
+
+void PhysicsComponent::updateMergedPose(const PxTransform& pose) {
+	PxTransform toTarget = mergedActor->getGlobalPose().getInverse() * pose;
+	for (size_t i = 0; i < mergedShapes.size(); i++) {
+		mergedShapes[i]->setLocalPose(toTarget * mergedLocalPoses[i]);
 	}
 }
 
+GameObject* PhysicsComponent::getHitObject(const PxRigidActor* actor, const PxShape* shape) {
+	if (shape && shape->userData)
+		return static_cast<PhysicsComponent*>(shape->userData)->getGameObject();
+	return actor ? static_cast<GameObject*>(actor->userData) : nullptr;
+}
+
 PhysicsComponent::~PhysicsComponent() {
-	if (body) {
-		body->release();
+	cancelPoseWrite();
+	releaseBody();
+	if (mergedActor) {
+		for (PxShape* shape : mergedShapes) {
+			mergedActor->detachShape(*shape);
+		}
+		// Last object of its region gone
+		if (mergedActor->getNbShapes() == 0)
+			mergedActor->release();
 	}
 	if (material) {
 		material->release();
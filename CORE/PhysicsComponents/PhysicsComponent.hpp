@@ -2,6 +2,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <atomic>
 #include <PxPhysicsAPI.h>
 #include <iostream>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -22,7 +23,12 @@
 
 using namespace physx;
 
+class PhysicsScene;
+
 class PhysicsComponent : public Component {
+	COMPONENT_TYPE(PhysicsComponent, Component)
+	// Copies the simulated pose to the owner, PhysX is only read
+	COMPONENT_UPDATE(POST_PHYSICS, ComponentAccess::PHYSICS, ComponentAccess::TRANSFORM)
 protected:
 
 	PxRigidActor* body = nullptr;
@@ -33,6 +39,45 @@ protected:
 
     std::vector<PxShape*> shapes;
 
+	// Created by createBody(geometry), may be parked in PhysicsActorPool on destruction
+	bool poolable = false;
+	// Snapshot block the actor and material live in, see rebindActor
+	std::shared_ptr<void> serializedMemory;
+
+	Component* eventListener = nullptr;
+	uint32_t eventFlags = 0;
+	bool trigger = false;
+
+	// Simulation LOD state, see setSimulationEnabled
+	bool simulationEnabled = true;
+	bool savedAwake = true;
+	PxVec3 savedLinearVelocity = PxVec3(0.0f);
+	PxVec3 savedAngularVelocity = PxVec3(0.0f);
+	// Awake at the previous update, see update
+	bool awakeLastUpdate = true;
+
+	// Set once the collider was moved into a region actor by mergeInto, body is null then
+	PxRigidStatic* mergedActor = nullptr;
+	std::vector<PxShape*> mergedShapes;
+	std::vector<PxTransform> mergedLocalPoses; // shape poses relative to our GameObject
+	void updateMergedPose(const PxTransform& pose);
+
+	// Scene holding our queued pose write. Written under its mutex (see PhysicsScene::queuePose),
+	// atomic since updateTransform reads it while parallel updates may queue other moves.
+	friend class PhysicsScene;
+	std::atomic<PhysicsScene*> poseQueue{ nullptr };
+	// Drops a queued write before the actor goes away
+	void cancelPoseWrite();
+
+	// Writes the event flags and trigger state on the current shapes, after any shape change
+	void applyEventFilter();
+
+	// Empty actor of the component type, shapes are attached by the caller
+	void createBody();
+	// Actor with a single exclusive shape, taken from PhysicsActorPool when one is parked
+	bool createBody(const PxGeometry& geometry);
+	void releaseBody();
+
 public:
 	enum class UpdateMode {
 		PHYSICS,    // Let physics control the body
@@ -50,29 +95,58 @@ public:
 	float getMass();
 	void setAngularVelocity(const glm::vec3& velocity);
 	void setLinearVelocity(const glm::vec3& velocity);
+	// Copies the body pose to the GameObject, skipped while a gameplay move is queued
 	void updateTransform();
 
+	// Writes the GameObject pose to the actor now: a kinematic body in a scene gets it as
+	// its kinematic target, other bodies are teleported, merged colliders move their shapes
 	void updatePhysX();
+	// Same write, deferred to the PhysicsScene flush before the next step. Several moves in
+	// a frame cost one write. Actors outside a scene are written right away.
+	void queuePoseWrite();
 
     // Apply a scale to the physics body
     virtual void applyScale(const glm::vec3& scale) {}
     // Release all shapes and recreate them with the new scale
     void releaseAllShapes();
 
-	// Override update to call updateTransform
-	void update(float dt) override {
-		updateTransform();
-	}
-	// Set the position and rotation of the physics body from the GameObject
-
-	void setRotation(const glm::vec3& rotation);
-	void setPosition(const glm::vec3& position);
-	inline	void setScale(const glm::vec3& scale) {	applyScale(scale); }
+	// Copies the simulated pose of moving bodies, static and sleeping ones keep theirs
+	// so their owners stay clean for the matrix batch and the spatial index
+	void update(float dt) override;
+	void setScale(const glm::vec3& scale);
 	
 	glm::vec3 getScale();
 
+	// Takes ownership of an actor created elsewhere (e.g. deserialized) and releases the current one.
+	// `memory` is the block the actor was deserialized in, kept alive as long as we use the actor.
+	void rebindActor(PxRigidActor* actor, std::shared_ptr<void> memory = nullptr);
+
+	// Simulation LOD: a disabled dynamic body leaves the broadphase and the solver and keeps
+	// its pose, velocities and sleep state until it is enabled again. Forces applied meanwhile
+	// are dropped. Kinematic and static bodies are left alone. Returns true when the state changed.
+	bool setSimulationEnabled(bool enabled);
+	inline bool isSimulationEnabled() const { return simulationEnabled; }
+
+	// Sends the events selected by `flags` (PhysicsEventFlag) to listener->onPhysicsEvents
+	// after each step. Only flagged pairs are reported by PhysX, nullptr unsubscribes.
+	void subscribe(Component* listener, uint32_t flags);
+	// Trigger shapes do not collide, they report overlaps with PhysicsEventFlag::TRIGGER
+	void setTrigger(bool isTrigger);
+	inline Component* getEventListener() const { return eventListener; }
+	inline bool isTrigger() const { return trigger; }
+	inline Type getType() const { return isDynamic ? Type::DYNAMIC : Type::STATIC; }
+	inline uint32_t getEventFlags() const { return eventFlags; }
+
+	// Moves the shapes of a static collider into `target` (one actor per level region)
+	// and releases our own actor. Raycasts and events keep finding us through shape->userData.
+	bool mergeInto(PxRigidStatic* target);
+	inline bool isMerged() const { return mergedActor != nullptr; }
+	inline PxRigidStatic* getMergedActor() const { return mergedActor; }
+	// Object behind a hit shape, merged actors have no single owner in their userData
+	static GameObject* getHitObject(const PxRigidActor* actor, const PxShape* shape);
+
 	inline PxRigidActor* getActor() { return body; }
-	inline void setUserData(void* data) { body->userData = data; }
+	inline void setUserData(void* data) { if (body) body->userData = data; }
 
 	~PhysicsComponent();
 };
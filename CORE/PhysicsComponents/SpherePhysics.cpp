@@ -5,6 +5,7 @@
 SpherePhysics::SpherePhysics(Type t) : PhysicsComponent(t) {}
 
 void SpherePhysics::createDynamic(const PxTransform& transform, const PxSphereGeometry& geometry, PxMaterial* material, float mass) {
+	releaseBody();
 	body = PxCreateDynamic(*Physics::getPhysics(), transform, geometry, *material, mass);
 	isDynamic = true;
 }
@@ -15,44 +16,10 @@ void SpherePhysics::init() {
 		return;
 	}
 
-	GameObject* gm = getGameObject();
-
-	glm::vec3 scale = gm->getScale();
-
-
-	// Position and rotation
-	PxVec3 position(gm->getPosition().x, gm->getPosition().y, gm->getPosition().z);
-
-	// Convert glm::vec3 rotation (Euler angles) to PxQuat
-	PxQuat quat = PxQuat(glm::radians(gm->getRotation().x), PxVec3(1, 0, 0)) *
-		PxQuat(glm::radians(gm->getRotation().y), PxVec3(0, 1, 0)) *
-		PxQuat(glm::radians(gm->getRotation().z), PxVec3(0, 0, 1));
-
-	PxTransform transform(position, quat);
-
+	glm::vec3 scale = getGameObject()->getScale();
 	float radius = 1.0f * glm::max(glm::max(scale.x, scale.y), scale.z);
 
-	if (body) {
-		releaseAllShapes();
-
-		// Create a new shape
-		PxShape* shape = Physics::getPhysics()->createShape(
-			PxSphereGeometry(radius),
-			*material,
-			true // Exclusive - allows modification later
-		);
-
-		body->attachShape(*shape);
-		shapes.push_back(shape); // Track for cleanup
-
-		body->setGlobalPose(transform);
-
-		if (isDynamic) {
-			PxRigidDynamic* dynamic = body->is<PxRigidDynamic>();
-			PxRigidBodyExt::updateMassAndInertia(*dynamic, mass);
-		}
-	}
-	else {
+	if (!createBody(PxSphereGeometry(radius))) {
 		std::cerr << "Failed to create rigid body!" << std::endl;
 	}
 }
@@ -2,6 +2,7 @@
 #include "PhysicsComponent.hpp"
 
 class SpherePhysics : public PhysicsComponent {
+	COMPONENT_TYPE(SpherePhysics, PhysicsComponent)
 public:
     SpherePhysics(Type t = Type::STATIC);
 
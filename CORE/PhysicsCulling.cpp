@@ -0,0 +1,95 @@
+#include "PhysicsCulling.hpp"
+#include "GameObject.hpp"
+#include "PhysicsComponents/PhysicsComponent.hpp"
+#include "Jobs/JobSystem.hpp"
+#include <algorithm>
+#include <limits>
+
+
+void PhysicsCulling::update(const std::vector<std::shared_ptr<GameObject>>& objects, const glm::vec3* fallbackFocus) {
+	const glm::vec3* focus = m_focusPoints.empty() ? fallbackFocus : m_focusPoints.data();
+	size_t focusCount = m_focusPoints.empty() ? (fallbackFocus ? 1 : 0) : m_focusPoints.size();
+
+	// Nothing to measure against, keep everything as it is
+	if (focusCount == 0) return;
+
+	float activeSq = m_settings.activeRadius * m_settings.activeRadius;
+	float cullRadius = m_settings.activeRadius + std::max(m_settings.hysteresis, 0.0f);
+	float cullSq = cullRadius * cullRadius;
+
+	m_toActivate.clear();
+	m_toDeactivate.clear();
+	m_stats = Stats{};
+
+	// Distances on the job system, the objects are only read
+	m_measures.resize(objects.size());
+	JobSystem::parallelFor(objects.size(), 256, [&](size_t begin, size_t end) {
+		for (size_t o = begin; o < end; o++) {
+			Measure& measure = m_measures[o];
+			measure.decision = Decision::NONE;
+
+			PhysicsComponent* physicsComponent = objects[o]->getComponentPtr<PhysicsComponent>();
+			if (!physicsComponent || !physicsComponent->getActor()) continue;
+			PxRigidDynamic* dynamic = physicsComponent->getActor()->is<PxRigidDynamic>();
+			if (!dynamic || dynamic->getRigidBodyFlags().isSet(PxRigidBodyFlag::eKINEMATIC)) continue;
+
+			glm::vec3 position = objects[o]->getPosition();
+			float nearestSq = std::numeric_limits<float>::max();
+			for (size_t i = 0; i < focusCount; i++) {
+				glm::vec3 d = position - focus[i];
+				nearestSq = std::min(nearestSq, glm::dot(d, d));
+			}
+
+			bool enabled = physicsComponent->isSimulationEnabled();
+			measure.component = physicsComponent;
+			measure.distanceSq = nearestSq;
+			if (!enabled && nearestSq < activeSq)
+				measure.decision = Decision::ACTIVATE;
+			else if (enabled && nearestSq > cullSq)
+				measure.decision = Decision::DEACTIVATE;
+			else if (!enabled)
+				measure.decision = Decision::CULLED;
+		}
+	});
+
+	for (const Measure& measure : m_measures) {
+		switch (measure.decision) {
+		case Decision::ACTIVATE: m_toActivate.push_back({ measure.component, measure.distanceSq }); break;
+		case Decision::DEACTIVATE: m_toDeactivate.push_back({ measure.component, measure.distanceSq }); break;
+		case Decision::CULLED: m_stats.culled++; break;
+		case Decision::NONE: break;
+		}
+	}
+
+	// Over budget: nearest first back in, farthest first out
+	size_t activations = std::min<size_t>(m_toActivate.size(), m_settings.maxActivationsPerFrame);
+	if (activations < m_toActivate.size()) {
+		std::nth_element(m_toActivate.begin(), m_toActivate.begin() + activations, m_toActivate.end(),
+			[](const Candidate& a, const Candidate& b) { return a.distanceSq < b.distanceSq; });
+	}
+	size_t deactivations = std::min<size_t>(m_toDeactivate.size(), m_settings.maxDeactivationsPerFrame);
+	if (deactivations < m_toDeactivate.size()) {
+		std::nth_element(m_toDeactivate.begin(), m_toDeactivate.begin() + deactivations, m_toDeactivate.end(),
+			[](const Candidate& a, const Candidate& b) { return a.distanceSq > b.distanceSq; });
+	}
+
+	for (size_t i = 0; i < activations; i++) {
+		if (m_toActivate[i].component->setSimulationEnabled(true)) m_stats.activated++;
+	}
+	for (size_t i = 0; i < deactivations; i++) {
+		if (m_toDeactivate[i].component->setSimulationEnabled(false)) m_stats.deactivated++;
+	}
+
+	m_stats.pending = static_cast<uint32_t>((m_toActivate.size() - activations) + (m_toDeactivate.size() - deactivations));
+	// Still culled: waiting activations plus what was just put out
+	m_stats.culled += static_cast<uint32_t>(m_toActivate.size() - activations) + m_stats.deactivated;
+}
+
+void PhysicsCulling::restoreAll(const std::vector<std::shared_ptr<GameObject>>& objects) {
+	for (auto& gameObject : objects) {
+		auto physicsComponent = gameObject->getComponent<PhysicsComponent>();
+		if (physicsComponent && !physicsComponent->isSimulationEnabled())
+			physicsComponent->setSimulationEnabled(true);
+	}
+	m_stats = Stats{};
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class GameObject;
+class PhysicsComponent;
+
+// Simulation LOD of one Scene: dynamic bodies far from every focus point (camera,
+// players) stop simulating and come back with their state when a focus gets close.
+// The radius has a hysteresis band so bodies on the edge do not flip every frame,
+// and state changes are budgeted per frame, nearest bodies are activated first.
+class PhysicsCulling {
+public:
+	struct Settings {
+		float activeRadius = 150.0f;         // bodies closer than this to a focus simulate
+		float hysteresis = 25.0f;            // culled only beyond activeRadius + hysteresis
+		uint32_t maxActivationsPerFrame = 64;
+		uint32_t maxDeactivationsPerFrame = 64;
+	};
+
+	struct Stats {
+		uint32_t culled = 0;       // bodies not simulating after the last update
+		uint32_t activated = 0;    // state changes during the last update
+		uint32_t deactivated = 0;
+		uint32_t pending = 0;      // changes left for the next frames by the budget
+	};
+
+	void setEnabled(bool enabled) { m_enabled = enabled; }
+	bool isEnabled() const { return m_enabled; }
+
+	void setSettings(const Settings& settings) { m_settings = settings; }
+	const Settings& getSettings() const { return m_settings; }
+
+	// Explicit focus points, the scene camera is used while there are none
+	void setFocusPoints(const std::vector<glm::vec3>& points) { m_focusPoints = points; }
+	void clearFocusPoints() { m_focusPoints.clear(); }
+	const std::vector<glm::vec3>& getFocusPoints() const { return m_focusPoints; }
+
+	// Called by Scene::update before the step. `fallbackFocus` may be null (no camera).
+	void update(const std::vector<std::shared_ptr<GameObject>>& objects, const glm::vec3* fallbackFocus);
+
+	// Every culled body simulates again, no budget (recording, disabling the culling)
+	void restoreAll(const std::vector<std::shared_ptr<GameObject>>& objects);
+
+	const Stats& getStats() const { return m_stats; }
+
+private:
+	struct Candidate {
+		PhysicsComponent* component;
+		float distanceSq;
+	};
+
+	// Outcome of the distance pass for one object, filled in parallel
+	enum class Decision : uint8_t { NONE, ACTIVATE, DEACTIVATE, CULLED };
+	struct Measure {
+		PhysicsComponent* component;
+		float distanceSq;
+		Decision decision;
+	};
+
+	bool m_enabled = false;
+	Settings m_settings;
+	Stats m_stats;
+	std::vector<glm::vec3> m_focusPoints;
+	// Reused every frame
+	std::vector<Measure> m_measures;
+	std::vector<Candidate> m_toActivate;
+	std::vector<Candidate> m_toDeactivate;
+};
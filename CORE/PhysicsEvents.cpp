@@ -0,0 +1,184 @@
+#include "PhysicsEvents.hpp"
+#include "Component.hpp"
+#include "PhysicsComponents/PhysicsComponent.hpp"
+#include <algorithm>
+
+
+namespace {
+	// Shapes of subscribed components point back to them, see PhysicsComponent::subscribe
+	PhysicsComponent* componentOf(const PxShape* shape) {
+		return shape ? static_cast<PhysicsComponent*>(shape->userData) : nullptr;
+	}
+
+	PhysicsComponent* componentOf(PxActor* actor) {
+		PxRigidActor* rigid = actor->is<PxRigidActor>();
+		if (!rigid || rigid->getNbShapes() == 0) return nullptr;
+		PxShape* shape;
+		rigid->getShapes(&shape, 1);
+		return componentOf(shape);
+	}
+
+	GameObject* objectOf(const PxShape* shape) {
+		// Merged static actors hold shapes of many objects, the shape knows which one
+		return shape ? PhysicsComponent::getHitObject(shape->getActor(), shape) : nullptr;
+	}
+
+	inline glm::vec3 toGlm(const PxVec3& v) { return glm::vec3(v.x, v.y, v.z); }
+}
+
+
+PhysicsEvent* PhysicsEventCollector::push() {
+	if (m_events.size() >= m_capacity) {
+		m_dropped++;
+		return nullptr;
+	}
+	m_events.emplace_back();
+	PhysicsEvent* event = &m_events.back();
+	event->sequence = static_cast<uint32_t>(m_events.size() - 1);
+	return event;
+}
+
+void PhysicsEventCollector::pushContact(PhysicsEvent::Type type, PxShape* self, PxShape* other, const PxContactPair& pair, bool flip) {
+	PhysicsComponent* component = componentOf(self);
+	if (!component || !component->getEventListener() || !(component->getEventFlags() & PhysicsEventFlag::CONTACT))
+		return;
+
+	PhysicsEvent* event = push();
+	if (!event) return;
+	event->type = type;
+	event->listener = component->getEventListener();
+	event->self = component->getGameObject();
+	event->other = (pair.flags & (flip ? PxContactPairFlag::eREMOVED_SHAPE_0 : PxContactPairFlag::eREMOVED_SHAPE_1)) ? nullptr : objectOf(other);
+
+	if (type == PhysicsEvent::Type::CONTACT_BEGIN && pair.contactCount > 0) {
+		// A few points are enough for gameplay, they are read from the stream without copies to the heap
+		PxContactPairPoint points[8];
+		PxU32 count = pair.extractContacts(points, 8);
+		float impulse = 0.0f;
+		for (PxU32 i = 0; i < count; i++) impulse += points[i].impulse.magnitude();
+		if (count > 0) {
+			event->point = toGlm(points[0].position);
+			// PhysX normals point from shape 1 to shape 0
+			event->normal = toGlm(flip ? -points[0].normal : points[0].normal);
+		}
+		event->impulse = impulse;
+	}
+}
+
+void PhysicsEventCollector::onContact(const PxContactPairHeader& pairHeader, const PxContactPair* pairs, PxU32 nbPairs) {
+	PX_UNUSED(pairHeader);
+	// A removed actor reports its pairs with removed shapes: the survivor still gets
+	// CONTACT_END, with `other` null as for triggers
+	for (PxU32 i = 0; i < nbPairs; i++) {
+		const PxContactPair& pair = pairs[i];
+		PhysicsEvent::Type type;
+		if (pair.events & PxPairFlag::eNOTIFY_TOUCH_FOUND) type = PhysicsEvent::Type::CONTACT_BEGIN;
+		else if (pair.events & PxPairFlag::eNOTIFY_TOUCH_LOST) type = PhysicsEvent::Type::CONTACT_END;
+		else continue;
+
+		// Both sides may be subscribed, each gets the event from its own point of view
+		if (!(pair.flags & PxContactPairFlag::eREMOVED_SHAPE_0))
+			pushContact(type, pair.shapes[0], pair.shapes[1], pair, false);
+		if (!(pair.flags & PxContactPairFlag::eREMOVED_SHAPE_1))
+			pushContact(type, pair.shapes[1], pair.shapes[0], pair, true);
+	}
+}
+
+void PhysicsEventCollector::onTrigger(PxTriggerPair* pairs, PxU32 count) {
+	for (PxU32 i = 0; i < count; i++) {
+		const PxTriggerPair& pair = pairs[i];
+		bool removedTrigger = pair.flags & PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER;
+		bool removedOther = pair.flags & PxTriggerPairFlag::eREMOVED_SHAPE_OTHER;
+		PhysicsEvent::Type type = pair.status == PxPairFlag::eNOTIFY_TOUCH_FOUND
+			? PhysicsEvent::Type::TRIGGER_ENTER : PhysicsEvent::Type::TRIGGER_EXIT;
+
+		// The trigger and the object entering it can both listen
+		PxShape* sides[2] = { removedTrigger ? nullptr : pair.triggerShape, removedOther ? nullptr : pair.otherShape };
+		for (int side = 0; side < 2; side++) {
+			PhysicsComponent* component = componentOf(sides[side]);
+			if (!component || !component->getEventListener() || !(component->getEventFlags() & PhysicsEventFlag::TRIGGER))
+				continue;
+
+			PhysicsEvent* event = push();
+			if (!event) return;
+			event->type = type;
+			event->listener = component->getEventListener();
+			event->self = component->getGameObject();
+			event->other = objectOf(sides[1 - side]);
+		}
+	}
+}
+
+void PhysicsEventCollector::onSleep(PxActor** actors, PxU32 count) {
+	for (PxU32 i = 0; i < count; i++) {
+		PhysicsComponent* component = componentOf(actors[i]);
+		if (!component || !component->getEventListener() || !(component->getEventFlags() & PhysicsEventFlag::SLEEP_WAKE))
+			continue;
+		PhysicsEvent* event = push();
+		if (!event) return;
+		event->type = PhysicsEvent::Type::SLEEP;
+		event->listener = component->getEventListener();
+		event->self = component->getGameObject();
+	}
+}
+
+void PhysicsEventCollector::onWake(PxActor** actors, PxU32 count) {
+	for (PxU32 i = 0; i < count; i++) {
+		PhysicsComponent* component = componentOf(actors[i]);
+		if (!component || !component->getEventListener() || !(component->getEventFlags() & PhysicsEventFlag::SLEEP_WAKE))
+			continue;
+		PhysicsEvent* event = push();
+		if (!event) return;
+		event->type = PhysicsEvent::Type::WAKE;
+		event->listener = component->getEventListener();
+		event->self = component->getGameObject();
+	}
+}
+
+void PhysicsEventCollector::dispatch() {
+	m_lastCount = static_cast<uint32_t>(m_events.size());
+	if (m_events.empty()) return;
+
+	// In place: one batch per listener, PhysX order kept inside a batch
+	std::sort(m_events.begin(), m_events.end(), [](const PhysicsEvent& a, const PhysicsEvent& b) {
+		return a.listener != b.listener ? a.listener < b.listener : a.sequence < b.sequence;
+	});
+
+	size_t begin = 0;
+	while (begin < m_events.size()) {
+		size_t end = begin + 1;
+		while (end < m_events.size() && m_events[end].listener == m_events[begin].listener) end++;
+		m_events[begin].listener->onPhysicsEvents(&m_events[begin], static_cast<uint32_t>(end - begin));
+		begin = end;
+	}
+
+	// clear keeps the capacity
+	m_events.clear();
+}
+
+
+namespace Physics {
+
+	PxFilterFlags eventFilterShader(PxFilterObjectAttributes attributes0, PxFilterData filterData0,
+		PxFilterObjectAttributes attributes1, PxFilterData filterData1,
+		PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize) {
+		PX_UNUSED(constantBlock);
+		PX_UNUSED(constantBlockSize);
+
+		PxU32 events = filterData0.word2 | filterData1.word2;
+
+		if (PxFilterObjectIsTrigger(attributes0) || PxFilterObjectIsTrigger(attributes1)) {
+			// Nobody listens to this trigger pair, drop it before it costs anything
+			if (!(events & PhysicsEventFlag::TRIGGER))
+				return PxFilterFlag::eSUPPRESS;
+			pairFlags = PxPairFlag::eTRIGGER_DEFAULT;
+			return PxFilterFlag::eDEFAULT;
+		}
+
+		pairFlags = PxPairFlag::eCONTACT_DEFAULT;
+		if (events & PhysicsEventFlag::CONTACT) {
+			pairFlags |= PxPairFlag::eNOTIFY_TOUCH_FOUND | PxPairFlag::eNOTIFY_TOUCH_LOST | PxPairFlag::eNOTIFY_CONTACT_POINTS;
+		}
+		return PxFilterFlag::eDEFAULT;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Physics.hpp"
+
+class GameObject;
+class Component;
+class PhysicsComponent;
+
+// What a PhysicsComponent wants to hear about, stored in word2 of its shapes'
+// simulation filter data so the filter shader only reports the pairs asked for
+namespace PhysicsEventFlag
+{
+	enum : uint32_t {
+		CONTACT = 1 << 0,     // touch found / lost with contact point and impulse
+		TRIGGER = 1 << 1,     // enter / exit of trigger shapes
+		SLEEP_WAKE = 1 << 2,  // the body falls asleep / wakes up
+	};
+}
+
+struct PhysicsEvent {
+	enum class Type : uint8_t { CONTACT_BEGIN, CONTACT_END, TRIGGER_ENTER, TRIGGER_EXIT, SLEEP, WAKE };
+
+	Type type = Type::CONTACT_BEGIN;
+	Component* listener = nullptr;   // receiver of the event
+	GameObject* self = nullptr;      // object the listener subscribed for
+	GameObject* other = nullptr;     // nullptr for sleep / wake, or when the other shape was released
+	glm::vec3 point = glm::vec3(0.0f);  // first contact point (CONTACT_BEGIN)
+	glm::vec3 normal = glm::vec3(0.0f); // pointing from other to self
+	float impulse = 0.0f;               // summed over the contact points
+	uint32_t sequence = 0;              // order in which PhysX reported it during the step
+};
+
+// Simulation event callback of one PhysicsScene. PhysX calls it from fetchResults on
+// the thread stepping the scene, so each scene (and so each stepper thread) fills its
+// own buffer. The buffer is reserved up front and dispatch() hands every listener one
+// contiguous batch after the step, nothing is allocated while the simulation runs.
+class PhysicsEventCollector : public PxSimulationEventCallback {
+public:
+	explicit PhysicsEventCollector(uint32_t capacity = 4096) { setCapacity(capacity); }
+
+	void setCapacity(uint32_t capacity) { m_capacity = capacity; m_events.reserve(capacity); }
+
+	// Groups the buffered events by listener and calls Component::onPhysicsEvents once per listener
+	void dispatch();
+
+	uint32_t getLastEventCount() const { return m_lastCount; }
+	// Events dropped because the buffer was full, since the scene was created
+	uint64_t getDroppedCount() const { return m_dropped; }
+
+	void onContact(const PxContactPairHeader& pairHeader, const PxContactPair* pairs, PxU32 nbPairs) override;
+	void onTrigger(PxTriggerPair* pairs, PxU32 count) override;
+	void onSleep(PxActor** actors, PxU32 count) override;
+	void onWake(PxActor** actors, PxU32 count) override;
+	void onConstraintBreak(PxConstraintInfo*, PxU32) override {}
+	void onAdvance(const PxRigidBody* const*, const PxTransform*, const PxU32) override {}
+
+private:
+	PhysicsEvent* push();
+	void pushContact(PhysicsEvent::Type type, PxShape* self, PxShape* other, const PxContactPair& pair, bool flip);
+
+	std::vector<PhysicsEvent> m_events;
+	uint32_t m_capacity = 0;
+	uint32_t m_lastCount = 0;
+	uint64_t m_dropped = 0;
+};
+
+namespace Physics
+{
+	// Collides every pair like the default shader, and only turns on contact / trigger
+	// reports for pairs where one shape carries the matching PhysicsEventFlag
+	PxFilterFlags eventFilterShader(PxFilterObjectAttributes attributes0, PxFilterData filterData0,
+		PxFilterObjectAttributes attributes1, PxFilterData filterData1,
+		PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize);
+}
@@ -0,0 +1,182 @@
+#include "PhysicsMeshCache.hpp"
+#include "Debug.hpp"
+#include <unordered_map>
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+
+namespace PhysicsMeshCache {
+
+	namespace Internal {
+		std::string cacheDirectory = "cache/physx";
+
+		std::unordered_map<uint64_t, PxTriangleMesh*> triangleMeshes;
+		std::unordered_map<uint64_t, PxConvexMesh*> convexMeshes;
+
+		void fnv1a(uint64_t& hash, const void* data, size_t size) {
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; i++) {
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+		}
+
+		std::string cachePath(uint64_t hash, const char* extension) {
+			std::stringstream ss;
+			ss << cacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << extension;
+			return ss.str();
+		}
+
+		bool readFile(const std::string& path, std::vector<PxU8>& data) {
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+				return false;
+
+			std::streamsize size = file.tellg();
+			if (size <= 0)
+				return false;
+
+			file.seekg(0, std::ios::beg);
+			data.resize(static_cast<size_t>(size));
+			return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), size));
+		}
+
+		void writeFile(const std::string& path, const PxDefaultMemoryOutputStream& stream) {
+			std::error_code ec;
+			std::filesystem::create_directories(cacheDirectory, ec);
+
+			std::ofstream file(path, std::ios::binary);
+			if (!file.is_open()) {
+				std::cerr << "Failed to write physics cache: " << path << std::endl;
+				return;
+			}
+			file.write(reinterpret_cast<const char*>(stream.getData()), stream.getSize());
+		}
+
+		PxCookingParams cookingParams() {
+			return PxCookingParams(Physics::getPhysics()->getTolerancesScale());
+		}
+
+		// Loads the cooked stream from disk, or cooks it and writes it back
+		template<typename CookFn>
+		bool loadOrCook(uint64_t hash, const char* extension, std::vector<PxU8>& data, CookFn&& cook) {
+			std::string path = cachePath(hash, extension);
+			if (readFile(path, data))
+				return true;
+
+			PxDefaultMemoryOutputStream stream;
+			if (!cook(stream)) {
+				std::cerr << "PhysX cooking failed for mesh " << path << std::endl;
+				return false;
+			}
+			writeFile(path, stream);
+			data.assign(stream.getData(), stream.getData() + stream.getSize());
+			LOG_OK("Cooked physics mesh: " << path);
+			return true;
+		}
+	}
+
+	void setCacheDirectory(const std::string& directory) {
+		Internal::cacheDirectory = directory;
+	}
+
+	const std::string& getCacheDirectory() {
+		return Internal::cacheDirectory;
+	}
+
+	uint64_t hashMesh(const Mesh& mesh) {
+		uint64_t hash = 14695981039346656037ull;
+		const uint32_t version = PX_PHYSICS_VERSION;
+		Internal::fnv1a(hash, &version, sizeof(version));
+
+		for (const Vertex& v : mesh.vertices) {
+			Internal::fnv1a(hash, &v.Position, sizeof(v.Position));
+		}
+		if (!mesh.indices.empty())
+			Internal::fnv1a(hash, mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+		return hash;
+	}
+
+	PxTriangleMesh* getTriangleMesh(const Mesh& mesh) {
+		if (mesh.vertices.empty() || mesh.indices.size() < 3)
+			return nullptr;
+
+		uint64_t hash = hashMesh(mesh);
+		auto it = Internal::triangleMeshes.find(hash);
+		if (it != Internal::triangleMeshes.end()) {
+			it->second->acquireReference();
+			return it->second;
+		}
+
+		std::vector<PxU8> data;
+		bool ok = Internal::loadOrCook(hash, ".tri", data, [&mesh](PxDefaultMemoryOutputStream& stream) {
+			PxTriangleMeshDesc desc;
+			desc.points.count = static_cast<PxU32>(mesh.vertices.size());
+			desc.points.stride = sizeof(Vertex);
+			desc.points.data = &mesh.vertices[0].Position;
+			desc.triangles.count = static_cast<PxU32>(mesh.indices.size() / 3);
+			desc.triangles.stride = 3 * sizeof(unsigned int);
+			desc.triangles.data = mesh.indices.data();
+			return PxCookTriangleMesh(Internal::cookingParams(), desc, stream);
+		});
+		if (!ok)
+			return nullptr;
+
+		PxDefaultMemoryInputData input(data.data(), static_cast<PxU32>(data.size()));
+		PxTriangleMesh* triangleMesh = Physics::getPhysics()->createTriangleMesh(input);
+		if (!triangleMesh)
+			return nullptr;
+
+		Internal::triangleMeshes[hash] = triangleMesh; // the cache keeps the creation reference
+		triangleMesh->acquireReference();
+		return triangleMesh;
+	}
+
+	PxConvexMesh* getConvexMesh(const Mesh& mesh) {
+		if (mesh.vertices.size() < 4)
+			return nullptr;
+
+		uint64_t hash = hashMesh(mesh);
+		auto it = Internal::convexMeshes.find(hash);
+		if (it != Internal::convexMeshes.end()) {
+			it->second->acquireReference();
+			return it->second;
+		}
+
+		std::vector<PxU8> data;
+		bool ok = Internal::loadOrCook(hash, ".cvx", data, [&mesh](PxDefaultMemoryOutputStream& stream) {
+			PxConvexMeshDesc desc;
+			desc.points.count = static_cast<PxU32>(mesh.vertices.size());
+			desc.points.stride = sizeof(Vertex);
+			desc.points.data = &mesh.vertices[0].Position;
+			desc.flags = PxConvexFlag::eCOMPUTE_CONVEX | PxConvexFlag::eSHIFT_VERTICES;
+			return PxCookConvexMesh(Internal::cookingParams(), desc, stream);
+		});
+		if (!ok)
+			return nullptr;
+
+		PxDefaultMemoryInputData input(data.data(), static_cast<PxU32>(data.size()));
+		PxConvexMesh* convexMesh = Physics::getPhysics()->createConvexMesh(input);
+		if (!convexMesh)
+			return nullptr;
+
+		Internal::convexMeshes[hash] = convexMesh;
+		convexMesh->acquireReference();
+		return convexMesh;
+	}
+
+	void clear() {
+		for (auto& [hash, triangleMesh] : Internal::triangleMeshes) {
+			triangleMesh->release();
+		}
+		for (auto& [hash, convexMesh] : Internal::convexMeshes) {
+			convexMesh->release();
+		}
+		Internal::triangleMeshes.clear();
+		Internal::convexMeshes.clear();
+	}
+}
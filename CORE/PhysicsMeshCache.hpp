@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "Physics.hpp"
+#include "ModelLoader/Mesh.hpp"
+
+// Cooks Mesh data into PhysX collision meshes.
+// Cooked streams are stored on disk keyed by a hash of the geometry, so later
+// launches only deserialize them. Meshes are also shared in memory per hash.
+namespace PhysicsMeshCache
+{
+	void setCacheDirectory(const std::string& directory);
+	const std::string& getCacheDirectory();
+
+	// Hash of positions + indices + PhysX version, used as the cache key
+	uint64_t hashMesh(const Mesh& mesh);
+
+	// Returned meshes carry a reference owned by the caller (release() when done,
+	// shapes keep their own reference). nullptr if cooking failed.
+	PxTriangleMesh* getTriangleMesh(const Mesh& mesh);
+	PxConvexMesh* getConvexMesh(const Mesh& mesh);
+
+	// Drops the in memory meshes, must run before Physics::shutdown
+	void clear();
+}
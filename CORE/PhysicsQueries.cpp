@@ -0,0 +1,156 @@
+#include "PhysicsQueries.hpp"
+#include "Jobs/JobSystem.hpp"
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+
+
+namespace Physics {
+
+	namespace Internal {
+		// Queries are cheap, chunks must be big enough to amortize the dispatch
+		const size_t queryGrainSize = 64;
+
+		QueryBatchTiming lastQueryTiming;
+
+		inline PxVec3 toPx(const glm::vec3& v) { return PxVec3(v.x, v.y, v.z); }
+		inline glm::vec3 toGlm(const PxVec3& v) { return glm::vec3(v.x, v.y, v.z); }
+
+		// Applies the mode on top of the user filter
+		PxQueryFilterData makeFilter(const PxQueryFilterData& filter, QueryMode mode) {
+			PxQueryFilterData data = filter;
+			if (mode == QueryMode::ANY_HIT)
+				data.flags |= PxQueryFlag::eANY_HIT;
+			else if (mode == QueryMode::MULTI_HIT)
+				data.flags |= PxQueryFlag::eNO_BLOCK; // every hit reported as a touch
+			return data;
+		}
+
+		// Per thread touch scratch, grows once to the biggest maxHitsPerQuery seen
+		template<typename HitType>
+		HitType* getScratch(uint32_t size) {
+			thread_local std::vector<HitType> scratch;
+			if (scratch.size() < size)
+				scratch.resize(size);
+			return scratch.data();
+		}
+
+		template<typename HitType>
+		void writeHit(QueryHit& out, const HitType& hit) {
+			out.actor = hit.actor;
+			out.shape = hit.shape;
+			out.position = toGlm(hit.position);
+			out.normal = toGlm(hit.normal);
+			out.distance = hit.distance;
+		}
+
+		template<>
+		void writeHit<PxOverlapHit>(QueryHit& out, const PxOverlapHit& hit) {
+			out.actor = hit.actor;
+			out.shape = hit.shape;
+			out.position = glm::vec3(0.0f);
+			out.normal = glm::vec3(0.0f);
+			out.distance = 0.0f;
+		}
+
+		// Copies a PhysX hit buffer into slot i of the result buffer. Multi hit buffers hold
+		// one touch more than the slot: PhysX stops silently once the buffer is full, the
+		// extra touch is what tells a dropped hit from a slot filled exactly.
+		template<typename HitType>
+		uint32_t storeHits(const PxHitBuffer<HitType>& buffer, QueryMode mode, QueryResultBuffer& out, uint32_t i) {
+			QueryResult& result = out.result(i);
+			QueryHit* hits = out.hits(i);
+			result.nbHits = 0;
+			result.overflow = false;
+
+			if (mode == QueryMode::MULTI_HIT) {
+				uint32_t nb = std::min(buffer.getNbTouches(), out.getMaxHitsPerQuery());
+				for (uint32_t h = 0; h < nb; h++) {
+					writeHit(hits[h], buffer.getTouch(h));
+				}
+				result.nbHits = nb;
+				result.overflow = buffer.getNbTouches() > out.getMaxHitsPerQuery();
+			}
+			else if (buffer.hasBlock) {
+				writeHit(hits[0], buffer.block);
+				result.nbHits = 1;
+			}
+			return result.nbHits;
+		}
+
+		// Runs query(i) over [0, count) on the job system and times the whole batch
+		template<typename Fn>
+		QueryBatchTiming runBatch(uint32_t count, QueryResultBuffer& out, Fn&& query) {
+			using namespace std::chrono;
+			high_resolution_clock::time_point start = high_resolution_clock::now();
+
+			if (count > out.getCapacity())
+				count = out.getCapacity();
+
+			std::atomic<uint32_t> totalHits{ 0 };
+			JobSystem::parallelFor(count, queryGrainSize, [&](size_t begin, size_t end) {
+				uint32_t localHits = 0;
+				for (size_t i = begin; i < end; i++) {
+					localHits += query(static_cast<uint32_t>(i));
+				}
+				totalHits += localHits;
+			});
+
+			QueryBatchTiming timing;
+			timing.totalMs = duration<double, std::milli>(high_resolution_clock::now() - start).count();
+			timing.nbQueries = count;
+			timing.nbHits = totalHits.load();
+			timing.nbThreads = JobSystem::getThreadCount() + 1;
+			lastQueryTiming = timing;
+			return timing;
+		}
+	}
+
+	QueryBatchTiming raycastBatch(PxScene* scene, const RaycastQuery* queries, uint32_t count, QueryMode mode, QueryResultBuffer& out) {
+		const uint32_t maxHits = out.getMaxHitsPerQuery();
+
+		return Internal::runBatch(count, out, [&](uint32_t i) {
+			const RaycastQuery& q = queries[i];
+			PxRaycastHit* touches = mode == QueryMode::MULTI_HIT ? Internal::getScratch<PxRaycastHit>(maxHits + 1) : nullptr;
+			PxRaycastBuffer buffer(touches, touches ? maxHits + 1 : 0);
+
+			scene->raycast(Internal::toPx(q.origin), Internal::toPx(q.direction), q.maxDistance, buffer,
+				PxHitFlag::eDEFAULT, Internal::makeFilter(q.filter, mode));
+			return Internal::storeHits(buffer, mode, out, i);
+		});
+	}
+
+	QueryBatchTiming sweepBatch(PxScene* scene, const SweepQuery* queries, uint32_t count, QueryMode mode, QueryResultBuffer& out) {
+		const uint32_t maxHits = out.getMaxHitsPerQuery();
+
+		return Internal::runBatch(count, out, [&](uint32_t i) {
+			const SweepQuery& q = queries[i];
+			PxSweepHit* touches = mode == QueryMode::MULTI_HIT ? Internal::getScratch<PxSweepHit>(maxHits + 1) : nullptr;
+			PxSweepBuffer buffer(touches, touches ? maxHits + 1 : 0);
+
+			scene->sweep(q.geometry.any(), q.pose, Internal::toPx(q.direction), q.maxDistance, buffer,
+				PxHitFlag::eDEFAULT, Internal::makeFilter(q.filter, mode));
+			return Internal::storeHits(buffer, mode, out, i);
+		});
+	}
+
+	QueryBatchTiming overlapBatch(PxScene* scene, const OverlapQuery* queries, uint32_t count, QueryMode mode, QueryResultBuffer& out) {
+		const uint32_t maxHits = out.getMaxHitsPerQuery();
+		// Overlaps have no distance, closest makes no sense
+		if (mode == QueryMode::CLOSEST)
+			mode = QueryMode::ANY_HIT;
+
+		return Internal::runBatch(count, out, [&](uint32_t i) {
+			const OverlapQuery& q = queries[i];
+			PxOverlapHit* touches = mode == QueryMode::MULTI_HIT ? Internal::getScratch<PxOverlapHit>(maxHits + 1) : nullptr;
+			PxOverlapBuffer buffer(touches, touches ? maxHits + 1 : 0);
+
+			scene->overlap(q.geometry.any(), q.pose, buffer, Internal::makeFilter(q.filter, mode));
+			return Internal::storeHits(buffer, mode, out, i);
+		});
+	}
+
+	const QueryBatchTiming& getLastQueryBatchTiming() {
+		return Internal::lastQueryTiming;
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Physics.hpp"
+
+// Batched scene queries: many raycasts / sweeps / overlaps executed in parallel
+// against one PxScene, results written to a caller owned preallocated buffer.
+namespace Physics
+{
+	enum class QueryMode {
+		CLOSEST,    // nearest blocking hit only (overlaps behave like ANY_HIT)
+		ANY_HIT,    // stop at the first hit found, cheapest
+		MULTI_HIT   // every hit up to the buffer capacity
+	};
+
+	struct RaycastQuery {
+		glm::vec3 origin = glm::vec3(0.0f);
+		glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f); // must be normalized
+		float maxDistance = 1000.0f;
+		PxQueryFilterData filter = PxQueryFilterData(PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC);
+	};
+
+	struct SweepQuery {
+		PxGeometryHolder geometry;
+		PxTransform pose = PxTransform(PxIdentity);
+		glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f); // must be normalized
+		float maxDistance = 1000.0f;
+		PxQueryFilterData filter = PxQueryFilterData(PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC);
+	};
+
+	struct OverlapQuery {
+		PxGeometryHolder geometry;
+		PxTransform pose = PxTransform(PxIdentity);
+		PxQueryFilterData filter = PxQueryFilterData(PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC);
+	};
+
+	struct QueryHit {
+		PxRigidActor* actor = nullptr;
+		PxShape* shape = nullptr;
+		glm::vec3 position = glm::vec3(0.0f); // unused for overlaps
+		glm::vec3 normal = glm::vec3(0.0f);   // unused for overlaps
+		float distance = 0.0f;
+	};
+
+	// Hits of query i live in getHits(i)[0 .. nbHits)
+	struct QueryResult {
+		uint32_t nbHits = 0;
+		bool overflow = false; // more hits existed than maxHitsPerQuery
+	};
+
+	struct QueryBatchTiming {
+		double totalMs = 0.0;
+		uint32_t nbQueries = 0;
+		uint32_t nbHits = 0;
+		uint32_t nbThreads = 0;
+	};
+
+	// Output storage, sized once and reused every frame so batches do not allocate
+	class QueryResultBuffer {
+	public:
+		QueryResultBuffer() = default;
+		QueryResultBuffer(uint32_t maxQueries, uint32_t maxHitsPerQuery) { reserve(maxQueries, maxHitsPerQuery); }
+
+		void reserve(uint32_t maxQueries, uint32_t maxHitsPerQuery) {
+			m_maxHitsPerQuery = maxHitsPerQuery > 0 ? maxHitsPerQuery : 1;
+			m_results.resize(maxQueries);
+			m_hits.resize(static_cast<size_t>(maxQueries) * m_maxHitsPerQuery);
+		}
+
+		uint32_t getCapacity() const { return static_cast<uint32_t>(m_results.size()); }
+		uint32_t getMaxHitsPerQuery() const { return m_maxHitsPerQuery; }
+
+		const QueryResult& getResult(uint32_t i) const { return m_results[i]; }
+		const QueryHit* getHits(uint32_t i) const { return &m_hits[static_cast<size_t>(i) * m_maxHitsPerQuery]; }
+
+		QueryResult& result(uint32_t i) { return m_results[i]; }
+		QueryHit* hits(uint32_t i) { return &m_hits[static_cast<size_t>(i) * m_maxHitsPerQuery]; }
+
+	private:
+		std::vector<QueryResult> m_results;
+		std::vector<QueryHit> m_hits;
+		uint32_t m_maxHitsPerQuery = 1;
+	};
+
+	// The scene must not be simulating while a batch runs.
+	// out must have a capacity >= count, extra queries are ignored.
+	QueryBatchTiming raycastBatch(PxScene* scene, const RaycastQuery* queries, uint32_t count, QueryMode mode, QueryResultBuffer& out);
+	QueryBatchTiming sweepBatch(PxScene* scene, const SweepQuery* queries, uint32_t count, QueryMode mode, QueryResultBuffer& out);
+	QueryBatchTiming overlapBatch(PxScene* scene, const OverlapQuery* queries, uint32_t count, QueryMode mode, QueryResultBuffer& out);
+
+	// Timing of the last batch of any kind, for debug panels
+	const QueryBatchTiming& getLastQueryBatchTiming();
+}
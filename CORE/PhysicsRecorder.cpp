@@ -0,0 +1,553 @@
+#include "PhysicsRecorder.hpp"
+#include "Scene.hpp"
+#include "PhysicsSnapshot.hpp"
+#include "PhysicsComponents/PhysicsComponent.hpp"
+#include "PhysicsComponents/CubePhysics.hpp"
+#include "PhysicsComponents/SpherePhysics.hpp"
+#include "Prefabs/PrefabManager.hpp"
+#include <unordered_map>
+#include <fstream>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+
+
+namespace PhysicsRecorder {
+
+	namespace Internal {
+		const uint32_t magic = 0x52434C43; // "CLCR"
+		const uint32_t version = 4;
+
+		enum class Command : uint8_t {
+			STEP,            // f32 dt
+			STEP_SAME_DT,    // same dt as the previous step
+			SPAWN,           // string prefab, pose, scale, f32 mass, vec3 linear, vec3 angular
+			DESTROY,         // id
+			FORCE,           // id, vec3
+			TORQUE,          // id, vec3
+			LINEAR_VELOCITY, // id, vec3
+			ANGULAR_VELOCITY,// id, vec3
+			MASS,            // id, f32
+			POSE,            // id, pose
+			SCALE,           // id, vec3
+			KINEMATIC_TARGET,// id, pose
+		};
+
+		// Which component the replay rebuilds before restoring the snapshot
+		enum class ObjectKind : uint8_t { NONE, CUBE, SPHERE, OTHER };
+
+		// Little endian byte stream, ids are varints since most sessions stay under 128 objects
+		struct Writer {
+			std::vector<uint8_t> bytes;
+
+			void u8(uint8_t v) { bytes.push_back(v); }
+			void u32(uint32_t v) { raw(&v, sizeof(v)); }
+			void f32(float v) { raw(&v, sizeof(v)); }
+			void varint(uint32_t v) {
+				while (v >= 0x80) { bytes.push_back(static_cast<uint8_t>(v | 0x80)); v >>= 7; }
+				bytes.push_back(static_cast<uint8_t>(v));
+			}
+			void vec3(const glm::vec3& v) { f32(v.x); f32(v.y); f32(v.z); }
+			void pose(const PxTransform& t) {
+				f32(t.p.x); f32(t.p.y); f32(t.p.z);
+				f32(t.q.x); f32(t.q.y); f32(t.q.z); f32(t.q.w);
+			}
+			void string(const std::string& s) { varint(static_cast<uint32_t>(s.size())); raw(s.data(), s.size()); }
+			void raw(const void* data, size_t size) {
+				const uint8_t* p = static_cast<const uint8_t*>(data);
+				bytes.insert(bytes.end(), p, p + size);
+			}
+		};
+
+		struct Reader {
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			size_t offset = 0;
+			bool failed = false;
+
+			bool raw(void* out, size_t count) {
+				if (failed || offset + count > size) { failed = true; return false; }
+				std::memcpy(out, data + offset, count);
+				offset += count;
+				return true;
+			}
+			uint8_t u8() { uint8_t v = 0; raw(&v, 1); return v; }
+			uint32_t u32() { uint32_t v = 0; raw(&v, sizeof(v)); return v; }
+			float f32() { float v = 0.0f; raw(&v, sizeof(v)); return v; }
+			uint32_t varint() {
+				uint32_t v = 0;
+				for (int shift = 0; shift < 35; shift += 7) {
+					uint8_t b = u8();
+					v |= static_cast<uint32_t>(b & 0x7F) << shift;
+					if (!(b & 0x80) || failed) break;
+				}
+				return v;
+			}
+			glm::vec3 vec3() { float x = f32(), y = f32(), z = f32(); return glm::vec3(x, y, z); }
+			PxTransform pose() {
+				PxTransform t;
+				t.p.x = f32(); t.p.y = f32(); t.p.z = f32();
+				t.q.x = f32(); t.q.y = f32(); t.q.z = f32(); t.q.w = f32();
+				return t;
+			}
+			std::string string() {
+				std::string s(varint(), '\0');
+				raw(s.data(), s.size());
+				return s;
+			}
+			bool atEnd() const { return failed || offset >= size; }
+		};
+
+		const Scene* recordedScene = nullptr;
+		std::unordered_map<const GameObject*, uint32_t> ids;
+		uint32_t nextId = 0;
+
+		Writer header;   // initial objects table
+		PhysicsSnapshot snapshot;
+		Writer stream;   // commands
+		float lastDt = -1.0f;
+		uint32_t steps = 0;
+		// Solver setting of the recorded scene, the replay scene is created with the same
+		bool enhancedDeterminism = false;
+
+		bool findId(const GameObject* object, uint32_t& id) {
+			if (!recordedScene || !object) return false;
+			auto it = ids.find(object);
+			if (it == ids.end()) return false;
+			id = it->second;
+			return true;
+		}
+
+		void command(Command c, uint32_t id) {
+			stream.u8(static_cast<uint8_t>(c));
+			stream.varint(id);
+		}
+
+		ObjectKind kindOf(GameObject* object, bool& dynamic) {
+			auto physicsComponent = object->getComponent<PhysicsComponent>();
+			dynamic = physicsComponent && physicsComponent->getActor() && physicsComponent->getActor()->is<PxRigidDynamic>();
+			if (!physicsComponent) return ObjectKind::NONE;
+			if (object->getComponent<CubePhysics>()) return ObjectKind::CUBE;
+			if (object->getComponent<SpherePhysics>()) return ObjectKind::SPHERE;
+			return ObjectKind::OTHER;
+		}
+
+		void fnv1a(uint64_t& hash, const void* data, size_t size) {
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; i++) {
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+		}
+	}
+
+	bool start(Scene* scene) {
+		if (!scene) return false;
+		if (Internal::recordedScene) {
+			std::cerr << "PhysicsRecorder: already recording" << std::endl;
+			return false;
+		}
+
+		PxScene* pxScene = scene->getPhysicsScene()->getScene();
+		Internal::enhancedDeterminism = pxScene->getFlags() & PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+		if (!Internal::enhancedDeterminism) {
+			std::cerr << "PhysicsRecorder: scene was created without enhanced determinism, replays may diverge" << std::endl;
+		}
+
+		auto& objects = scene->getGameObjects();
+		if (!scene->savePhysicsSnapshot(Internal::snapshot))
+			return false;
+		// Live and replayed scenes now both come out of the same snapshot
+		scene->loadPhysicsSnapshot(Internal::snapshot);
+
+		Internal::header = Internal::Writer();
+		Internal::stream = Internal::Writer();
+		Internal::ids.clear();
+		Internal::lastDt = -1.0f;
+		Internal::steps = 0;
+
+		Internal::header.varint(static_cast<uint32_t>(objects.size()));
+		for (size_t i = 0; i < objects.size(); i++) {
+			GameObject* object = objects[i].get();
+			Internal::ids[object] = static_cast<uint32_t>(i);
+
+			bool dynamic = false;
+			Internal::ObjectKind kind = Internal::kindOf(object, dynamic);
+			glm::quat rotation = object->getRotationQuaternion();
+			Internal::header.u8(static_cast<uint8_t>(kind));
+			Internal::header.u8(dynamic ? 1 : 0);
+			Internal::header.string(object->getName());
+			Internal::header.vec3(object->getPosition());
+			Internal::header.f32(rotation.x); Internal::header.f32(rotation.y);
+			Internal::header.f32(rotation.z); Internal::header.f32(rotation.w);
+			Internal::header.vec3(object->getScale());
+			// The snapshot knows the actors by these
+			Internal::header.u32(object->getHandle().index);
+			Internal::header.u32(object->getHandle().generation);
+			auto physicsComponent = object->getComponent<PhysicsComponent>();
+			Internal::header.f32(physicsComponent ? physicsComponent->getMass() : 0.0f);
+		}
+		Internal::nextId = static_cast<uint32_t>(objects.size());
+		Internal::recordedScene = scene;
+
+		std::cout << "Physics recording started with " << objects.size() << " objects" << std::endl;
+		return true;
+	}
+
+	bool stop(const std::string& path) {
+		if (!Internal::recordedScene) return false;
+		Internal::recordedScene = nullptr;
+		Internal::ids.clear();
+
+		std::cout << "Physics recording stopped: " << Internal::steps << " steps, "
+			<< Internal::stream.bytes.size() << " bytes of commands" << std::endl;
+		if (path.empty()) return true;
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "Failed to open physics recording file: " << path << std::endl;
+			return false;
+		}
+
+		Internal::Writer prefix;
+		prefix.u32(Internal::magic);
+		prefix.u32(Internal::version);
+		prefix.u32(PX_PHYSICS_VERSION);
+		prefix.u32(Internal::enhancedDeterminism ? 1 : 0);
+		prefix.u32(Internal::snapshot.nbActors);
+		prefix.u32(static_cast<uint32_t>(Internal::snapshot.data.size()));
+		prefix.u32(static_cast<uint32_t>(Internal::header.bytes.size()));
+		prefix.u32(static_cast<uint32_t>(Internal::stream.bytes.size()));
+
+		file.write(reinterpret_cast<const char*>(prefix.bytes.data()), prefix.bytes.size());
+		file.write(reinterpret_cast<const char*>(Internal::snapshot.data.data()), Internal::snapshot.data.size());
+		file.write(reinterpret_cast<const char*>(Internal::header.bytes.data()), Internal::header.bytes.size());
+		file.write(reinterpret_cast<const char*>(Internal::stream.bytes.data()), Internal::stream.bytes.size());
+		return file.good();
+	}
+
+	bool isRecording() {
+		return Internal::recordedScene != nullptr;
+	}
+
+	bool isRecording(const Scene* scene) {
+		return scene && Internal::recordedScene == scene;
+	}
+
+	size_t getStreamSize() {
+		return Internal::stream.bytes.size();
+	}
+
+	uint32_t getStepCount() {
+		return Internal::steps;
+	}
+
+	void recordStep(const Scene* scene, float dt) {
+		if (!isRecording(scene)) return;
+		if (dt == Internal::lastDt) {
+			Internal::stream.u8(static_cast<uint8_t>(Internal::Command::STEP_SAME_DT));
+		}
+		else {
+			Internal::stream.u8(static_cast<uint8_t>(Internal::Command::STEP));
+			Internal::stream.f32(dt);
+			Internal::lastDt = dt;
+		}
+		Internal::steps++;
+	}
+
+	void recordSpawn(const Scene* scene, GameObject* object) {
+		if (!isRecording(scene) || !object) return;
+
+		uint32_t id = Internal::nextId++;
+		Internal::ids[object] = id;
+
+		// Everything the prefab setup or the spawner changed before adding the object
+		auto physicsComponent = object->getComponent<PhysicsComponent>();
+		PxRigidActor* actor = physicsComponent ? physicsComponent->getActor() : nullptr;
+		PxRigidDynamic* dynamic = actor ? actor->is<PxRigidDynamic>() : nullptr;
+
+		Internal::stream.u8(static_cast<uint8_t>(Internal::Command::SPAWN));
+		Internal::stream.string(object->getName());
+		Internal::stream.pose(actor ? actor->getGlobalPose() : PxTransform(PxIdentity));
+		Internal::stream.vec3(object->getScale());
+		Internal::stream.f32(physicsComponent ? physicsComponent->getMass() : 0.0f);
+		PxVec3 linear = dynamic ? dynamic->getLinearVelocity() : PxVec3(0.0f);
+		PxVec3 angular = dynamic ? dynamic->getAngularVelocity() : PxVec3(0.0f);
+		Internal::stream.vec3(glm::vec3(linear.x, linear.y, linear.z));
+		Internal::stream.vec3(glm::vec3(angular.x, angular.y, angular.z));
+	}
+
+	void recordDestroy(GameObject* object) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::DESTROY, id);
+		Internal::ids.erase(object);
+	}
+
+	void recordForce(GameObject* object, const glm::vec3& force) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::FORCE, id);
+		Internal::stream.vec3(force);
+	}
+
+	void recordTorque(GameObject* object, const glm::vec3& torque) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::TORQUE, id);
+		Internal::stream.vec3(torque);
+	}
+
+	void recordLinearVelocity(GameObject* object, const glm::vec3& velocity) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::LINEAR_VELOCITY, id);
+		Internal::stream.vec3(velocity);
+	}
+
+	void recordAngularVelocity(GameObject* object, const glm::vec3& velocity) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::ANGULAR_VELOCITY, id);
+		Internal::stream.vec3(velocity);
+	}
+
+	void recordMass(GameObject* object, float mass) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::MASS, id);
+		Internal::stream.f32(mass);
+	}
+
+	void recordPose(GameObject* object, const PxTransform& pose) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::POSE, id);
+		Internal::stream.pose(pose);
+	}
+
+	void recordKinematicTarget(GameObject* object, const PxTransform& pose) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::KINEMATIC_TARGET, id);
+		Internal::stream.pose(pose);
+	}
+
+	void recordScale(GameObject* object, const glm::vec3& scale) {
+		uint32_t id;
+		if (!Internal::findId(object, id)) return;
+		Internal::command(Internal::Command::SCALE, id);
+		Internal::stream.vec3(scale);
+	}
+
+	bool replay(const std::string& path, ReplayResult& result) {
+		result = ReplayResult();
+
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			std::cerr << "Failed to open physics recording file: " << path << std::endl;
+			return false;
+		}
+		std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+		file.seekg(0, std::ios::beg);
+		file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+
+		Internal::Reader prefix{ bytes.data(), bytes.size() };
+		if (prefix.u32() != Internal::magic || prefix.u32() != Internal::version) {
+			std::cerr << "Not a physics recording: " << path << std::endl;
+			return false;
+		}
+		if (prefix.u32() != PX_PHYSICS_VERSION) {
+			std::cerr << "Physics recording was made with another PhysX version" << std::endl;
+			return false;
+		}
+		bool enhancedDeterminism = prefix.u32() != 0;
+		PhysicsSnapshot snapshot;
+		snapshot.nbActors = prefix.u32();
+		uint32_t snapshotSize = prefix.u32();
+		uint32_t headerSize = prefix.u32();
+		uint32_t streamSize = prefix.u32();
+		if (prefix.failed || prefix.offset + snapshotSize + headerSize + streamSize > bytes.size()) {
+			std::cerr << "Truncated physics recording: " << path << std::endl;
+			return false;
+		}
+		const uint8_t* cursor = bytes.data() + prefix.offset;
+		snapshot.data.assign(cursor, cursor + snapshotSize);
+		Internal::Reader header{ cursor + snapshotSize, headerSize };
+		Internal::Reader stream{ cursor + snapshotSize + headerSize, streamSize };
+
+		Physics::SceneConfig config;
+		config.enhancedDeterminism = enhancedDeterminism;
+		Scene scene(config);
+		// physics.json may force the flag on every scene
+		if (((scene.getPhysicsScene()->getScene()->getFlags() & PxSceneFlag::eENABLE_ENHANCED_DETERMINISM) != 0) != enhancedDeterminism) {
+			std::cerr << "PhysicsRecorder: replay scene and recording differ in enhanced determinism, the replay may diverge" << std::endl;
+		}
+		std::vector<std::shared_ptr<GameObject>> byId;
+		std::vector<GameObjectHandle> recordedHandles;
+		// Replayed objects and spawns live in the replay scene memory
+		SceneMemory::Scope memoryScope(scene.getMemory());
+
+		// Same objects, same order and same component kinds as the recorded scene,
+		// the snapshot then swaps in the recorded actors
+		uint32_t nbObjects = header.varint();
+		for (uint32_t i = 0; i < nbObjects && !header.failed; i++) {
+			auto kind = static_cast<Internal::ObjectKind>(header.u8());
+			auto type = header.u8() ? PhysicsComponent::Type::DYNAMIC : PhysicsComponent::Type::STATIC;
+			std::string name = header.string();
+			glm::vec3 position = header.vec3();
+			float qx = header.f32(), qy = header.f32(), qz = header.f32(), qw = header.f32();
+			glm::vec3 scale = header.vec3();
+			GameObjectHandle recordedHandle;
+			recordedHandle.index = header.u32();
+			recordedHandle.generation = header.u32();
+			float mass = header.f32();
+
+			auto object = GameObject::create(name.c_str());
+			object->setPosition(position, false);
+			object->setRotationQuaternion(glm::quat(qw, qx, qy, qz), false);
+			object->setScale(scale);
+			switch (kind) {
+			case Internal::ObjectKind::CUBE: object->addComponent<CubePhysics>(type); break;
+			case Internal::ObjectKind::SPHERE: object->addComponent<SpherePhysics>(type); break;
+			case Internal::ObjectKind::OTHER: object->addComponent<PhysicsComponent>(type); break;
+			default: break;
+			}
+			// The actor comes from the snapshot, the component still needs the mass later rescales use
+			if (auto physicsComponent = object->getComponent<PhysicsComponent>())
+				physicsComponent->setMass(mass);
+			scene.addGameObject(object);
+			byId.push_back(object);
+			recordedHandles.push_back(recordedHandle);
+		}
+		if (header.failed || !PhysicsSerialization::load(*scene.getPhysicsScene(), byId, snapshot, &recordedHandles)) {
+			std::cerr << "Physics recording initial state could not be restored" << std::endl;
+			scene.clearGameObjects();
+			scene.getPhysicsScene()->shutdown();
+			return false;
+		}
+
+		auto componentOf = [&](uint32_t id) -> std::shared_ptr<PhysicsComponent> {
+			if (id >= byId.size() || !byId[id]) return nullptr;
+			return byId[id]->getComponent<PhysicsComponent>();
+		};
+
+		float dt = 1.0f / 60.0f;
+		while (!stream.atEnd()) {
+			auto command = static_cast<Internal::Command>(stream.u8());
+			if (command == Internal::Command::STEP || command == Internal::Command::STEP_SAME_DT) {
+				if (command == Internal::Command::STEP)
+					dt = stream.f32();
+				scene.update(dt);
+				result.stepMs.push_back(scene.getPhysicsScene()->getStats().getLast().totalMs);
+				result.steps++;
+				continue;
+			}
+
+			if (command == Internal::Command::SPAWN) {
+				std::string name = stream.string();
+				PxTransform pose = stream.pose();
+				glm::vec3 scale = stream.vec3();
+				float mass = stream.f32();
+				glm::vec3 linear = stream.vec3();
+				glm::vec3 angular = stream.vec3();
+
+				std::shared_ptr<GameObject> object = PrefabManager::hasPrefab(name) ? PrefabManager::instantiate(name) : nullptr;
+				byId.push_back(object);
+				if (!object) {
+					result.skippedCommands++;
+					continue;
+				}
+				object->setScale(scale);
+				if (auto physicsComponent = object->getComponent<PhysicsComponent>()) {
+					physicsComponent->getActor()->setGlobalPose(pose);
+					physicsComponent->updateTransform();
+					physicsComponent->setMass(mass);
+					physicsComponent->setLinearVelocity(linear);
+					physicsComponent->setAngularVelocity(angular);
+				}
+				scene.addGameObject(object);
+				continue;
+			}
+
+			uint32_t id = stream.varint();
+			auto physicsComponent = componentOf(id);
+			switch (command) {
+			case Internal::Command::DESTROY:
+				if (id < byId.size() && byId[id]) {
+					scene.destroyGameObject(byId[id]);
+					byId[id].reset();
+				}
+				else result.skippedCommands++;
+				break;
+			case Internal::Command::FORCE: {
+				glm::vec3 v = stream.vec3();
+				if (physicsComponent) physicsComponent->applyForce(v); else result.skippedCommands++;
+				break;
+			}
+			case Internal::Command::TORQUE: {
+				glm::vec3 v = stream.vec3();
+				if (physicsComponent) physicsComponent->applyTorque(v); else result.skippedCommands++;
+				break;
+			}
+			case Internal::Command::LINEAR_VELOCITY: {
+				glm::vec3 v = stream.vec3();
+				if (physicsComponent) physicsComponent->setLinearVelocity(v); else result.skippedCommands++;
+				break;
+			}
+			case Internal::Command::ANGULAR_VELOCITY: {
+				glm::vec3 v = stream.vec3();
+				if (physicsComponent) physicsComponent->setAngularVelocity(v); else result.skippedCommands++;
+				break;
+			}
+			case Internal::Command::MASS: {
+				float mass = stream.f32();
+				if (physicsComponent) physicsComponent->setMass(mass); else result.skippedCommands++;
+				break;
+			}
+			case Internal::Command::POSE: {
+				PxTransform pose = stream.pose();
+				if (physicsComponent && physicsComponent->getActor()) {
+					physicsComponent->getActor()->setGlobalPose(pose);
+					physicsComponent->updateTransform();
+				}
+				else result.skippedCommands++;
+				break;
+			}
+			case Internal::Command::KINEMATIC_TARGET: {
+				PxTransform pose = stream.pose();
+				PxRigidDynamic* dynamic = physicsComponent && physicsComponent->getActor()
+					? physicsComponent->getActor()->is<PxRigidDynamic>() : nullptr;
+				// Reached during the next step, the POST_PHYSICS copy brings it to the object
+				if (dynamic && dynamic->getRigidBodyFlags().isSet(PxRigidBodyFlag::eKINEMATIC))
+					dynamic->setKinematicTarget(pose);
+				else result.skippedCommands++;
+				break;
+			}
+			case Internal::Command::SCALE: {
+				glm::vec3 scale = stream.vec3();
+				if (id < byId.size() && byId[id]) byId[id]->setScale(scale); else result.skippedCommands++;
+				break;
+			}
+			default:
+				std::cerr << "Corrupted physics recording at byte " << stream.offset << std::endl;
+				stream.failed = true;
+				break;
+			}
+		}
+
+		result.stateHash = 14695981039346656037ull;
+		for (auto& object : byId) {
+			auto physicsComponent = object ? object->getComponent<PhysicsComponent>() : nullptr;
+			if (!physicsComponent || !physicsComponent->getActor()) continue;
+			PxTransform pose = physicsComponent->getActor()->getGlobalPose();
+			Internal::fnv1a(result.stateHash, &pose, sizeof(pose));
+		}
+
+		// Actors go before their scene
+		byId.clear();
+		scene.clearGameObjects();
+		scene.getPhysicsScene()->shutdown();
+		return !stream.failed;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "Physics.hpp"
+
+class Scene;
+class GameObject;
+
+// Logs every physics affecting command of a Scene (prefab spawns, destroys, forces,
+// velocity / mass changes, editor pose and scale edits) between simulation steps
+// into a compact binary stream. A recording starts with a PhysicsSnapshot of the
+// scene, so a headless replay rebuilds the same world and feeds the same commands
+// at the same steps. The replay scene gets the enhanced determinism setting of the
+// recorded one; with SceneConfig::enhancedDeterminism (or the physics.json switch)
+// replays match bit for bit.
+namespace PhysicsRecorder
+{
+	// Captures the initial state of `scene`. The live scene is restored from that
+	// capture right away, so recording and replay start from the same actor order.
+	bool start(Scene* scene);
+	// Ends the recording and writes it, an empty path drops it
+	bool stop(const std::string& path);
+	bool isRecording();
+	bool isRecording(const Scene* scene);
+
+	// Size of the command stream recorded so far, in bytes
+	size_t getStreamSize();
+	uint32_t getStepCount();
+
+	// Hooks, no-ops unless the object belongs to the scene being recorded
+	void recordStep(const Scene* scene, float dt);
+	void recordSpawn(const Scene* scene, GameObject* object);
+	void recordDestroy(GameObject* object);
+	void recordForce(GameObject* object, const glm::vec3& force);
+	void recordTorque(GameObject* object, const glm::vec3& torque);
+	void recordLinearVelocity(GameObject* object, const glm::vec3& velocity);
+	void recordAngularVelocity(GameObject* object, const glm::vec3& velocity);
+	void recordMass(GameObject* object, float mass);
+	void recordPose(GameObject* object, const PxTransform& pose);
+	// Moves of a kinematic body, replayed through setKinematicTarget like the live write
+	void recordKinematicTarget(GameObject* object, const PxTransform& pose);
+	void recordScale(GameObject* object, const glm::vec3& scale);
+
+	struct ReplayResult {
+		uint32_t steps = 0;
+		std::vector<double> stepMs;     // simulate + fetchResults of every step
+		uint32_t skippedCommands = 0;   // commands on objects the replay could not rebuild
+		uint64_t stateHash = 0;         // FNV-1a of every actor pose after the last step
+	};
+
+	// Replays a recording in a fresh headless Scene, needs Engine::initHeadless.
+	// Two runs of the same file on the same build give the same stateHash.
+	bool replay(const std::string& path, ReplayResult& result);
+}
@@ -0,0 +1,67 @@
+#include "PhysicsScene.hpp"
+#include "PhysicsComponents/PhysicsComponent.hpp"
+
+
+void PhysicsScene::queuePose(PhysicsComponent* component) {
+	std::lock_guard<std::mutex> lock(m_poseMutex);
+	if (component->poseQueue.load(std::memory_order_relaxed)) {
+		m_pendingCoalesced++;
+		return;
+	}
+	component->poseQueue.store(this, std::memory_order_release);
+	m_poses.push_back(component);
+}
+
+void PhysicsScene::cancelPose(PhysicsComponent* component) {
+	std::lock_guard<std::mutex> lock(m_poseMutex);
+	if (component->poseQueue.load(std::memory_order_relaxed) != this) return;
+	component->poseQueue.store(nullptr, std::memory_order_release);
+	// Queues are short, the slot is left empty rather than moving the others
+	std::replace(m_poses.begin(), m_poses.end(), component, static_cast<PhysicsComponent*>(nullptr));
+}
+
+size_t PhysicsScene::flushPoses() {
+	std::vector<PhysicsComponent*> poses;
+	{
+		std::lock_guard<std::mutex> lock(m_poseMutex);
+		poses.swap(m_poses);
+		for (PhysicsComponent* component : poses) {
+			if (component) component->poseQueue.store(nullptr, std::memory_order_release);
+		}
+		m_stepCoalesced += m_pendingCoalesced;
+		m_pendingCoalesced = 0;
+	}
+
+	size_t written = 0;
+	for (PhysicsComponent* component : poses) {
+		if (!component) continue;
+		component->updatePhysX();
+		written++;
+	}
+
+	// Keep the capacity for the next frame
+	std::lock_guard<std::mutex> lock(m_poseMutex);
+	m_stepFlushed += written;
+	if (m_poses.empty()) {
+		poses.clear();
+		m_poses.swap(poses);
+	}
+	return written;
+}
+
+void PhysicsScene::dropPoses() {
+	std::lock_guard<std::mutex> lock(m_poseMutex);
+	for (PhysicsComponent* component : m_poses) {
+		if (component) component->poseQueue.store(nullptr, std::memory_order_release);
+	}
+	m_poses.clear();
+	m_pendingCoalesced = 0;
+}
+
+void PhysicsScene::publishPoseStats() {
+	std::lock_guard<std::mutex> lock(m_poseMutex);
+	m_flushedPoses = m_stepFlushed;
+	m_coalescedPoses = m_stepCoalesced;
+	m_stepFlushed = 0;
+	m_stepCoalesced = 0;
+}
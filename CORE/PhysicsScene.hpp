@@ -1,21 +1,125 @@
 #pragma once
 #include <memory>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <mutex>
 #include "Physics.hpp"
+#include "PhysicsStats.hpp"
+#include "PhysicsEvents.hpp"
+
+class PhysicsComponent;
 
 class PhysicsScene {
 public:
-	void init() { m_scene = Physics::createScene(); }
+	void init(const Physics::SceneConfig& config = Physics::SceneConfig{}) {
+		m_config = config;
+		m_gravity = config.gravity;
+		m_scene = Physics::createScene(config);
+		// Components find the queue of the scene their actor is in
+		m_scene->userData = this;
+		m_events.setCapacity(config.maxEventsPerStep);
+		m_scene->setSimulationEventCallback(&m_events);
+
+		static int sceneCount = 0;
+		const std::string& csvPath = Physics::getConfig().statsCsvPath;
+		if (!csvPath.empty())
+			m_stats.startCsv(sceneCount == 0 ? csvPath : csvPath + "." + std::to_string(sceneCount));
+		sceneCount++;
+	}
 
 	void update(float dt) {
+		using namespace std::chrono;
+		flushPoses();
+		publishPoseStats();
+		high_resolution_clock::time_point start = high_resolution_clock::now();
 		m_scene->simulate(dt);
+		high_resolution_clock::time_point simulated = high_resolution_clock::now();
 		m_scene->fetchResults(true);
+		high_resolution_clock::time_point fetched = high_resolution_clock::now();
 
+		m_stats.record(m_scene,
+			duration<double, std::milli>(simulated - start).count(),
+			duration<double, std::milli>(fetched - simulated).count());
+
+		// Listeners run outside fetchResults, they may touch the scene
+		m_events.dispatch();
 	}
 
-	void shutdown() { m_scene->release(); }
+	~PhysicsScene() { dropPoses(); }
+
+	void shutdown() {
+		dropPoses();
+		for (PxAggregate* aggregate : m_aggregates) aggregate->release();
+		m_aggregates.clear();
+		PxCpuDispatcher* dispatcher = m_scene->getCpuDispatcher();
+		m_scene->release();
+		if (dispatcher != Physics::getJobDispatcher())
+			static_cast<PxDefaultCpuDispatcher*>(dispatcher)->release();
+	}
 
 	void addActor(PxRigidActor* actor) { m_scene->addActor(*actor); }
 
+	// One call for a batch of actors, PhysX inserts them in the broadphase together
+	void addActors(const std::vector<PxRigidActor*>& actors) {
+		std::vector<PxActor*> batch(actors.begin(), actors.end());
+		m_scene->addActors(batch.data(), static_cast<PxU32>(batch.size()));
+	}
+
+	// Batch removal, actors in an aggregate leave it first
+	void removeActors(const std::vector<PxRigidActor*>& actors) {
+		std::vector<PxActor*> batch;
+		batch.reserve(actors.size());
+		for (PxRigidActor* actor : actors) {
+			// Leaving an aggregate puts the actor back in the scene on its own
+			if (PxAggregate* aggregate = actor->getAggregate())
+				aggregate->removeActor(*actor);
+			if (actor->getScene() == m_scene)
+				batch.push_back(actor);
+		}
+		if (!batch.empty())
+			m_scene->removeActors(batch.data(), static_cast<PxU32>(batch.size()));
+		releaseEmptyAggregates();
+	}
+
+	// Groups the actors in PxAggregates: the broadphase sees one bound per aggregate,
+	// pairs inside it only exist when selfCollision is on. Returns the aggregate count.
+	size_t addAggregate(const std::vector<PxRigidActor*>& actors, bool selfCollision = true) {
+		releaseEmptyAggregates();
+
+		// Older PhysX builds cap aggregates at 128 actors, bigger groups are split
+		const size_t maxActorsPerAggregate = 128;
+		size_t created = 0;
+		for (size_t begin = 0; begin < actors.size(); begin += maxActorsPerAggregate) {
+			size_t end = std::min(begin + maxActorsPerAggregate, actors.size());
+			PxU32 nbShapes = 0;
+			for (size_t i = begin; i < end; i++) nbShapes += actors[i]->getNbShapes();
+
+			PxAggregate* aggregate = Physics::getPhysics()->createAggregate(static_cast<PxU32>(end - begin), nbShapes,
+				PxGetAggregateFilterHint(PxAggregateType::eGENERIC, selfCollision));
+			if (!aggregate) {
+				std::cerr << "Failed to create aggregate, adding the actors one by one" << std::endl;
+				for (size_t i = begin; i < end; i++) m_scene->addActor(*actors[i]);
+				continue;
+			}
+			for (size_t i = begin; i < end; i++) aggregate->addActor(*actors[i]);
+			m_scene->addAggregate(*aggregate);
+			m_aggregates.push_back(aggregate);
+			created++;
+		}
+		return created;
+	}
+
+	// Aggregates stay in the scene when their actors are released, drop the empty ones
+	void releaseEmptyAggregates() {
+		m_aggregates.erase(std::remove_if(m_aggregates.begin(), m_aggregates.end(), [](PxAggregate* aggregate) {
+			if (aggregate->getNbActors() > 0) return false;
+			aggregate->release();
+			return true;
+		}), m_aggregates.end());
+	}
+
 	void setGravity(float gravityx, float gravityy, float gravityz) {
 		m_gravity = glm::vec3(gravityx, gravityy, gravityz);
 		m_scene->setGravity(PxVec3(gravityx, gravityy, gravityz));
@@ -25,8 +129,41 @@ public:
 	glm::vec3 getGravity() { return m_gravity; }
 
 	PxScene* getScene() { return m_scene; }
+	PhysicsStats& getStats() { return m_stats; }
+	PhysicsEventCollector& getEvents() { return m_events; }
+	const Physics::SceneConfig& getConfig() const { return m_config; }
+
+	// Pose write-back: gameplay moves of bodies in this scene are queued once per component
+	// (a component moved several times in a frame is written once, with its last pose) and
+	// written to PhysX in one pass before the step. May be called from component update workers.
+	void queuePose(PhysicsComponent* component);
+	// The component is going away, its pending write is dropped
+	void cancelPose(PhysicsComponent* component);
+	// Writes every queued pose, returns the number of bodies written. update() calls it first.
+	size_t flushPoses();
+	// Bodies written before the last step and the moves merged into those writes
+	size_t getFlushedPoseCount() const { return m_flushedPoses; }
+	size_t getCoalescedPoseCount() const { return m_coalescedPoses; }
+
 private:
 	PxScene* m_scene;
 	glm::vec3 m_gravity;
+	Physics::SceneConfig m_config;
+	PhysicsStats m_stats;
+	PhysicsEventCollector m_events;
+	std::vector<PxAggregate*> m_aggregates;
+
+	// Forgets the queued writes without touching the actors
+	void dropPoses();
+	// Step totals of the flushes since the previous step become the reported counts
+	void publishPoseStats();
+
+	std::mutex m_poseMutex;
+	std::vector<PhysicsComponent*> m_poses;
+	size_t m_pendingCoalesced = 0;
+	size_t m_stepFlushed = 0;
+	size_t m_stepCoalesced = 0;
+	size_t m_flushedPoses = 0;
+	size_t m_coalescedPoses = 0;
 
 };
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "PhysicsSnapshot.hpp"
+#include "PhysicsComponents/PhysicsComponent.hpp"
+#include <fstream>
+#include <new>
+#include <cstring>
+#include <unordered_set>
+#include <iostream>
+
+
+namespace PhysicsSerialization {
+
+	namespace Internal {
+		// Objects are found by handle, not list position: the list is compacted on destroy.
+		// The generation is stored plus one so no id is 0 (PX_SERIAL_OBJECT_ID_INVALID).
+		inline PxSerialObjectId objectId(GameObjectHandle handle) {
+			return (static_cast<PxSerialObjectId>(handle.generation) + 1) << 32 | handle.index;
+		}
+
+		void* allocateBlock(size_t size) {
+			return ::operator new(size, std::align_val_t(PX_SERIAL_FILE_ALIGN));
+		}
+
+		void freeBlock(void* block) {
+			::operator delete(block, std::align_val_t(PX_SERIAL_FILE_ALIGN));
+		}
+	}
+
+	bool save(const std::vector<std::shared_ptr<GameObject>>& objects, PhysicsSnapshot& out) {
+		PxSerializationRegistry* registry = Physics::getSerializationRegistry();
+		PxCollection* collection = PxCreateCollection();
+
+		uint32_t nbActors = 0;
+		for (const auto& object : objects) {
+			// Objects outside a scene have no handle to find them by
+			if (!object || object->getHandle().isNull()) continue;
+			auto physicsComponent = object->getComponent<PhysicsComponent>();
+			if (physicsComponent && physicsComponent->getActor()) {
+				collection->add(*physicsComponent->getActor(), Internal::objectId(object->getHandle()));
+				nbActors++;
+			}
+		}
+
+		// Pull in the shapes and materials the actors reference
+		PxSerialization::complete(*collection, *registry);
+
+		PxDefaultMemoryOutputStream stream;
+		bool ok = PxSerialization::serializeCollectionToBinary(stream, *collection, *registry);
+		collection->release();
+
+		if (!ok) {
+			std::cerr << "Physics snapshot serialization failed" << std::endl;
+			return false;
+		}
+
+		out.data.assign(stream.getData(), stream.getData() + stream.getSize());
+		out.nbActors = nbActors;
+		std::cout << "Physics snapshot saved: " << out.data.size() << " bytes" << std::endl;
+		return true;
+	}
+
+	bool load(PhysicsScene& scene, const std::vector<std::shared_ptr<GameObject>>& objects, const PhysicsSnapshot& snapshot,
+		const std::vector<GameObjectHandle>* capturedHandles) {
+		if (snapshot.empty()) return false;
+
+		// Deserialization patches pointers in place, so every load works on a fresh copy. The
+		// block is freed with the last component still using an actor or material from it.
+		std::shared_ptr<void> block(Internal::allocateBlock(snapshot.data.size()), Internal::freeBlock);
+		std::memcpy(block.get(), snapshot.data.data(), snapshot.data.size());
+
+		PxCollection* collection = PxSerialization::createCollectionFromBinary(block.get(), *Physics::getSerializationRegistry());
+		if (!collection) {
+			std::cerr << "Physics snapshot deserialization failed" << std::endl;
+			return false;
+		}
+
+		// Swap the new actors in, this releases the ones currently in the scene
+		std::unordered_set<PxRigidActor*> bound;
+		for (size_t i = 0; i < objects.size(); i++) {
+			const auto& object = objects[i];
+			if (!object) continue;
+			GameObjectHandle handle = capturedHandles ? (*capturedHandles)[i] : object->getHandle();
+			if (handle.isNull()) continue;
+			PxBase* serialized = collection->find(Internal::objectId(handle));
+			auto physicsComponent = object->getComponent<PhysicsComponent>();
+			if (!serialized || !physicsComponent) continue;
+
+			if (PxRigidActor* actor = serialized->is<PxRigidActor>()) {
+				physicsComponent->rebindActor(actor, block);
+				bound.insert(actor);
+			}
+		}
+
+		// Actors of destroyed objects would be colliders nobody owns, they stay out of the scene
+		std::vector<PxRigidActor*> orphans;
+		for (PxU32 i = 0; i < collection->getNbObjects(); i++) {
+			PxRigidActor* actor = collection->getObject(i).is<PxRigidActor>();
+			if (actor && !bound.count(actor)) orphans.push_back(actor);
+		}
+		std::vector<PxShape*> shapes;
+		for (PxRigidActor* actor : orphans) {
+			// Their shapes go with them, the collection must not point at those either
+			shapes.resize(actor->getNbShapes());
+			actor->getShapes(shapes.data(), static_cast<PxU32>(shapes.size()));
+			for (PxShape* shape : shapes) {
+				if (collection->contains(*shape)) collection->remove(*shape);
+			}
+			collection->remove(*actor);
+			actor->release();
+		}
+		if (!orphans.empty()) {
+			std::cerr << "Physics snapshot: " << orphans.size() << " of " << snapshot.nbActors
+				<< " actors have no object anymore, released" << std::endl;
+		}
+
+		scene.getScene()->addCollection(*collection);
+
+		// Components took their own reference on the materials they use
+		for (PxU32 i = 0; i < collection->getNbObjects(); i++) {
+			if (PxMaterial* material = collection->getObject(i).is<PxMaterial>()) {
+				material->release();
+			}
+		}
+		collection->release();
+
+		for (auto& object : objects) {
+			if (!object) continue;
+			if (auto physicsComponent = object->getComponent<PhysicsComponent>()) {
+				physicsComponent->updateTransform();
+			}
+		}
+		return !bound.empty() || snapshot.nbActors == 0;
+	}
+
+	bool saveToFile(const PhysicsSnapshot& snapshot, const std::string& path) {
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "Failed to open physics snapshot file: " << path << std::endl;
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&snapshot.nbActors), sizeof(snapshot.nbActors));
+		file.write(reinterpret_cast<const char*>(snapshot.data.data()), snapshot.data.size());
+		return file.good();
+	}
+
+	bool loadFromFile(const std::string& path, PhysicsSnapshot& out) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			std::cerr << "Failed to open physics snapshot file: " << path << std::endl;
+			return false;
+		}
+
+		std::streamsize size = file.tellg();
+		if (size < static_cast<std::streamsize>(sizeof(out.nbActors)))
+			return false;
+
+		file.seekg(0, std::ios::beg);
+		file.read(reinterpret_cast<char*>(&out.nbActors), sizeof(out.nbActors));
+		out.data.resize(static_cast<size_t>(size) - sizeof(out.nbActors));
+		file.read(reinterpret_cast<char*>(out.data.data()), out.data.size());
+		return file.good();
+	}
+}
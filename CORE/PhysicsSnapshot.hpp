@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include "PhysicsScene.hpp"
+#include "GameObject.hpp"
+
+// Binary image of every actor / shape / material owned by a list of GameObjects.
+// Restoring copies the bytes into a fresh 128 byte aligned block and lets PhysX
+// fix up the pointers in place, no actor is rebuilt through the prefab setup.
+struct PhysicsSnapshot {
+	std::vector<PxU8> data;
+	uint32_t nbActors = 0; // actors captured
+
+	bool empty() const { return data.empty(); }
+};
+
+namespace PhysicsSerialization
+{
+	// Objects are identified by their GameObjectHandle, objects outside a scene are skipped.
+	// Load rebinds the actors of the objects still alive and releases the others.
+	bool save(const std::vector<std::shared_ptr<GameObject>>& objects, PhysicsSnapshot& out);
+	// `capturedHandles[i]` replaces the handle of objects[i] when set, for objects rebuilt in
+	// another scene (a replay) under other handles
+	bool load(PhysicsScene& scene, const std::vector<std::shared_ptr<GameObject>>& objects, const PhysicsSnapshot& snapshot,
+		const std::vector<GameObjectHandle>* capturedHandles = nullptr);
+
+	bool saveToFile(const PhysicsSnapshot& snapshot, const std::string& path);
+	bool loadFromFile(const std::string& path, PhysicsSnapshot& out);
+}
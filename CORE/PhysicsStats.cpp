@@ -0,0 +1,184 @@
+#include "PhysicsStats.hpp"
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <iostream>
+
+
+namespace PhysicsProfiler {
+
+	namespace Internal {
+		enum Phase { BROAD_PHASE, NARROW_PHASE, SOLVER, PHASE_COUNT, NONE = PHASE_COUNT };
+
+		// One slot per scene context, scenes are few so a linear probe is enough
+		struct ContextSlot {
+			std::atomic<uint64_t> contextId{ 0 };
+			std::atomic<uint64_t> nanos[PHASE_COUNT] = {};
+		};
+		const size_t maxContexts = 64;
+		ContextSlot slots[maxContexts];
+
+		bool installed = false;
+
+		// Nested zones of the same phase only count once per thread
+		thread_local int depth[PHASE_COUNT] = {};
+
+		bool containsNoCase(const char* text, const char* pattern) {
+			for (; *text; text++) {
+				const char* t = text;
+				const char* p = pattern;
+				while (*t && *p && std::tolower(static_cast<unsigned char>(*t)) == *p) { t++; p++; }
+				if (!*p) return true;
+			}
+			return false;
+		}
+
+		Phase classify(const char* eventName) {
+			if (!eventName) return NONE;
+			if (containsNoCase(eventName, "broadphase")) return BROAD_PHASE;
+			if (containsNoCase(eventName, "narrowphase")) return NARROW_PHASE;
+			if (containsNoCase(eventName, "solve")) return SOLVER;
+			return NONE;
+		}
+
+		ContextSlot* findSlot(uint64_t contextId, bool create) {
+			// contextId 0 is used as the empty marker, shift it
+			uint64_t key = contextId + 1;
+			for (size_t i = 0; i < maxContexts; i++) {
+				ContextSlot& slot = slots[(key + i) % maxContexts];
+				uint64_t current = slot.contextId.load(std::memory_order_acquire);
+				if (current == key) return &slot;
+				if (current == 0) {
+					if (!create) return nullptr;
+					uint64_t expected = 0;
+					if (slot.contextId.compare_exchange_strong(expected, key) || expected == key)
+						return &slot;
+				}
+			}
+			return nullptr;
+		}
+
+		uint64_t nowNanos() {
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+
+		class ZoneCallback : public PxProfilerCallback {
+		public:
+			void* zoneStart(const char* eventName, bool detached, uint64_t contextId) override {
+				Phase phase = classify(eventName);
+				if (detached || phase == NONE) return nullptr;
+				if (depth[phase]++ > 0) return nullptr;
+				return reinterpret_cast<void*>(static_cast<uintptr_t>(nowNanos()));
+			}
+
+			void zoneEnd(void* profilerData, const char* eventName, bool detached, uint64_t contextId) override {
+				Phase phase = classify(eventName);
+				if (detached || phase == NONE) return;
+				depth[phase]--;
+				if (!profilerData) return;
+
+				uint64_t elapsed = nowNanos() - static_cast<uint64_t>(reinterpret_cast<uintptr_t>(profilerData));
+				if (ContextSlot* slot = findSlot(contextId, true))
+					slot->nanos[phase].fetch_add(elapsed, std::memory_order_relaxed);
+			}
+		};
+
+		ZoneCallback callback;
+
+		// Reads and resets the accumulated phase times of a scene, in milliseconds
+		void consume(uint64_t contextId, double outMs[PHASE_COUNT]) {
+			ContextSlot* slot = findSlot(contextId, false);
+			for (int i = 0; i < PHASE_COUNT; i++) {
+				outMs[i] = slot ? slot->nanos[i].exchange(0) / 1.0e6 : 0.0;
+			}
+		}
+	}
+
+	void install() {
+		PxSetProfilerCallback(&Internal::callback);
+		Internal::installed = true;
+	}
+
+	void uninstall() {
+		if (!Internal::installed) return;
+		PxSetProfilerCallback(nullptr);
+		Internal::installed = false;
+	}
+
+	bool isInstalled() {
+		return Internal::installed;
+	}
+}
+
+
+void PhysicsStats::record(PxScene* scene, double simulateMs, double fetchResultsMs) {
+	PhysicsStepStats stats;
+	stats.step = m_last.step + 1;
+	stats.simulateMs = simulateMs;
+	stats.fetchResultsMs = fetchResultsMs;
+	stats.totalMs = simulateMs + fetchResultsMs;
+
+	if (PhysicsProfiler::isInstalled()) {
+		double phases[PhysicsProfiler::Internal::PHASE_COUNT];
+		PhysicsProfiler::Internal::consume(scene->getContextId(), phases);
+		stats.broadPhaseMs = phases[PhysicsProfiler::Internal::BROAD_PHASE];
+		stats.narrowPhaseMs = phases[PhysicsProfiler::Internal::NARROW_PHASE];
+		stats.solverMs = phases[PhysicsProfiler::Internal::SOLVER];
+	}
+
+	PxSimulationStatistics px;
+	scene->getSimulationStatistics(px);
+	stats.activeDynamicBodies = px.nbActiveDynamicBodies;
+	stats.activeKinematicBodies = px.nbActiveKinematicBodies;
+	stats.dynamicBodies = px.nbDynamicBodies;
+	stats.staticBodies = px.nbStaticBodies;
+	stats.aggregates = px.nbAggregates;
+	stats.activeConstraints = px.nbActiveConstraints;
+	stats.broadPhaseAdds = px.nbBroadPhaseAdds;
+	stats.broadPhaseRemoves = px.nbBroadPhaseRemoves;
+	stats.newPairs = px.nbNewPairs;
+	stats.lostPairs = px.nbLostPairs;
+	stats.newTouches = px.nbNewTouches;
+	stats.lostTouches = px.nbLostTouches;
+	stats.contactPairs = px.nbDiscreteContactPairsTotal;
+	stats.contactPairsWithContacts = px.nbDiscreteContactPairsWithContacts;
+	stats.contactPairsCacheHits = px.nbDiscreteContactPairsWithCacheHits;
+	stats.partitions = px.nbPartitions;
+
+	m_last = stats;
+	m_history[m_head] = stats;
+	m_head = (m_head + 1) % m_history.size();
+
+	if (m_csv.is_open()) {
+		m_csv << stats.step << ',' << stats.simulateMs << ',' << stats.fetchResultsMs << ',' << stats.totalMs << ','
+			<< stats.broadPhaseMs << ',' << stats.narrowPhaseMs << ',' << stats.solverMs << ','
+			<< stats.activeDynamicBodies << ',' << stats.activeKinematicBodies << ','
+			<< stats.dynamicBodies << ',' << stats.staticBodies << ',' << stats.aggregates << ','
+			<< stats.activeConstraints << ',' << stats.broadPhaseAdds << ',' << stats.broadPhaseRemoves << ','
+			<< stats.newPairs << ',' << stats.lostPairs << ',' << stats.newTouches << ',' << stats.lostTouches << ','
+			<< stats.contactPairs << ',' << stats.contactPairsWithContacts << ',' << stats.contactPairsCacheHits << ','
+			<< stats.partitions << '\n';
+	}
+}
+
+bool PhysicsStats::startCsv(const std::string& path) {
+	stopCsv();
+	m_csv.open(path, std::ios::out | std::ios::trunc);
+	if (!m_csv.is_open()) {
+		std::cerr << "Failed to open physics stats file: " << path << std::endl;
+		return false;
+	}
+	m_csv << "step,simulate_ms,fetch_results_ms,total_ms,broadphase_ms,narrowphase_ms,solver_ms,"
+		"active_dynamic,active_kinematic,dynamic,static,aggregates,active_constraints,"
+		"bp_adds,bp_removes,new_pairs,lost_pairs,new_touches,lost_touches,"
+		"contact_pairs,contact_pairs_with_contacts,contact_pairs_cache_hits,partitions\n";
+	return true;
+}
+
+void PhysicsStats::stopCsv() {
+	if (m_csv.is_open()) {
+		m_csv.flush();
+		m_csv.close();
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include "Physics.hpp"
+
+// Counters and timings of a single PhysicsScene step
+struct PhysicsStepStats {
+	uint64_t step = 0;
+
+	// wall clock of our own calls
+	double simulateMs = 0.0;
+	double fetchResultsMs = 0.0;
+	double totalMs = 0.0;
+
+	// PhysX profiler zones (only filled when the profiler is installed, summed over worker threads)
+	double broadPhaseMs = 0.0;
+	double narrowPhaseMs = 0.0;
+	double solverMs = 0.0;
+
+	// PxSimulationStatistics
+	uint32_t activeDynamicBodies = 0;
+	uint32_t activeKinematicBodies = 0;
+	uint32_t dynamicBodies = 0;
+	uint32_t staticBodies = 0;
+	uint32_t aggregates = 0;
+	uint32_t activeConstraints = 0;
+	uint32_t broadPhaseAdds = 0;
+	uint32_t broadPhaseRemoves = 0;
+	uint32_t newPairs = 0;
+	uint32_t lostPairs = 0;
+	uint32_t newTouches = 0;
+	uint32_t lostTouches = 0;
+	uint32_t contactPairs = 0;              // discrete pairs going through narrow phase
+	uint32_t contactPairsWithContacts = 0;
+	uint32_t contactPairsCacheHits = 0;
+	uint32_t partitions = 0;                // solver partitions, PhysX does not expose the island count
+};
+
+// Per scene step history plus optional CSV dump for headless runs
+class PhysicsStats {
+public:
+	PhysicsStats(size_t historySize = 240) : m_history(historySize) {}
+	~PhysicsStats() { stopCsv(); }
+
+	// Called by PhysicsScene after fetchResults
+	void record(PxScene* scene, double simulateMs, double fetchResultsMs);
+
+	const PhysicsStepStats& getLast() const { return m_last; }
+	uint64_t getStepCount() const { return m_last.step; }
+
+	// Oldest to newest, at most historySize entries
+	template<typename Fn>
+	void forEachHistory(Fn&& fn) const {
+		size_t count = m_last.step < m_history.size() ? static_cast<size_t>(m_last.step) : m_history.size();
+		size_t start = (m_head + m_history.size() - count) % m_history.size();
+		for (size_t i = 0; i < count; i++) {
+			fn(m_history[(start + i) % m_history.size()]);
+		}
+	}
+
+	bool startCsv(const std::string& path);
+	void stopCsv();
+	bool isWritingCsv() const { return m_csv.is_open(); }
+
+private:
+	std::vector<PhysicsStepStats> m_history;
+	size_t m_head = 0;
+	PhysicsStepStats m_last;
+	std::ofstream m_csv;
+};
+
+// PxProfilerCallback that sums the broad phase / narrow phase / solver zones per scene context.
+// Zones are only emitted by profile and checked PhysX builds, and PVD replaces this callback when enabled.
+namespace PhysicsProfiler
+{
+	void install();
+	void uninstall();
+	bool isInstalled();
+}
@@ -0,0 +1,83 @@
+#include "PhysicsWorldStepper.hpp"
+#include "Jobs/JobSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+size_t PhysicsWorldStepper::addWorld(PhysicsScene* world, float stepRate) {
+	if (!world || stepRate <= 0.0f) {
+		std::cerr << "PhysicsWorldStepper: invalid world or step rate" << std::endl;
+		return m_worlds.size();
+	}
+
+	World entry;
+	entry.world = world;
+	entry.stepDt = 1.0f / stepRate;
+	m_worlds.push_back(entry);
+	return m_worlds.size() - 1;
+}
+
+void PhysicsWorldStepper::removeWorld(PhysicsScene* world) {
+	m_worlds.erase(std::remove_if(m_worlds.begin(), m_worlds.end(),
+		[world](const World& entry) { return entry.world == world; }), m_worlds.end());
+}
+
+void PhysicsWorldStepper::clear() {
+	m_worlds.clear();
+	m_time = 0.0;
+}
+
+void PhysicsWorldStepper::stepWorld(World& world) {
+	using namespace std::chrono;
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+
+	uint32_t steps = 0;
+	while (world.accumulator >= world.stepDt) {
+		if (m_maxStepsPerAdvance && steps == m_maxStepsPerAdvance) {
+			// Drop the backlog instead of falling further behind
+			world.accumulator = 0.0;
+			break;
+		}
+		world.world->update(world.stepDt);
+		world.accumulator -= world.stepDt;
+		world.timing.simulatedTime += world.stepDt;
+		steps++;
+	}
+
+	world.timing.steps = steps;
+	world.timing.totalSteps += steps;
+	world.timing.lastMs = duration<double, std::milli>(high_resolution_clock::now() - start).count();
+	world.timing.totalMs += world.timing.lastMs;
+}
+
+void PhysicsWorldStepper::advance(float dt) {
+	advanceTo(m_time + dt);
+}
+
+void PhysicsWorldStepper::advanceTo(double time) {
+	using namespace std::chrono;
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+
+	double dt = std::max(0.0, time - m_time);
+	for (World& world : m_worlds) {
+		world.accumulator += dt;
+	}
+
+	// One world per chunk: step counts differ between worlds, the atomic cursor balances them.
+	// parallelFor only returns once every world is done, that is the barrier.
+	if (JobSystem::isInitialized()) {
+		JobSystem::parallelFor(m_worlds.size(), 1, [this](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				stepWorld(m_worlds[i]);
+			}
+		});
+	}
+	else {
+		for (World& world : m_worlds) {
+			stepWorld(world);
+		}
+	}
+
+	m_time = std::max(m_time, time);
+	m_lastAdvanceMs = duration<double, std::milli>(high_resolution_clock::now() - start).count();
+}
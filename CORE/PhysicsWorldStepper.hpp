@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "PhysicsScene.hpp"
+
+// Advances many independent PhysicsScenes concurrently on the JobSystem pool.
+// Each world runs fixed steps at its own rate. A world is only ever stepped by one
+// thread at a time, so worlds meant for the stepper are best created with
+// SceneConfig::useJobSystem = false and dispatcherThreads = 0 and let the pool
+// provide the parallelism.
+class PhysicsWorldStepper {
+public:
+	struct WorldTiming {
+		uint32_t steps = 0;        // fixed steps taken during the last advance
+		double lastMs = 0.0;       // wall clock spent in the last advance
+		double totalMs = 0.0;
+		uint64_t totalSteps = 0;
+		double simulatedTime = 0.0; // seconds of simulation since the world was added
+	};
+
+	// Returns the world index, stepRate in Hz
+	size_t addWorld(PhysicsScene* world, float stepRate = 60.0f);
+	void removeWorld(PhysicsScene* world);
+	void clear();
+
+	// Caps the steps one world may take per advance so a slow world cannot spiral
+	void setMaxStepsPerAdvance(uint32_t maxSteps) { m_maxStepsPerAdvance = maxSteps; }
+
+	// Barrier: moves every world forward by dt seconds of simulation and returns
+	// once all of them are done. Worlds whose rate does not divide dt keep the
+	// remainder for the next call.
+	void advance(float dt);
+
+	// Barrier on an absolute time: steps every world until its next step would go past `time`
+	void advanceTo(double time);
+
+	size_t getWorldCount() const { return m_worlds.size(); }
+	PhysicsScene* getWorld(size_t index) { return m_worlds[index].world; }
+	const WorldTiming& getTiming(size_t index) const { return m_worlds[index].timing; }
+
+	// Wall clock of the last advance, from dispatch to barrier
+	double getLastAdvanceMs() const { return m_lastAdvanceMs; }
+	// Simulation time every world has reached at the last barrier
+	double getTime() const { return m_time; }
+
+private:
+	struct World {
+		PhysicsScene* world = nullptr;
+		float stepDt = 1.0f / 60.0f;
+		double accumulator = 0.0;
+		WorldTiming timing;
+	};
+
+	void stepWorld(World& world);
+
+	std::vector<World> m_worlds;
+	uint32_t m_maxStepsPerAdvance = 0; // 0 = unbounded
+	double m_lastAdvanceMs = 0.0;
+	double m_time = 0.0;
+};
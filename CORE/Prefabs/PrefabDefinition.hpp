@@ -7,6 +7,13 @@
 #include <glm/glm.hpp>
 #include "../GameObject.hpp"
 
+// Objects spawned together by a group prefab, not added to any scene yet
+struct PrefabGroup {
+    std::vector<std::shared_ptr<GameObject>> objects;
+    bool aggregate = false;       // add their actors as PxAggregates (Scene::addGameObjects)
+    bool selfCollision = true;    // bodies of the group collide with each other
+};
+
 class PrefabDefinition {
 public:
     std::string name;
@@ -14,9 +21,17 @@ public:
     glm::vec3 defaultRotation = glm::vec3(0.0f, 0.0f, 0.0f);
     glm::vec3 defaultScale = glm::vec3(1.0f, 1.0f, 1.0f);
 
+    // Physics actors kept ready for this prefab, see PrefabManager::warmPools
+    uint32_t poolSize = 0;
+
     // Setup function to add components and configure the object
     std::function<void(std::shared_ptr<GameObject>)> setup;
 
+    // Group prefabs (piles, clusters) create several objects around an origin instead
+    std::function<std::vector<std::shared_ptr<GameObject>>(const glm::vec3& origin)> groupSetup;
+    bool aggregate = false;
+    bool aggregateSelfCollision = true;
+
     PrefabDefinition() = default;
     PrefabDefinition(const std::string& prefabName,
         const std::function<void(std::shared_ptr<GameObject>)>& setupFunc)
@@ -36,4 +51,21 @@ public:
         defaultScale = scale;
         return *this;
     }
+
+    PrefabDefinition& setPoolSize(uint32_t size) {
+        poolSize = size;
+        return *this;
+    }
+
+    PrefabDefinition& setGroup(const std::function<std::vector<std::shared_ptr<GameObject>>(const glm::vec3&)>& groupFunc) {
+        groupSetup = groupFunc;
+        return *this;
+    }
+
+    // One broadphase entry for the whole group, selfCollision off suits ragdoll-like clusters
+    PrefabDefinition& setAggregate(bool selfCollision = true) {
+        aggregate = true;
+        aggregateSelfCollision = selfCollision;
+        return *this;
+    }
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 // PrefabManager.cpp
 #include "PrefabManager.hpp"
+#include "../PhysicsComponents/PhysicsComponent.hpp"
+#include "../PhysicsActorPool.hpp"
 #include <iostream>
 
 namespace PrefabManager {
@@ -25,10 +27,13 @@ namespace PrefabManager {
 		}
 
 		const auto& prefabDef = prefabs[prefabName];
+		if (!prefabDef.setup) {
+			std::cerr << "Error: Prefab '" << prefabName << "' is a group, use instantiateGroup" << std::endl;
+			return nullptr;
+		}
 
-		// Create a new GameObject with the prefab's name
-		// Convert std::string to const char* using c_str()
-		auto gameObject = std::make_shared<GameObject>(prefabName.c_str());
+		// Create a new GameObject with the prefab's name, in the current scene memory if any
+		auto gameObject = GameObject::create(prefabName.c_str());
 
 		// Rest of the function remains the same
 		gameObject->setPosition(position.x != 0.0f || position.y != 0.0f || position.z != 0.0f
@@ -41,4 +46,46 @@ namespace PrefabManager {
 
 		return gameObject;
 	}
-}
\ No newline at end of file
+
+	PrefabGroup instantiateGroup(const std::string& prefabName, const glm::vec3& position) {
+		PrefabGroup group;
+		if (!hasPrefab(prefabName)) {
+			std::cerr << "Error: Prefab '" << prefabName << "' not found!" << std::endl;
+			return group;
+		}
+
+		const auto& prefabDef = prefabs[prefabName];
+		group.aggregate = prefabDef.aggregate;
+		group.selfCollision = prefabDef.aggregateSelfCollision;
+
+		if (!prefabDef.groupSetup) {
+			if (auto gameObject = instantiate(prefabName, position))
+				group.objects.push_back(gameObject);
+			return group;
+		}
+
+		group.objects = prefabDef.groupSetup(position != glm::vec3(0.0f) ? position : prefabDef.defaultPosition);
+		return group;
+	}
+
+	bool warmPool(const std::string& prefabName, uint32_t count) {
+		// One throwaway instance gives the actor the prefab setup produces
+		auto prototype = instantiate(prefabName);
+		if (!prototype) return false;
+
+		auto physicsComponent = prototype->getComponent<PhysicsComponent>();
+		if (!physicsComponent || !physicsComponent->getActor()) {
+			std::cerr << "Error: Prefab '" << prefabName << "' has no physics actor to pool" << std::endl;
+			return false;
+		}
+		return PhysicsActorPool::prewarm(physicsComponent->getActor(), count);
+	}
+
+	void warmPools() {
+		for (const auto& [name, prefabDef] : prefabs) {
+			if (prefabDef.poolSize > 0 && warmPool(name, prefabDef.poolSize)) {
+				std::cout << "Pooled " << prefabDef.poolSize << " actors for prefab: " << name << std::endl;
+			}
+		}
+	}
+}
@@ -16,4 +16,17 @@ namespace PrefabManager {
         const std::string& prefabName,
         const glm::vec3& position = glm::vec3(0.0f)
     );
+
+    // Objects of a group prefab, a plain prefab gives a group of one
+    PrefabGroup instantiateGroup(
+        const std::string& prefabName,
+        const glm::vec3& position = glm::vec3(0.0f)
+    );
+
+    // Pre-creates `count` physics actors shaped like the prefab at its default scale,
+    // spawns of that prefab then reuse them instead of creating new ones
+    bool warmPool(const std::string& prefabName, uint32_t count);
+
+    // warmPool for every prefab registered with a pool size, needs Physics::init
+    void warmPools();
 };
\ No newline at end of file
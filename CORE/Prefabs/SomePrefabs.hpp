@@ -6,6 +6,7 @@
 #include "../PhysicsComponents/SpherePhysics.hpp"
 #include "../RenderComponents/CubeRenderer.hpp"
 #include "../PhysicsComponents/CubePhysics.hpp"
+#include "../Engine.hpp"
 
 
 inline void registerPrefabs() {
@@ -13,30 +14,50 @@ inline void registerPrefabs() {
 	PrefabManager::registerPrefab(
 		PrefabDefinition("DynamicCubePrefab", [](std::shared_ptr<GameObject> obj) {
 			// Add required components
-			auto cubeRenderer = obj->addComponent<CubeRenderer>();
+			if (!Engine::isHeadless())
+				obj->addComponent<CubeRenderer>();
 			auto cubePhysics = obj->addComponent<CubePhysics>(PhysicsComponent::Type::DYNAMIC);
 			cubePhysics->setMass(1);
 			})
 		.setDefaultPosition(glm::vec3(0.0f, 20.0f, 0.0f))
+		.setPoolSize(64)
 	);
 
 	// Register a Sphere prefab
 	PrefabManager::registerPrefab(
 		PrefabDefinition("SpherePrefab", [](std::shared_ptr<GameObject> obj) {
-			auto sphereRenderer = obj->addComponent<SphereRenderer>();
+			if (!Engine::isHeadless())
+				obj->addComponent<SphereRenderer>();
 			auto spherePhysics = obj->addComponent<SpherePhysics>(PhysicsComponent::Type::DYNAMIC);
 			spherePhysics->setMass(7);
 			})
 		.setDefaultPosition(glm::vec3(0.0f, 10.0f, 0.0f))
+		.setPoolSize(64)
+
 
+	);
 
+	// Pile of 4x4x4 dynamic cubes sharing one aggregate
+	PrefabManager::registerPrefab(
+		PrefabDefinition("CubePilePrefab", nullptr)
+		.setGroup([](const glm::vec3& origin) {
+			std::vector<std::shared_ptr<GameObject>> cubes;
+			for (int i = 0; i < 64; i++) {
+				glm::vec3 offset((i % 4) * 1.05f, (i / 16) * 1.05f, ((i / 4) % 4) * 1.05f);
+				cubes.push_back(PrefabManager::instantiate("DynamicCubePrefab", origin + offset));
+			}
+			return cubes;
+			})
+		.setAggregate(true)
+		.setDefaultPosition(glm::vec3(0.0f, 10.0f, 0.0f))
 	);
 
 	// Register a Ground/World prefab
 	PrefabManager::registerPrefab(
 		PrefabDefinition("WorldPrefab", [](std::shared_ptr<GameObject> obj) {
 			obj->setScale(glm::vec3(100.0f, 1.0f, 100.0f));
-			obj->addComponent<CubeRenderer>();
+			if (!Engine::isHeadless())
+				obj->addComponent<CubeRenderer>();
 			obj->addComponent<CubePhysics>(PhysicsComponent::Type::STATIC);
 			})
 		.setDefaultPosition(glm::vec3(0.0f, -10.0f, 0.0f))
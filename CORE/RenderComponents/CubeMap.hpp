@@ -5,6 +5,7 @@
 #include <iostream>
 
 class CubeMap : public RenderComponent {
+	COMPONENT_TYPE(CubeMap, RenderComponent)
 protected:
 	std::vector<std::string> faces = {};
 public:
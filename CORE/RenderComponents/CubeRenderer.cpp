@@ -6,31 +6,38 @@ void CubeRenderer::init() {
 	m_isShadowCaster= true;
 	m_isShadowReceiver = true;
 
-	// Generate and bind VAO, VBO, and EBO
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
-	glGenBuffers(1, &EBO);
+	// Every cube shares one upload
+	m_geometry = GeometryCache::get("cube", [](GpuGeometry& geometry) {
+		// Generate and bind VAO, VBO, and EBO
+		glGenVertexArrays(1, &geometry.vao);
+		glGenBuffers(1, &geometry.vbo);
+		glGenBuffers(1, &geometry.ebo);
 
-	glBindVertexArray(VAO);
+		glBindVertexArray(geometry.vao);
+
+		// Bind and fill VBO
+		glBindBuffer(GL_ARRAY_BUFFER, geometry.vbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * MeshData::Cube::vertices.size(), MeshData::Cube::vertices.data(), GL_STATIC_DRAW);
 
-	// Bind and fill VBO
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * MeshData::Cube::vertices.size(), MeshData::Cube::vertices.data(), GL_STATIC_DRAW);
+		// Bind and fill EBO
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry.ebo);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * MeshData::Cube::indices.size(), MeshData::Cube::indices.data(), GL_STATIC_DRAW);
 
-	// Bind and fill EBO
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * MeshData::Cube::indices.size(), MeshData::Cube::indices.data(), GL_STATIC_DRAW);
+		// Position attribute
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(0);
 
-	// Position attribute
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(0);
+		// Normal attribute
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+		glEnableVertexAttribArray(1);
 
-	// Normal attribute
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+		glEnableVertexAttribArray(2);
 
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-	glEnableVertexAttribArray(2);
+		geometry.indexCount = static_cast<GLsizei>(MeshData::Cube::indices.size());
+		glBindVertexArray(0);
+	});
+	VAO = m_geometry->vao;
 
 	// Set default shader
 	setShader("standard");
@@ -66,6 +73,7 @@ void CubeRenderer::renderWithMaterials(const std::shared_ptr<Camera>& cam) {
 
 	// Standard matrix uniforms
 	m_shader->setMat4("model", glm::value_ptr(getGameObject()->getModelMatrix()));
+	m_shader->setMat3("normalMatrix", getGameObject()->getNormalMatrix());
 	m_shader->setMat4("view", glm::value_ptr(cam->getViewMatrix()));
 	m_shader->setMat4("projection", glm::value_ptr(cam->getProjectionMatrix()));
 	m_shader->setMat4("lightSpaceMatrix", LightManager::getShadowMapper()->getLightSpaceMatrix());
@@ -135,7 +143,5 @@ void CubeRenderer::renderWithMaterials(const std::shared_ptr<Camera>& cam) {
 
 
 CubeRenderer::~CubeRenderer() {
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBO);
-	glDeleteBuffers(1, &EBO);
+	// Buffers belong to m_geometry
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <iostream>
 
 class CubeRenderer : public RenderComponent {
+	COMPONENT_TYPE(CubeRenderer, RenderComponent)
 public:
 
     void renderRawGeometry(const glm::mat4& lightSpaceMatrix) override;
@@ -11,6 +12,7 @@ public:
 
     void init() override;
 	void draw(const std::shared_ptr<Camera> cam) override;
+	bool getLocalBounds(Aabb& out) const override { out = Aabb(glm::vec3(-0.5f), glm::vec3(0.5f)); return true; }
     ~CubeRenderer();
 
 };
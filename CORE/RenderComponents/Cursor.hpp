@@ -4,6 +4,7 @@
 #include "../Window/Window.hpp"
 
 class UICursorComponent : public RenderComponent {
+	COMPONENT_TYPE(UICursorComponent, RenderComponent)
 public:
 
 	UICursorComponent() : RenderComponent() {
@@ -0,0 +1,35 @@
+#include "GeometryCache.hpp"
+#include <unordered_map>
+
+namespace GeometryCache
+{
+	namespace Internal
+	{
+		std::unordered_map<std::string, std::weak_ptr<GpuGeometry>> geometries;
+	}
+
+	std::shared_ptr<GpuGeometry> get(const std::string& key, const std::function<void(GpuGeometry&)>& build) {
+		std::weak_ptr<GpuGeometry>& slot = Internal::geometries[key];
+		if (std::shared_ptr<GpuGeometry> geometry = slot.lock())
+			return geometry;
+
+		auto geometry = std::make_shared<GpuGeometry>();
+		build(*geometry);
+		slot = geometry;
+		return geometry;
+	}
+
+	size_t getCount() {
+		size_t count = 0;
+		for (const auto& [key, geometry] : Internal::geometries) {
+			if (!geometry.expired()) count++;
+		}
+		return count;
+	}
+}
+
+GpuGeometry::~GpuGeometry() {
+	if (vao) glDeleteVertexArrays(1, &vao);
+	if (vbo) glDeleteBuffers(1, &vbo);
+	if (ebo) glDeleteBuffers(1, &ebo);
+}
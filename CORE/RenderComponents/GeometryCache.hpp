@@ -0,0 +1,28 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <functional>
+#include <glad/glad.h>
+
+// Vertex array and buffers of one mesh, deleted with the last renderer using them
+struct GpuGeometry {
+	GLuint vao = 0;
+	GLuint vbo = 0;
+	GLuint ebo = 0;
+	GLsizei indexCount = 0;
+
+	GpuGeometry() = default;
+	GpuGeometry(const GpuGeometry&) = delete;
+	GpuGeometry& operator=(const GpuGeometry&) = delete;
+	~GpuGeometry();
+};
+
+// Renderers drawing the same procedural mesh (every CubeRenderer, the spheres of one
+// tessellation) share its buffers: a level of thousands of cubes uploads one cube.
+// Main thread only, like every GL call.
+namespace GeometryCache
+{
+	// Geometry under `key`, built by `build` when no live renderer holds it
+	std::shared_ptr<GpuGeometry> get(const std::string& key, const std::function<void(GpuGeometry&)>& build);
+	size_t getCount();
+}
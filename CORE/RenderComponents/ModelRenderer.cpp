@@ -1,5 +1,12 @@
 #include "ModelRenderer.hpp"
 #include "stb_image.h"
+#include <unordered_map>
+
+namespace
+{
+	// Main thread only, like the uploads
+	std::unordered_map<std::string, std::weak_ptr<LoadedModel>> loadedModels;
+}
 
 void ModelRenderer::renderRawGeometry(const glm::mat4& lightSpaceMatrix) {
 	auto shader = ShaderManager::getShader("simpleDepthShader");
@@ -7,7 +14,7 @@ void ModelRenderer::renderRawGeometry(const glm::mat4& lightSpaceMatrix) {
 	shader->setMat4("lightSpaceMatrix", lightSpaceMatrix);
 	shader->setMat4("model", glm::value_ptr(getGameObject()->getModelMatrix()));
 
-	for (auto& mesh : meshes) {
+	for (auto& mesh : m_model->meshes) {
 		mesh.drawRawGeometry();
 	}
 }
@@ -20,6 +27,7 @@ void ModelRenderer::renderWithMaterials(const std::shared_ptr<Camera>& cam) {
 
 	// Standard matrix uniforms
 	m_shader->setMat4("model", glm::value_ptr(getGameObject()->getModelMatrix()));
+	m_shader->setMat3("normalMatrix", getGameObject()->getNormalMatrix());
 	m_shader->setMat4("view", glm::value_ptr(cam->getViewMatrix()));
 	m_shader->setMat4("projection", glm::value_ptr(cam->getProjectionMatrix()));
 	m_shader->setMat4("lightSpaceMatrix", LightManager::getShadowMapper()->getLightSpaceMatrix());
@@ -59,8 +67,8 @@ void ModelRenderer::renderWithMaterials(const std::shared_ptr<Camera>& cam) {
 		m_shader->setVec3(base + "color", relevantLights[i]->getColor());
 		m_shader->setFloat(base + "intensity", relevantLights[i]->getIntensity());
 	}
-	for (unsigned int i = 0; i < meshes.size(); i++) {
-		meshes[i].Draw(m_shader, LightManager::getShadowMapper()->getLightSpaceMatrix(),
+	for (unsigned int i = 0; i < m_model->meshes.size(); i++) {
+		m_model->meshes[i].Draw(m_shader, LightManager::getShadowMapper()->getLightSpaceMatrix(),
 			!relevantLights.empty(), true);
 	}
 
@@ -82,6 +90,13 @@ ModelRenderer::~ModelRenderer() {
 }
 
 void ModelRenderer::loadModel() {
+	std::weak_ptr<LoadedModel>& cached = loadedModels[m_path];
+	if (std::shared_ptr<LoadedModel> model = cached.lock()) {
+		m_model = model;
+		return;
+	}
+	m_model = std::make_shared<LoadedModel>();
+
 	Assimp::Importer importer;
 	const aiScene* scene = importer.ReadFile(m_path,
 		aiProcess_Triangulate |
@@ -96,6 +111,15 @@ void ModelRenderer::loadModel() {
 	directory = m_path.substr(0, m_path.find_last_of('/'));
 	processNode(scene->mRootNode, scene);
 
+	for (const Mesh& mesh : m_model->meshes) {
+		for (const Vertex& vertex : mesh.vertices) {
+			if (!m_model->hasBounds) m_model->bounds = Aabb(vertex.Position, vertex.Position);
+			m_model->bounds.merge(Aabb(vertex.Position, vertex.Position));
+			m_model->hasBounds = true;
+		}
+	}
+	cached = m_model;
+
 	// Print model information
 	printModelInfo();
 }
@@ -104,7 +128,7 @@ void ModelRenderer::processNode(aiNode* node, const aiScene* scene) {
 	// Process all meshes in node
 	for (unsigned int i = 0; i < node->mNumMeshes; i++) {
 		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		meshes.push_back(processMesh(mesh, scene));
+		m_model->meshes.push_back(processMesh(mesh, scene));
 	}
 
 	// Process children recursively
@@ -204,6 +228,8 @@ unsigned int ModelRenderer::TextureFromFile(const char* path, const std::string&
 	glGenTextures(1, &textureID);
 
 	int width, height, nrComponents;
+	// Flipped like the other 2D textures (see TextureManager::decodeImage)
+	stbi_set_flip_vertically_on_load_thread(true);
 	unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
 	if (data) {
 		GLenum format;
@@ -235,15 +261,15 @@ unsigned int ModelRenderer::TextureFromFile(const char* path, const std::string&
 
 void ModelRenderer::printModelInfo() const {
 	std::cout << "Model Information:\n";
-	std::cout << "  Meshes: " << meshes.size() << "\n";
+	std::cout << "  Meshes: " << m_model->meshes.size() << "\n";
 
-	for (size_t i = 0; i < meshes.size(); i++) {
+	for (size_t i = 0; i < m_model->meshes.size(); i++) {
 		std::cout << "  Mesh " << i << ":\n";
-		std::cout << "    Vertices: " << meshes[i].vertices.size() << "\n";
-		std::cout << "    Indices: " << meshes[i].indices.size() << "\n";
-		std::cout << "    Textures: " << meshes[i].textures.size() << "\n";
+		std::cout << "    Vertices: " << m_model->meshes[i].vertices.size() << "\n";
+		std::cout << "    Indices: " << m_model->meshes[i].indices.size() << "\n";
+		std::cout << "    Textures: " << m_model->meshes[i].textures.size() << "\n";
 
-		for (const auto& tex : meshes[i].textures) {
+		for (const auto& tex : m_model->meshes[i].textures) {
 			std::cout << "      " << tex.type << ": " << tex.path << "\n";
 		}
 	}
@@ -1,4 +1,4 @@
-
+#pragma once
 #include "../RenderComponents/RenderComponent.hpp"
 #include "../Lights/LightManager.hpp"
 #include <glm/glm.hpp>
@@ -7,17 +7,28 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+// Imported and uploaded once per path, shared by every renderer of that file
+struct LoadedModel {
+	std::vector<Mesh> meshes;
+	Aabb bounds;
+	bool hasBounds = false;
+};
 
 class ModelRenderer : public RenderComponent {
+	COMPONENT_TYPE(ModelRenderer, RenderComponent)
 public:
 	ModelRenderer(const std::string& path) : RenderComponent(), m_path(path) {	}
 	void setPath(const std::string& path) { m_path = path; }
+	const std::string& getPath() const { return m_path; }
 	void renderRawGeometry(const glm::mat4& lightSpaceMatrix) override;
 	void renderWithMaterials(const std::shared_ptr<Camera>& cam) override;
 	void init() override;
 	~ModelRenderer();
 	void draw(const std::shared_ptr<Camera> cam) override { renderWithMaterials(cam); }
 
+	const std::vector<Mesh>& getMeshes() const { return m_model->meshes; }
+	bool getLocalBounds(Aabb& out) const override { out = m_model->bounds; return m_model->hasBounds; }
+
 private:
 
 	void loadModel();
@@ -27,7 +38,7 @@ private:
 
 	unsigned int TextureFromFile(const char* path, const std::string& directory);
 	void printModelInfo() const;
-	std::vector<Mesh> meshes;
+	std::shared_ptr<LoadedModel> m_model = std::make_shared<LoadedModel>();
 	std::string directory;
 	std::vector<Texture> textures_loaded;
 	std::string m_path;
@@ -10,8 +10,11 @@
 #include "../TextureManager.hpp"
 #include <iostream>
 #include "../Cameras/Camera.hpp"
+#include "../Bounds.hpp"
+#include "GeometryCache.hpp"
 
 class RenderComponent : public Component {
+	COMPONENT_TYPE(RenderComponent, Component)
 public:
 	RenderComponent() : Component(), m_color(glm::vec4(1, 1, 1, 1)), m_renderer(nullptr), m_shader(nullptr),
 		VAO(0), VBO(0), EBO(0), m_isShadowCaster(false), m_isShadowReceiver(false) {	}
@@ -27,6 +30,8 @@ public:
 	virtual void draw() {};
 	virtual void renderRawGeometry(const glm::mat4& lightSpaceMatrix) {};// Shadow pass
 	virtual void renderWithMaterials(const std::shared_ptr<Camera>& cam) {}; // Main pass
+	// Box of the geometry in model space, false when unknown (never culled)
+	virtual bool getLocalBounds(Aabb& out) const { return false; }
 
 	bool getIsShadowCaster() const { return m_isShadowCaster; }
 	bool getIsShadowReceiver() const { return m_isShadowReceiver; }
@@ -40,6 +45,7 @@ public:
 	glm::vec4 getColor() const	{		return m_color;	}
 	void addTexture(const std::string& textureName);
 	void addTexture(std::shared_ptr<Texture> texture)	{		m_textures.push_back(texture);	}
+	const std::vector<std::shared_ptr<Texture>>& getTextures() const { return m_textures; }
 	void bindTextures();
 	void unBindTextures();
 	void setShader(std::shared_ptr<ShaderProgram> shader)	{		m_shader = shader;	}
@@ -53,6 +59,8 @@ protected:
 	glm::vec4 m_color;
 
 	unsigned int VAO, VBO, EBO;
+	// Shared buffers, VAO mirrors its vertex array when set
+	std::shared_ptr<GpuGeometry> m_geometry;
 
 	std::vector<std::shared_ptr<Texture>> m_textures;
 
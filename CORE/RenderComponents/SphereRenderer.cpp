@@ -4,9 +4,7 @@
 
 
 SphereRenderer::~SphereRenderer() {
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBO);
-	glDeleteBuffers(1, &EBO);
+	// Buffers belong to m_geometry
 }
 
 void SphereRenderer::renderRawGeometry(const glm::mat4& lightSpaceMatrix) {
@@ -19,6 +17,7 @@ void SphereRenderer::renderWithMaterials(const std::shared_ptr<Camera>& cam) {
 
 	// Set matrix uniforms
 	m_shader->setMat4("model", glm::value_ptr(this->getGameObject()->getModelMatrix()));
+	m_shader->setMat3("normalMatrix", this->getGameObject()->getNormalMatrix());
 	m_shader->setMat4("view", glm::value_ptr(cam->getViewMatrix()));
 	m_shader->setMat4("projection", glm::value_ptr(cam->getProjectionMatrix()));
 
@@ -29,15 +28,23 @@ void SphereRenderer::renderWithMaterials(const std::shared_ptr<Camera>& cam) {
 	}
 
 	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+	glDrawElements(GL_TRIANGLES, m_geometry->indexCount, GL_UNSIGNED_INT, 0);
 
 
 }
 
 void SphereRenderer::init() {
 	setShader("sphere");
-	generateSphere(radius, sectorCount, stackCount);
-	initBuffers();
+	// Spheres of the same tessellation share one upload
+	std::string key = "sphere:" + std::to_string(radius) + ":" + std::to_string(sectorCount) + ":" + std::to_string(stackCount);
+	m_geometry = GeometryCache::get(key, [this](GpuGeometry& geometry) {
+		generateSphere(radius, sectorCount, stackCount);
+		initBuffers(geometry);
+		// Uploaded, the CPU copy is not needed anymore
+		vertices = std::vector<float>();
+		indices = std::vector<unsigned int>();
+	});
+	VAO = m_geometry->vao;
 }
 
 void SphereRenderer::draw(const std::shared_ptr<Camera> cam) {
@@ -47,6 +54,7 @@ void SphereRenderer::draw(const std::shared_ptr<Camera> cam) {
 
 	// Set uniforms
 	m_shader->setMat4("model", glm::value_ptr(this->getGameObject()->getModelMatrix()));
+	m_shader->setMat3("normalMatrix", this->getGameObject()->getNormalMatrix());
 	m_shader->setMat4("view", glm::value_ptr(cam->getViewMatrix()));
 	m_shader->setMat4("projection", glm::value_ptr(cam->getProjectionMatrix()));
 
@@ -80,24 +88,25 @@ void SphereRenderer::draw(const std::shared_ptr<Camera> cam) {
 
 	// Draw sphere using indices
 	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+	glDrawElements(GL_TRIANGLES, m_geometry->indexCount, GL_UNSIGNED_INT, 0);
 	glBindVertexArray(0);
 }
 
-void SphereRenderer::initBuffers() {
+void SphereRenderer::initBuffers(GpuGeometry& geometry) {
 	// Generate and bind VAO, VBO, and EBO
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
-	glGenBuffers(1, &EBO);
+	glGenVertexArrays(1, &geometry.vao);
+	glGenBuffers(1, &geometry.vbo);
+	glGenBuffers(1, &geometry.ebo);
+	geometry.indexCount = static_cast<GLsizei>(indices.size());
 
-	glBindVertexArray(VAO);
+	glBindVertexArray(geometry.vao);
 
 	// Bind and fill VBO
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, geometry.vbo);
 	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
 
 	// Bind and fill EBO
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry.ebo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
 	// Position attribute
@@ -107,6 +116,7 @@ void SphereRenderer::initBuffers() {
 	// Normal attribute
 	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
 	glEnableVertexAttribArray(1);
+	glBindVertexArray(0);
 }
 void SphereRenderer::generateSphere(float radius, unsigned int sectorCount, unsigned int stackCount) {
 	vertices.clear();
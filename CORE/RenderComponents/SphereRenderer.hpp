@@ -8,6 +8,7 @@
 constexpr float M_PI = 3.14159265359f;  // Fixed M_PI definition
 
 class SphereRenderer : public RenderComponent {
+	COMPONENT_TYPE(SphereRenderer, RenderComponent)
 public:
 	SphereRenderer(float radius = 1.0f, unsigned int sectorCount = 36, unsigned int stackCount = 18)
 		: RenderComponent(), radius(radius), sectorCount(sectorCount), stackCount(stackCount) {
@@ -19,6 +20,11 @@ public:
 	void renderWithMaterials(const std::shared_ptr<Camera>& cam) override;
 	void init() override;
 	void draw(const std::shared_ptr<Camera> cam) override;
+	bool getLocalBounds(Aabb& out) const override { out = Aabb(glm::vec3(-radius), glm::vec3(radius)); return true; }
+
+	float getRadius() const { return radius; }
+	unsigned int getSectorCount() const { return sectorCount; }
+	unsigned int getStackCount() const { return stackCount; }
 
 
 private:
@@ -26,7 +32,7 @@ private:
 	float radius;
 	unsigned int sectorCount, stackCount;
 
-	void initBuffers();
+	void initBuffers(GpuGeometry& geometry);
 	void generateSphere(float radius, unsigned int sectorCount, unsigned int stackCount);
 
 };
@@ -1,19 +1,60 @@
 #include "Scene.hpp"
 #include "PhysicsComponents/PhysicsComponent.hpp"
+#include "PhysicsRecorder.hpp"
+#include "TransformBatch.hpp"
+#include "Prefabs/PrefabManager.hpp"
+#include "Lights/LightManager.hpp"
+#include "UI/SceneObjectEditor.hpp"
+#include <iostream>
+#include <map>
+#include <tuple>
+#include <cmath>
 
 void Scene::update(float dt) { 
+    flushDestroyed();
+
     if(m_camera)
         m_camera->update(dt);
 
+    // Cells committed here simulate from this step on. Without a camera the caller
+    // drives getStreaming().update with its own point of interest.
+    if (m_streaming.isOpen() && m_camera)
+        m_streaming.update(*this, m_camera->getPosition());
+
+    if (m_culling.isEnabled()) {
+        // Replays run without a camera, every body simulates while a session is recorded
+        if (PhysicsRecorder::isRecording(this)) {
+            m_culling.restoreAll(m_gameObjects);
+        }
+        else {
+            glm::vec3 cameraPosition = m_camera ? m_camera->getPosition() : glm::vec3(0.0f);
+            m_culling.update(m_gameObjects, m_camera ? &cameraPosition : nullptr);
+        }
+    }
 
+    // Forces and kinematic targets set here go into this step and its recording
+    m_components.update(UpdatePhase::PRE_PHYSICS, dt);
+
+    // Gameplay moves since the last step, in one pass and recorded with this step
+    m_physicsScene->flushPoses();
+    PhysicsRecorder::recordStep(this, dt);
     m_physicsScene->update(dt);
 
+    m_components.update(UpdatePhase::POST_PHYSICS, dt);
+
+    // Shadow and main passes read the cached matrices: dirty roots go through the SIMD
+    // batch, children follow their parents, clean objects cost a flag test
+    TransformBatch::updateWorldMatrices(m_gameObjects);
     for (auto& gameObject : m_gameObjects) {
-        gameObject->update(dt);
+        gameObject->updateWorldMatrix();
     }
 
+    m_components.update(UpdatePhase::PRE_RENDER, dt);
+
     onUpdate();
 
+    // After onUpdate so what it moved is culled right this frame
+    syncSpatialIndex();
 }
 
 
@@ -32,11 +73,29 @@ void Scene::renderMainPass() {
     if (m_cubemap)
 		m_cubemap->draw(m_camera->getViewMatrix(), m_camera->getProjectionMatrix());
     
-    // Normal rendering with materials
-    for (auto obj : m_gameObjects) {
-        obj->renderWithMaterials(m_camera);
+    if (!m_frustumCulling) {
+        m_visibleCount = m_gameObjects.size();
+        m_components.view<RenderComponent>([&](GameObject&, RenderComponent& renderComponent) {
+            renderComponent.renderWithMaterials(m_camera);
+        });
+        return;
     }
 
+    // One index query for the frame, then a byte per object
+    m_queryIds.clear();
+    m_spatialIndex->queryFrustum(Frustum(m_camera->getProjectionMatrix() * m_camera->getViewMatrix()), m_queryIds);
+    m_visible.assign(m_spatialIndex->getCapacity(), 0);
+    for (SpatialIndex::Id id : m_queryIds) m_visible[id] = 1;
+    m_visibleCount = m_queryIds.size();
+
+    // Normal rendering with materials
+    m_components.view<RenderComponent>([&](GameObject& gameObject, RenderComponent& renderComponent) {
+        Aabb local;
+        if (gameObject.m_spatialId < m_visible.size() && !m_visible[gameObject.m_spatialId] && renderComponent.getLocalBounds(local))
+            return;
+        renderComponent.renderWithMaterials(m_camera);
+    });
+
 }
 
 void Scene::render() {
@@ -54,17 +113,145 @@ void Scene::render() {
     onRender();
 }
 
-std::shared_ptr<GameObject> Scene::createGameObject() {
-    auto gameObject = std::make_shared<GameObject>();
+Scene::~Scene() {
+    // The editor keeps a pointer to the scene of its selection
+    UI::clearSelection(this);
+    // Streamed objects not committed yet live in our memory too
+    m_streaming.close(*this);
+    // Objects held elsewhere must not point at our tables once we are gone
+    clearGameObjects();
+
+    // Their memory cannot go away under them either
+    if (m_memory->getLiveCount() > 0) {
+        std::cerr << "Scene destroyed while " << m_memory->getLiveCount()
+            << " of its allocations are still referenced, its memory is leaked" << std::endl;
+        (void)m_memory.release();
+    }
+}
+
+std::shared_ptr<GameObject> Scene::createGameObject(const char* name) {
+    SceneMemory::Scope scope(*m_memory);
+    auto gameObject = GameObject::create(name);
     m_gameObjects.push_back(gameObject);
+    attachGameObject(gameObject.get());
+    return gameObject;
+}
+
+std::shared_ptr<GameObject> Scene::spawnPrefab(const std::string& prefabName, const glm::vec3& position) {
+    std::shared_ptr<GameObject> gameObject;
+    {
+        SceneMemory::Scope scope(*m_memory);
+        gameObject = PrefabManager::instantiate(prefabName, position);
+    }
+    if (gameObject)
+        addGameObject(gameObject);
     return gameObject;
 }
 
+void Scene::attachGameObject(GameObject* gameObject) {
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    Slot& slot = m_slots[index];
+    slot.used = true;
+    slot.denseIndex = static_cast<uint32_t>(m_gameObjects.size() - 1);
+
+    gameObject->m_handle = { index, slot.generation };
+    gameObject->m_pendingDestroy = false;
+    gameObject->setRegistry(&m_components);
+
+    gameObject->m_spatialId = m_spatialIndex->insert(gameObject, gameObject->getWorldBounds());
+    gameObject->clearMoved();
+}
+
+GameObject* Scene::resolve(GameObjectHandle handle) const {
+    if (handle.index >= m_slots.size()) return nullptr;
+    const Slot& slot = m_slots[handle.index];
+    if (!slot.used || slot.generation != handle.generation) return nullptr;
+    return m_gameObjects[slot.denseIndex].get();
+}
+
+std::shared_ptr<GameObject> Scene::resolveShared(GameObjectHandle handle) const {
+    return resolve(handle) ? m_gameObjects[m_slots[handle.index].denseIndex] : nullptr;
+}
+
 void Scene::destroyGameObject(std::shared_ptr<GameObject> gameObject) {
-    auto it = std::find(m_gameObjects.begin(), m_gameObjects.end(), gameObject);
-    if (it != m_gameObjects.end()) {
-        m_gameObjects.erase(it);
+    if (!gameObject || gameObject->m_pendingDestroy) return;
+    // Not one of ours
+    if (resolve(gameObject->m_handle) != gameObject.get()) return;
+
+    gameObject->m_pendingDestroy = true;
+    m_pendingDestroy.push_back(gameObject);
+}
+
+void Scene::destroyGameObject(GameObjectHandle handle) {
+    destroyGameObject(resolveShared(handle));
+}
+
+void Scene::flushDestroyed() {
+    if (m_pendingDestroy.empty()) return;
+
+    // Physics first, one removeActors call for the whole batch
+    std::vector<PxRigidActor*> actors;
+    actors.reserve(m_pendingDestroy.size());
+    for (auto& gameObject : m_pendingDestroy) {
+        PhysicsRecorder::recordDestroy(gameObject.get());
+        PhysicsComponent* physicsComponent = gameObject->getComponentPtr<PhysicsComponent>();
+        if (physicsComponent && physicsComponent->getActor())
+            actors.push_back(physicsComponent->getActor());
+    }
+    m_physicsScene->removeActors(actors);
+
+    for (auto& gameObject : m_pendingDestroy) {
+        // LightManager shares ownership of the lights, they would keep lighting the level
+        gameObject->forEachComponent<Light>([](Light* light) { LightManager::removeLight(light); });
+        gameObject->setRegistry(nullptr);
+        m_spatialIndex->remove(gameObject->m_spatialId);
+        gameObject->m_spatialId = SpatialIndex::invalidId;
+
+        // Swap and pop, the moved object gets its new position in its slot
+        Slot& slot = m_slots[gameObject->m_handle.index];
+        uint32_t denseIndex = slot.denseIndex;
+        if (denseIndex + 1 != m_gameObjects.size()) {
+            m_gameObjects[denseIndex] = std::move(m_gameObjects.back());
+            m_slots[m_gameObjects[denseIndex]->m_handle.index].denseIndex = denseIndex;
+        }
+        m_gameObjects.pop_back();
+
+        // Old handles stop resolving
+        slot.used = false;
+        slot.generation++;
+        m_freeSlots.push_back(gameObject->m_handle.index);
+        gameObject->m_handle = GameObjectHandle{};
+    }
+
+    // One pass over the casters for the whole batch
+    shadowCasters.erase(std::remove_if(shadowCasters.begin(), shadowCasters.end(),
+        [](const std::shared_ptr<GameObject>& caster) { return caster->m_pendingDestroy; }), shadowCasters.end());
+
+    // Last owner for most of them: components and actors are released here
+    m_pendingDestroy.clear();
+}
+
+void Scene::clearGameObjects() {
+    m_pendingDestroy.clear();
+    for (auto& gameObject : m_gameObjects) {
+        gameObject->forEachComponent<Light>([](Light* light) { LightManager::removeLight(light); });
+        gameObject->setRegistry(nullptr);
+        gameObject->m_handle = GameObjectHandle{};
+        gameObject->m_spatialId = SpatialIndex::invalidId;
     }
+    m_spatialIndex->clear();
+    m_gameObjects.clear();
+    shadowCasters.clear();
+    m_slots.clear();
+    m_freeSlots.clear();
 }
 
 void Scene::addGameObject(std::shared_ptr<GameObject> gameObject) {
@@ -72,15 +259,139 @@ void Scene::addGameObject(std::shared_ptr<GameObject> gameObject) {
         ENGINE_ASSERT(gameObject, "Cannot add null GameObject to Scene");
 
 
-    m_gameObjects.push_back(gameObject);
     if (auto physicsComponent = gameObject->getComponent<PhysicsComponent>()) {
-        m_physicsScene->addActor(physicsComponent->getActor());
+        if (physicsComponent->getActor())
+            m_physicsScene->addActor(physicsComponent->getActor());
+    }
+    registerGameObject(gameObject);
+}
+
+void Scene::addGameObjects(const std::vector<std::shared_ptr<GameObject>>& gameObjects, bool aggregate, bool selfCollision) {
+    std::vector<PxRigidActor*> actors;
+    actors.reserve(gameObjects.size());
+    for (auto& gameObject : gameObjects) {
+        if (!gameObject) continue;
+        if (auto physicsComponent = gameObject->getComponent<PhysicsComponent>()) {
+            if (physicsComponent->getActor())
+                actors.push_back(physicsComponent->getActor());
+        }
+    }
+
+    if (aggregate)
+        m_physicsScene->addAggregate(actors, selfCollision);
+    else
+        m_physicsScene->addActors(actors);
+
+    for (auto& gameObject : gameObjects) {
+        if (gameObject)
+            registerGameObject(gameObject);
     }
-    if (auto physicsComponent = gameObject->getComponent<RenderComponent>()) {
-		if (physicsComponent->getIsShadowCaster()) {
+}
+
+void Scene::registerGameObject(const std::shared_ptr<GameObject>& gameObject) {
+    m_gameObjects.push_back(gameObject);
+    attachGameObject(gameObject.get());
+    PhysicsRecorder::recordSpawn(this, gameObject.get());
+    if (auto renderComponent = gameObject->getComponent<RenderComponent>()) {
+		if (renderComponent->getIsShadowCaster()) {
 			shadowCasters.push_back(gameObject);
 		}
 	}
 }
 
+void Scene::syncSpatialIndex() {
+    for (auto& gameObject : m_gameObjects) {
+        if (!gameObject->hasMoved()) continue;
+        m_spatialIndex->update(gameObject->m_spatialId, gameObject->getWorldBounds());
+        gameObject->clearMoved();
+    }
+}
+
+void Scene::setSpatialIndex(const SpatialIndex::Settings& settings) {
+    m_spatialIndex = SpatialIndex::create(settings);
+    for (auto& gameObject : m_gameObjects) {
+        gameObject->m_spatialId = m_spatialIndex->insert(gameObject.get(), gameObject->getWorldBounds());
+        gameObject->clearMoved();
+    }
+    LOG_OK("Spatial index: " << SpatialIndex::toString(settings.type) << ", " << m_gameObjects.size() << " objects");
+}
+
+void Scene::queryObjects(const Aabb& box, std::vector<GameObject*>& out) const {
+    std::vector<SpatialIndex::Id> ids;
+    m_spatialIndex->queryAabb(box, ids);
+    for (SpatialIndex::Id id : ids) out.push_back(static_cast<GameObject*>(m_spatialIndex->getUserData(id)));
+}
+
+void Scene::queryObjects(const glm::vec3& center, float radius, std::vector<GameObject*>& out) const {
+    std::vector<SpatialIndex::Id> ids;
+    m_spatialIndex->querySphere(center, radius, ids);
+    for (SpatialIndex::Id id : ids) out.push_back(static_cast<GameObject*>(m_spatialIndex->getUserData(id)));
+}
+
+void Scene::queryObjects(const Frustum& frustum, std::vector<GameObject*>& out) const {
+    std::vector<SpatialIndex::Id> ids;
+    m_spatialIndex->queryFrustum(frustum, ids);
+    for (SpatialIndex::Id id : ids) out.push_back(static_cast<GameObject*>(m_spatialIndex->getUserData(id)));
+}
+
+GameObject* Scene::raycastObjects(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* distance) const {
+    std::vector<SpatialIndex::RayHit> hits;
+    m_spatialIndex->queryRay(origin, direction, maxDistance, hits);
+    if (hits.empty()) return nullptr;
+    if (distance) *distance = hits.front().distance;
+    return static_cast<GameObject*>(m_spatialIndex->getUserData(hits.front().id));
+}
+
+size_t Scene::mergeStaticColliders(float cellSize) {
+    if (cellSize <= 0.0f) return 0;
 
+    // Static colliders per region, ordered map so the merge is the same on every run
+    std::map<std::tuple<int, int, int>, std::vector<PhysicsComponent*>> cells;
+    size_t actorsBefore = 0;
+    for (auto& gameObject : m_gameObjects) {
+        auto physicsComponent = gameObject->getComponent<PhysicsComponent>();
+        if (!physicsComponent || !physicsComponent->getActor()) continue;
+        actorsBefore++;
+        if (!physicsComponent->getActor()->is<PxRigidStatic>()) continue;
+
+        glm::vec3 position = gameObject->getPosition();
+        std::tuple<int, int, int> cell(
+            static_cast<int>(std::floor(position.x / cellSize)),
+            static_cast<int>(std::floor(position.y / cellSize)),
+            static_cast<int>(std::floor(position.z / cellSize)));
+        cells[cell].push_back(physicsComponent.get());
+    }
+
+    std::vector<PxRigidActor*> merged;
+    size_t removed = 0;
+    for (auto& [cell, components] : cells) {
+        // A lone collider gains nothing
+        if (components.size() < 2) continue;
+
+        PxVec3 center(
+            (std::get<0>(cell) + 0.5f) * cellSize,
+            (std::get<1>(cell) + 0.5f) * cellSize,
+            (std::get<2>(cell) + 0.5f) * cellSize);
+        PxRigidStatic* region = Physics::getPhysics()->createRigidStatic(PxTransform(center));
+        if (!region) {
+            std::cerr << "Failed to create a merged static actor" << std::endl;
+            continue;
+        }
+
+        for (PhysicsComponent* component : components) {
+            if (component->mergeInto(region)) removed++;
+        }
+        if (region->getNbShapes() == 0) {
+            region->release();
+            continue;
+        }
+        merged.push_back(region);
+    }
+
+    if (!merged.empty())
+        m_physicsScene->addActors(merged);
+
+    LOG_OK("Merged static colliders: " << actorsBefore << " actors -> "
+        << actorsBefore - removed + merged.size() << " (" << merged.size() << " regions)");
+    return merged.size();
+}
@@ -5,17 +5,25 @@
 #include "Cameras/Camera.hpp"
 #include "RenderComponents/CubeMap.hpp"
 #include "PhysicsScene.hpp"
+#include "PhysicsSnapshot.hpp"
+#include "PhysicsCulling.hpp"
+#include "ComponentRegistry.hpp"
+#include "SceneMemory.hpp"
+#include "SpatialIndex.hpp"
+#include "WorldStreamer.hpp"
 
 
 class Scene {
 public:
-	Scene() : m_camera(nullptr), m_cubemap(nullptr) {
+	Scene(const Physics::SceneConfig& physicsConfig = Physics::SceneConfig{})
+		: m_memory(std::make_unique<SceneMemory>()), m_spatialIndex(SpatialIndex::create(SpatialIndex::Settings{})),
+		m_camera(nullptr), m_cubemap(nullptr) {
 		m_physicsScene = std::make_shared<PhysicsScene>();
-		m_physicsScene->init();
+		m_physicsScene->init(physicsConfig);
 	}
 
 
-	virtual ~Scene() = default;
+	virtual ~Scene();
 	virtual void init() {}
 	virtual void shutdown() {}
 	virtual void onUpdate() {}
@@ -31,28 +39,109 @@ public:
 	void renderShadowCasters(const glm::mat4& lightMatrix);
 	void renderMainPass();
 
-	std::shared_ptr<GameObject> createGameObject();
+	// Allocated in the scene memory, like everything spawned within a SceneMemory::Scope of it
+	std::shared_ptr<GameObject> createGameObject(const char* name = "");
+	// PrefabManager::instantiate in the scene memory, then addGameObject
+	std::shared_ptr<GameObject> spawnPrefab(const std::string& prefabName, const glm::vec3& position = glm::vec3(0.0f));
+	// Deferred: the object stays valid until flushDestroyed, at the start of the next update
 	void destroyGameObject(std::shared_ptr<GameObject> gameObject);
+	void destroyGameObject(GameObjectHandle handle);
+	// Takes the queued objects out of the physics scene, the shadow casters, the component
+	// tables and the object list in one pass. Safe point: outside any object iteration.
+	void flushDestroyed();
+	// Every object at once, no queue (teardown)
+	void clearGameObjects();
+
+	// nullptr once the object is destroyed
+	GameObject* resolve(GameObjectHandle handle) const;
+	std::shared_ptr<GameObject> resolveShared(GameObjectHandle handle) const;
 
 	void addGameObject(std::shared_ptr<GameObject> gameObject);
+	// Adds a batch in one PhysX call, as PxAggregates when `aggregate` is set (see PrefabGroup)
+	void addGameObjects(const std::vector<std::shared_ptr<GameObject>>& gameObjects, bool aggregate = false, bool selfCollision = true);
 	inline std::vector<std::shared_ptr<GameObject>>& getGameObjects() { return m_gameObjects; }
+	// Packed component tables of the scene objects, iterate them with getComponents().view<A, B>(...)
+	inline ComponentRegistry& getComponents() { return m_components; }
+	inline SceneMemory& getMemory() { return *m_memory; }
+
+	// Level finalization: static colliders of each cellSize region become the shapes of a
+	// single PxRigidStatic, the broadphase then tracks one bound per region instead of one
+	// per object. Call it once the level is loaded. Returns the number of merged actors.
+	size_t mergeStaticColliders(float cellSize = 50.0f);
+
+	// World boxes of the scene objects, brought up to date at the end of update from the
+	// objects that moved. Changing the settings rebuilds it.
+	void setSpatialIndex(const SpatialIndex::Settings& settings);
+	inline const SpatialIndex& getSpatialIndex() const { return *m_spatialIndex; }
+	// Objects whose world box passes the test, appended to out
+	void queryObjects(const Aabb& box, std::vector<GameObject*>& out) const;
+	void queryObjects(const glm::vec3& center, float radius, std::vector<GameObject*>& out) const;
+	void queryObjects(const Frustum& frustum, std::vector<GameObject*>& out) const;
+	// Nearest object whose world box the ray crosses, nullptr when none
+	GameObject* raycastObjects(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* distance = nullptr) const;
+
+	// Main pass draws only what the camera frustum touches, components without local bounds always
+	inline void setFrustumCulling(bool enabled) { m_frustumCulling = enabled; }
+	inline bool isFrustumCulling() const { return m_frustumCulling; }
+	// Objects inside the frustum at the last main pass
+	inline size_t getVisibleCount() const { return m_visibleCount; }
 
 	inline void setCamera(std::shared_ptr<Camera> camera) { m_camera = camera; }
 	inline std::shared_ptr<Camera> getCamera() { return m_camera; }
 	inline void setCubemap(std::shared_ptr<CubeMap> cubemap) { m_cubemap = cubemap; }
 	inline std::shared_ptr<CubeMap> getCubemap() { return m_cubemap; }
 	inline std::shared_ptr<PhysicsScene> getPhysicsScene() { return m_physicsScene; }
+	// Simulation distance culling, off by default
+	inline PhysicsCulling& getCulling() { return m_culling; }
+	// Baked world cells around the camera, idle until getStreaming().open(directory)
+	inline WorldStreamer& getStreaming() { return m_streaming; }
+
+	// Binary capture / reset of every physics actor of the scene objects
+	bool savePhysicsSnapshot(PhysicsSnapshot& out) { return PhysicsSerialization::save(m_gameObjects, out); }
+	bool loadPhysicsSnapshot(const PhysicsSnapshot& snapshot) { return PhysicsSerialization::load(*m_physicsScene, m_gameObjects, snapshot); }
 
 
 
 protected:
+	// Object list and shadow casters, the physics actor is added by the caller
+	void registerGameObject(const std::shared_ptr<GameObject>& gameObject);
+	// Handle slot and component tables of an object just pushed in m_gameObjects
+	void attachGameObject(GameObject* gameObject);
+	// Moved objects update their proxy, a flag test for the others
+	void syncSpatialIndex();
+
+	// First member, the objects and containers below may allocate from it. Objects still
+	// referenced elsewhere when the scene dies keep it alive (leaked, with a warning).
+	std::unique_ptr<SceneMemory> m_memory;
+
+	// Handle slots: generation of the slot and position of its object in m_gameObjects
+	struct Slot {
+		uint32_t generation = 1;
+		uint32_t denseIndex = 0;
+		bool used = false;
+	};
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_freeSlots;
+	std::vector<std::shared_ptr<GameObject>> m_pendingDestroy;
+
+	// Before the objects, it has to outlive them
+	ComponentRegistry m_components;
 	std::vector<std::shared_ptr<GameObject>> m_gameObjects;
 
 	std::vector<std::shared_ptr<GameObject>> shadowCasters;
 
+	std::unique_ptr<SpatialIndex> m_spatialIndex;
+	// Per proxy id, filled by the frustum query of the main pass
+	std::vector<uint8_t> m_visible;
+	std::vector<SpatialIndex::Id> m_queryIds;
+	bool m_frustumCulling = true;
+	size_t m_visibleCount = 0;
+
 	std::shared_ptr<Camera> m_camera;
 	std::shared_ptr<CubeMap> m_cubemap;
 	std::shared_ptr<PhysicsScene> m_physicsScene;
+	PhysicsCulling m_culling;
+	WorldStreamer m_streaming;
 
 
 
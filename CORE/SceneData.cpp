@@ -0,0 +1,397 @@
+#include "SceneData.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+namespace
+{
+	// Keys keep the record order, a diff then lines up with the binary tables
+	using OrderedJson = nlohmann::ordered_json;
+
+	OrderedJson floats(const float* values, size_t count) {
+		OrderedJson array = OrderedJson::array();
+		for (size_t i = 0; i < count; i++) array.push_back(values[i]);
+		return array;
+	}
+
+	bool readFloats(const nlohmann::json& json, const char* name, float* out, size_t count) {
+		if (!json.contains(name) || !json[name].is_array() || json[name].size() != count) return false;
+		for (size_t i = 0; i < count; i++) out[i] = json[name][i].get<float>();
+		return true;
+	}
+}
+
+void SceneData::clear() {
+	m_file.close();
+	m_ownedObjects.clear();
+	m_ownedComponents.clear();
+	m_ownedProperties.clear();
+	m_ownedStrings.clear();
+	m_stringOffsets.clear();
+	m_objects = nullptr;
+	m_components = nullptr;
+	m_properties = nullptr;
+	m_strings = "";
+	m_objectCount = m_componentCount = m_propertyCount = m_stringBytes = 0;
+}
+
+void SceneData::bindOwned() {
+	m_objects = m_ownedObjects.data();
+	m_components = m_ownedComponents.data();
+	m_properties = m_ownedProperties.data();
+	m_strings = m_ownedStrings.empty() ? "" : m_ownedStrings.data();
+	m_objectCount = m_ownedObjects.size();
+	m_componentCount = m_ownedComponents.size();
+	m_propertyCount = m_ownedProperties.size();
+	m_stringBytes = m_ownedStrings.size();
+}
+
+size_t SceneData::getByteSize() const {
+	return sizeof(SceneFormat::Header) + m_objectCount * sizeof(SceneFormat::Object)
+		+ m_componentCount * sizeof(SceneFormat::Component) + m_propertyCount * sizeof(SceneFormat::Property) + m_stringBytes;
+}
+
+uint32_t SceneData::addString(const std::string& text) {
+	// Offset 0 is the empty string
+	if (m_ownedStrings.empty()) m_ownedStrings.push_back('\0');
+	if (text.empty()) return 0;
+
+	auto it = m_stringOffsets.find(text);
+	if (it != m_stringOffsets.end()) return it->second;
+	uint32_t offset = static_cast<uint32_t>(m_ownedStrings.size());
+	m_ownedStrings.insert(m_ownedStrings.end(), text.begin(), text.end());
+	m_ownedStrings.push_back('\0');
+	m_stringOffsets.emplace(text, offset);
+	return offset;
+}
+
+uint32_t SceneData::addObject(const std::string& name, const std::string& prefab, int32_t parent,
+	const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+	// Mapped data is read only, building starts over
+	if (isMapped()) clear();
+
+	SceneFormat::Object object{};
+	object.name = addString(name);
+	object.prefab = addString(prefab);
+	object.parent = parent;
+	object.firstComponent = static_cast<uint32_t>(m_ownedComponents.size());
+	object.componentCount = 0;
+	for (int i = 0; i < 3; i++) {
+		object.position[i] = position[i];
+		object.scale[i] = scale[i];
+	}
+	object.rotation[0] = rotation.x;
+	object.rotation[1] = rotation.y;
+	object.rotation[2] = rotation.z;
+	object.rotation[3] = rotation.w;
+	m_ownedObjects.push_back(object);
+	bindOwned();
+	return static_cast<uint32_t>(m_ownedObjects.size() - 1);
+}
+
+void SceneData::addComponent(const std::string& type) {
+	if (m_ownedObjects.empty()) return;
+	SceneFormat::Component component{};
+	component.type = addString(type);
+	component.firstProperty = static_cast<uint32_t>(m_ownedProperties.size());
+	m_ownedComponents.push_back(component);
+	m_ownedObjects.back().componentCount++;
+	bindOwned();
+}
+
+void SceneData::addFloat(const std::string& name, float value) {
+	if (m_ownedComponents.empty()) return;
+	addVec4(name, glm::vec4(value, 0.0f, 0.0f, 0.0f));
+	m_ownedProperties.back().kind = SceneFormat::PropertyKind::FLOAT;
+}
+
+void SceneData::addVec3(const std::string& name, const glm::vec3& value) {
+	if (m_ownedComponents.empty()) return;
+	addVec4(name, glm::vec4(value, 0.0f));
+	m_ownedProperties.back().kind = SceneFormat::PropertyKind::VEC3;
+}
+
+void SceneData::addVec4(const std::string& name, const glm::vec4& value) {
+	if (m_ownedComponents.empty()) return;
+	SceneFormat::Property property{};
+	property.name = addString(name);
+	property.kind = SceneFormat::PropertyKind::VEC4;
+	for (int i = 0; i < 4; i++) property.values[i] = value[i];
+	m_ownedProperties.push_back(property);
+	m_ownedComponents.back().propertyCount++;
+	bindOwned();
+}
+
+void SceneData::addText(const std::string& name, const std::string& value) {
+	if (m_ownedComponents.empty()) return;
+	addVec4(name, glm::vec4(0.0f));
+	m_ownedProperties.back().kind = SceneFormat::PropertyKind::TEXT;
+	m_ownedProperties.back().text = addString(value);
+	bindOwned();
+}
+
+uint32_t SceneData::copyObject(const SceneData& source, size_t index, int32_t parent) {
+	const SceneFormat::Object& object = source.getObject(index);
+	glm::vec3 position(object.position[0], object.position[1], object.position[2]);
+	glm::quat rotation(object.rotation[3], object.rotation[0], object.rotation[1], object.rotation[2]);
+	glm::vec3 scale(object.scale[0], object.scale[1], object.scale[2]);
+	uint32_t copy = addObject(source.getString(object.name), source.getString(object.prefab), parent, position, rotation, scale);
+
+	for (uint32_t c = 0; c < object.componentCount; c++) {
+		const SceneFormat::Component& component = source.getComponent(object.firstComponent + c);
+		addComponent(source.getString(component.type));
+		for (uint32_t p = 0; p < component.propertyCount; p++) {
+			SceneFormat::Property property = source.getProperty(component.firstProperty + p);
+			property.name = addString(source.getString(property.name));
+			property.text = addString(source.getString(property.text));
+			m_ownedProperties.push_back(property);
+			m_ownedComponents.back().propertyCount++;
+		}
+	}
+	bindOwned();
+	return copy;
+}
+
+bool SceneData::load(const std::string& path) {
+	clear();
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "Failed to open scene file " << path << std::endl;
+		return false;
+	}
+	uint32_t magic = 0;
+	file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	file.close();
+	return magic == SceneFormat::magic ? loadBinary(path) : loadJson(path);
+}
+
+bool SceneData::loadBinary(const std::string& path) {
+	if (!m_file.open(path)) {
+		std::cerr << "Failed to map scene file " << path << std::endl;
+		return false;
+	}
+
+	const uint8_t* data = m_file.data();
+	size_t size = m_file.size();
+	SceneFormat::Header header;
+	if (size < sizeof(header)) {
+		clear();
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != SceneFormat::magic || header.version != SceneFormat::version) {
+		std::cerr << "Scene file " << path << " has version " << header.version << ", expected " << SceneFormat::version << std::endl;
+		clear();
+		return false;
+	}
+
+	size_t objectsOffset = sizeof(header);
+	size_t componentsOffset = objectsOffset + header.objectCount * sizeof(SceneFormat::Object);
+	size_t propertiesOffset = componentsOffset + header.componentCount * sizeof(SceneFormat::Component);
+	size_t stringsOffset = propertiesOffset + header.propertyCount * sizeof(SceneFormat::Property);
+	if (stringsOffset + header.stringBytes > size || header.stringBytes == 0 || data[stringsOffset + header.stringBytes - 1] != '\0') {
+		std::cerr << "Scene file " << path << " is truncated" << std::endl;
+		clear();
+		return false;
+	}
+
+	// The mapping is page aligned and every record a multiple of 4 bytes
+	m_objects = reinterpret_cast<const SceneFormat::Object*>(data + objectsOffset);
+	m_components = reinterpret_cast<const SceneFormat::Component*>(data + componentsOffset);
+	m_properties = reinterpret_cast<const SceneFormat::Property*>(data + propertiesOffset);
+	m_strings = reinterpret_cast<const char*>(data + stringsOffset);
+	m_objectCount = header.objectCount;
+	m_componentCount = header.componentCount;
+	m_propertyCount = header.propertyCount;
+	m_stringBytes = header.stringBytes;
+
+	// Indices come from the file, checked once here rather than on every read
+	for (size_t i = 0; i < m_objectCount; i++) {
+		const SceneFormat::Object& object = m_objects[i];
+		if (object.name >= m_stringBytes || object.prefab >= m_stringBytes || object.parent >= static_cast<int32_t>(i)
+			|| static_cast<size_t>(object.firstComponent) + object.componentCount > m_componentCount) {
+			std::cerr << "Scene file " << path << " has a broken object record " << i << std::endl;
+			clear();
+			return false;
+		}
+	}
+	for (size_t i = 0; i < m_componentCount; i++) {
+		const SceneFormat::Component& component = m_components[i];
+		if (component.type >= m_stringBytes || static_cast<size_t>(component.firstProperty) + component.propertyCount > m_propertyCount) {
+			std::cerr << "Scene file " << path << " has a broken component record " << i << std::endl;
+			clear();
+			return false;
+		}
+	}
+	for (size_t i = 0; i < m_propertyCount; i++) {
+		if (m_properties[i].name >= m_stringBytes || m_properties[i].text >= m_stringBytes) {
+			std::cerr << "Scene file " << path << " has a broken property record " << i << std::endl;
+			clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SceneData::loadJson(const std::string& path) {
+	std::ifstream file(path);
+	try {
+		auto json = nlohmann::json::parse(file, nullptr, true, true);
+		if (json.value("version", SceneFormat::version) != SceneFormat::version) {
+			std::cerr << "Scene file " << path << " has another version" << std::endl;
+			return false;
+		}
+
+		for (const auto& object : json.value("objects", nlohmann::json::array())) {
+			float position[3] = { 0.0f, 0.0f, 0.0f };
+			float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			float scale[3] = { 1.0f, 1.0f, 1.0f };
+			readFloats(object, "position", position, 3);
+			readFloats(object, "rotation", rotation, 4);
+			readFloats(object, "scale", scale, 3);
+			int32_t parent = object.value("parent", -1);
+			if (parent >= static_cast<int32_t>(m_ownedObjects.size())) {
+				std::cerr << "Scene file " << path << ": parents come before their children" << std::endl;
+				parent = -1;
+			}
+			addObject(object.value("name", std::string()), object.value("prefab", std::string()), parent,
+				glm::vec3(position[0], position[1], position[2]),
+				glm::quat(rotation[3], rotation[0], rotation[1], rotation[2]),
+				glm::vec3(scale[0], scale[1], scale[2]));
+
+			for (const auto& component : object.value("components", nlohmann::json::array())) {
+				addComponent(component.value("type", std::string()));
+				for (auto it = component.begin(); it != component.end(); ++it) {
+					if (it.key() == "type") continue;
+					const nlohmann::json& value = it.value();
+					if (value.is_number()) {
+						addFloat(it.key(), value.get<float>());
+					}
+					else if (value.is_string()) {
+						addText(it.key(), value.get<std::string>());
+					}
+					else if (value.is_array() && value.size() == 3) {
+						addVec3(it.key(), glm::vec3(value[0].get<float>(), value[1].get<float>(), value[2].get<float>()));
+					}
+					else if (value.is_array() && value.size() == 4) {
+						addVec4(it.key(), glm::vec4(value[0].get<float>(), value[1].get<float>(), value[2].get<float>(), value[3].get<float>()));
+					}
+					else {
+						std::cerr << "Scene file " << path << ": unsupported value for " << it.key() << std::endl;
+					}
+				}
+			}
+		}
+	}
+	catch (const nlohmann::json::exception& e) {
+		std::cerr << "Error loading scene file " << path << ": " << e.what() << std::endl;
+		clear();
+		return false;
+	}
+	// Lookups are only needed while building
+	m_stringOffsets.clear();
+	return true;
+}
+
+bool SceneData::saveBinary(const std::string& path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "Failed to write scene file " << path << std::endl;
+		return false;
+	}
+
+	SceneFormat::Header header{};
+	header.magic = SceneFormat::magic;
+	header.version = SceneFormat::version;
+	header.objectCount = static_cast<uint32_t>(m_objectCount);
+	header.componentCount = static_cast<uint32_t>(m_componentCount);
+	header.propertyCount = static_cast<uint32_t>(m_propertyCount);
+	// Always at least the empty string
+	static const char empty = '\0';
+	const char* strings = m_stringBytes > 0 ? m_strings : &empty;
+	header.stringBytes = static_cast<uint32_t>(m_stringBytes > 0 ? m_stringBytes : 1);
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(m_objects), m_objectCount * sizeof(SceneFormat::Object));
+	file.write(reinterpret_cast<const char*>(m_components), m_componentCount * sizeof(SceneFormat::Component));
+	file.write(reinterpret_cast<const char*>(m_properties), m_propertyCount * sizeof(SceneFormat::Property));
+	file.write(strings, header.stringBytes);
+	return file.good();
+}
+
+bool SceneData::saveJson(const std::string& path) const {
+	OrderedJson objects = OrderedJson::array();
+	for (size_t i = 0; i < m_objectCount; i++) {
+		const SceneFormat::Object& object = m_objects[i];
+		OrderedJson entry;
+		entry["name"] = getString(object.name);
+		if (object.prefab) entry["prefab"] = getString(object.prefab);
+		if (object.parent >= 0) entry["parent"] = object.parent;
+		entry["position"] = floats(object.position, 3);
+		entry["rotation"] = floats(object.rotation, 4);
+		entry["scale"] = floats(object.scale, 3);
+
+		OrderedJson components = OrderedJson::array();
+		for (uint32_t c = 0; c < object.componentCount; c++) {
+			const SceneFormat::Component& component = m_components[object.firstComponent + c];
+			OrderedJson values;
+			values["type"] = getString(component.type);
+			for (uint32_t p = 0; p < component.propertyCount; p++) {
+				const SceneFormat::Property& property = m_properties[component.firstProperty + p];
+				const char* name = getString(property.name);
+				switch (property.kind) {
+				case SceneFormat::PropertyKind::FLOAT: values[name] = property.values[0]; break;
+				case SceneFormat::PropertyKind::VEC3: values[name] = floats(property.values, 3); break;
+				case SceneFormat::PropertyKind::VEC4: values[name] = floats(property.values, 4); break;
+				case SceneFormat::PropertyKind::TEXT: values[name] = getString(property.text); break;
+				}
+			}
+			components.push_back(values);
+		}
+		if (!components.empty()) entry["components"] = components;
+		objects.push_back(entry);
+	}
+
+	OrderedJson json;
+	json["version"] = SceneFormat::version;
+	json["objects"] = objects;
+
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "Failed to write scene file " << path << std::endl;
+		return false;
+	}
+	file << json.dump(2) << std::endl;
+	return file.good();
+}
+
+const SceneFormat::Property* ComponentProperties::find(const char* name) const {
+	for (uint32_t i = 0; i < m_component.propertyCount; i++) {
+		const SceneFormat::Property& property = m_data.getProperty(m_component.firstProperty + i);
+		if (std::strcmp(m_data.getString(property.name), name) == 0) return &property;
+	}
+	return nullptr;
+}
+
+float ComponentProperties::getFloat(const char* name, float fallback) const {
+	const SceneFormat::Property* property = find(name);
+	return property && property->kind == SceneFormat::PropertyKind::FLOAT ? property->values[0] : fallback;
+}
+
+glm::vec3 ComponentProperties::getVec3(const char* name, const glm::vec3& fallback) const {
+	const SceneFormat::Property* property = find(name);
+	if (!property || property->kind != SceneFormat::PropertyKind::VEC3) return fallback;
+	return glm::vec3(property->values[0], property->values[1], property->values[2]);
+}
+
+glm::vec4 ComponentProperties::getVec4(const char* name, const glm::vec4& fallback) const {
+	const SceneFormat::Property* property = find(name);
+	if (!property || property->kind != SceneFormat::PropertyKind::VEC4) return fallback;
+	return glm::vec4(property->values[0], property->values[1], property->values[2], property->values[3]);
+}
+
+std::string ComponentProperties::getText(const char* name, const std::string& fallback) const {
+	const SceneFormat::Property* property = find(name);
+	return property && property->kind == SceneFormat::PropertyKind::TEXT ? m_data.getString(property->text) : fallback;
+}
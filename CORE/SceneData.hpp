@@ -0,0 +1,138 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "MappedFile.hpp"
+
+// Layout of the binary scene file: a header, then the object, component and property
+// tables, then a blob of NUL terminated strings. Records point at strings by offset and
+// at each other by index, so a mapped file is read in place without parsing.
+namespace SceneFormat
+{
+	const uint32_t magic = 0x53434C43; // "CLCS"
+	const uint32_t version = 1;
+
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t objectCount;
+		uint32_t componentCount;
+		uint32_t propertyCount;
+		uint32_t stringBytes;
+	};
+
+	// Transform is local to the parent
+	struct Object {
+		uint32_t name;            // string offsets, 0 is the empty string
+		uint32_t prefab;          // instantiated with PrefabManager when set and the object lists no component
+		int32_t parent;           // object index, -1 for roots
+		uint32_t firstComponent;
+		uint32_t componentCount;
+		float position[3];
+		float rotation[4];        // quaternion x y z w
+		float scale[3];
+	};
+
+	struct Component {
+		uint32_t type;            // name given to SceneFile::registerComponent
+		uint32_t firstProperty;
+		uint32_t propertyCount;
+	};
+
+	enum class PropertyKind : uint32_t { FLOAT, VEC3, VEC4, TEXT };
+
+	struct Property {
+		uint32_t name;
+		PropertyKind kind;
+		float values[4];
+		uint32_t text;
+	};
+
+	static_assert(sizeof(Header) % 4 == 0 && sizeof(Object) % 4 == 0 && sizeof(Component) % 4 == 0 && sizeof(Property) % 4 == 0,
+		"Scene file records must keep 4 byte alignment");
+}
+
+// Tables of a scene file, built by SceneFile::capture or read from disk. A binary file
+// stays mapped and is read in place, a JSON file (same tables as nested objects, for
+// diffing and hand editing) is parsed into owned tables. Holds no engine object, so it
+// can be loaded on any thread.
+class SceneData {
+public:
+	SceneData() = default;
+	SceneData(SceneData&&) = default;
+	SceneData& operator=(SceneData&&) = default;
+
+	// Binary or JSON, told apart by the first bytes
+	bool load(const std::string& path);
+	bool saveBinary(const std::string& path) const;
+	bool saveJson(const std::string& path) const;
+	void clear();
+
+	// Building, components go to the last object and properties to the last component
+	uint32_t addObject(const std::string& name, const std::string& prefab, int32_t parent,
+		const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+	void addComponent(const std::string& type);
+	void addFloat(const std::string& name, float value);
+	void addVec3(const std::string& name, const glm::vec3& value);
+	void addVec4(const std::string& name, const glm::vec4& value);
+	void addText(const std::string& name, const std::string& value);
+	// Object `index` of another SceneData with its components, under `parent` here
+	uint32_t copyObject(const SceneData& source, size_t index, int32_t parent);
+
+	size_t getObjectCount() const { return m_objectCount; }
+	size_t getComponentCount() const { return m_componentCount; }
+	const SceneFormat::Object& getObject(size_t index) const { return m_objects[index]; }
+	const SceneFormat::Component& getComponent(size_t index) const { return m_components[index]; }
+	const SceneFormat::Property& getProperty(size_t index) const { return m_properties[index]; }
+	const char* getString(uint32_t offset) const { return m_strings + offset; }
+
+	bool isMapped() const { return m_file.isOpen(); }
+	// Bytes of the tables, mapped or owned
+	size_t getByteSize() const;
+
+private:
+	bool loadBinary(const std::string& path);
+	bool loadJson(const std::string& path);
+	uint32_t addString(const std::string& text);
+	// Points the views at the owned tables, after they grew
+	void bindOwned();
+
+	// Views, into the mapped file or the owned tables
+	const SceneFormat::Object* m_objects = nullptr;
+	const SceneFormat::Component* m_components = nullptr;
+	const SceneFormat::Property* m_properties = nullptr;
+	const char* m_strings = "";
+	size_t m_objectCount = 0;
+	size_t m_componentCount = 0;
+	size_t m_propertyCount = 0;
+	size_t m_stringBytes = 0;
+
+	MappedFile m_file;
+	std::vector<SceneFormat::Object> m_ownedObjects;
+	std::vector<SceneFormat::Component> m_ownedComponents;
+	std::vector<SceneFormat::Property> m_ownedProperties;
+	std::vector<char> m_ownedStrings;
+	std::unordered_map<std::string, uint32_t> m_stringOffsets;
+};
+
+// Properties of one component record, looked up by name, the fallback when missing
+class ComponentProperties {
+public:
+	ComponentProperties(const SceneData& data, const SceneFormat::Component& component)
+		: m_data(data), m_component(component) {}
+
+	bool has(const char* name) const { return find(name) != nullptr; }
+	float getFloat(const char* name, float fallback) const;
+	glm::vec3 getVec3(const char* name, const glm::vec3& fallback) const;
+	glm::vec4 getVec4(const char* name, const glm::vec4& fallback) const;
+	std::string getText(const char* name, const std::string& fallback) const;
+
+private:
+	const SceneFormat::Property* find(const char* name) const;
+
+	const SceneData& m_data;
+	const SceneFormat::Component& m_component;
+};
@@ -0,0 +1,311 @@
+#include "SceneFile.hpp"
+#include "Scene.hpp"
+#include "Engine.hpp"
+#include "Prefabs/PrefabManager.hpp"
+#include "RenderComponents/CubeRenderer.hpp"
+#include "RenderComponents/SphereRenderer.hpp"
+#include "RenderComponents/ModelRenderer.hpp"
+#include "PhysicsComponents/CubePhysics.hpp"
+#include "PhysicsComponents/SpherePhysics.hpp"
+#include "PhysicsComponents/MeshPhysics.hpp"
+#include "Lights/LightManager.hpp"
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace SceneFile
+{
+	namespace Internal
+	{
+		struct Serializer {
+			std::string name;
+			SaveFunction save;
+			LoadFunction load;
+		};
+		std::unordered_map<std::string, Serializer> byName;
+		// Indexed by ComponentType id
+		std::vector<const Serializer*> byType(ComponentType::Count, nullptr);
+
+		double elapsedMs(std::chrono::steady_clock::time_point start) {
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		bool endsWith(const std::string& text, const std::string& suffix) {
+			return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+		}
+
+		// Properties shared by every physics component
+		void savePhysics(PhysicsComponent& physics, SceneData& data) {
+			data.addText("body", physics.getType() == PhysicsComponent::Type::DYNAMIC ? "dynamic" : "static");
+			data.addFloat("mass", physics.getMass());
+			if (physics.isTrigger()) data.addFloat("trigger", 1.0f);
+		}
+
+		PhysicsComponent::Type loadBodyType(const ComponentProperties& properties) {
+			return properties.getText("body", "static") == "dynamic" ? PhysicsComponent::Type::DYNAMIC : PhysicsComponent::Type::STATIC;
+		}
+
+		void loadPhysics(PhysicsComponent& physics, const ComponentProperties& properties) {
+			if (properties.has("mass")) physics.setMass(properties.getFloat("mass", 1.0f));
+			if (properties.getFloat("trigger", 0.0f) != 0.0f) physics.setTrigger(true);
+		}
+
+		void saveRender(RenderComponent& render, SceneData& data) {
+			data.addVec4("color", render.getColor());
+			if (!render.getTextures().empty() && !render.getTextures()[0]->path.empty())
+				data.addText("texture", render.getTextures()[0]->path);
+		}
+
+		void loadRender(RenderComponent& render, const ComponentProperties& properties) {
+			render.setColor(properties.getVec4("color", glm::vec4(1.0f)));
+			std::string path = properties.getText("texture", "");
+			if (path.empty()) return;
+			std::shared_ptr<Texture> texture = TextureManager::getTexture(path);
+			if (!texture) texture = TextureManager::loadTexture(path, path);
+			if (texture) render.addTexture(texture);
+		}
+
+		const char* toString(LightType type) {
+			switch (type) {
+			case LightType::DIRECTIONAL: return "directional";
+			case LightType::SPOT: return "spot";
+			default: return "point";
+			}
+		}
+
+		LightType toLightType(const std::string& text) {
+			if (text == "directional") return LightType::DIRECTIONAL;
+			if (text == "spot") return LightType::SPOT;
+			return LightType::POINT;
+		}
+	}
+
+	void registerComponent(const std::string& name, uint32_t typeId, SaveFunction save, LoadFunction load) {
+		Internal::Serializer& serializer = Internal::byName[name];
+		serializer.name = name;
+		serializer.save = std::move(save);
+		serializer.load = std::move(load);
+		if (typeId < Internal::byType.size())
+			Internal::byType[typeId] = &serializer;
+	}
+
+	void registerBuiltinComponents() {
+		// Renderers are skipped headless, the physics stays identical
+		registerComponent("CubeRenderer", ComponentType::CubeRenderer,
+			[](Component& component, SceneData& data) {
+				Internal::saveRender(static_cast<RenderComponent&>(component), data);
+			},
+			[](GameObject& gameObject, const ComponentProperties& properties) {
+				if (Engine::isHeadless()) return;
+				Internal::loadRender(*gameObject.addComponent<CubeRenderer>(), properties);
+			});
+
+		registerComponent("SphereRenderer", ComponentType::SphereRenderer,
+			[](Component& component, SceneData& data) {
+				auto& sphere = static_cast<SphereRenderer&>(component);
+				data.addFloat("radius", sphere.getRadius());
+				data.addFloat("sectors", static_cast<float>(sphere.getSectorCount()));
+				data.addFloat("stacks", static_cast<float>(sphere.getStackCount()));
+				Internal::saveRender(sphere, data);
+			},
+			[](GameObject& gameObject, const ComponentProperties& properties) {
+				if (Engine::isHeadless()) return;
+				auto sphere = gameObject.addComponent<SphereRenderer>(properties.getFloat("radius", 1.0f),
+					static_cast<unsigned int>(properties.getFloat("sectors", 36.0f)),
+					static_cast<unsigned int>(properties.getFloat("stacks", 18.0f)));
+				Internal::loadRender(*sphere, properties);
+			});
+
+		registerComponent("ModelRenderer", ComponentType::ModelRenderer,
+			[](Component& component, SceneData& data) {
+				auto& model = static_cast<ModelRenderer&>(component);
+				data.addText("path", model.getPath());
+				data.addVec4("color", model.getColor());
+			},
+			[](GameObject& gameObject, const ComponentProperties& properties) {
+				// MeshPhysics needs the meshes, headless too
+				auto model = gameObject.addComponent<ModelRenderer>(properties.getText("path", ""));
+				model->setColor(properties.getVec4("color", glm::vec4(1.0f)));
+			});
+
+		registerComponent("CubePhysics", ComponentType::CubePhysics,
+			[](Component& component, SceneData& data) {
+				Internal::savePhysics(static_cast<PhysicsComponent&>(component), data);
+			},
+			[](GameObject& gameObject, const ComponentProperties& properties) {
+				auto physics = gameObject.addComponent<CubePhysics>(Internal::loadBodyType(properties));
+				Internal::loadPhysics(*physics, properties);
+			});
+
+		registerComponent("SpherePhysics", ComponentType::SpherePhysics,
+			[](Component& component, SceneData& data) {
+				Internal::savePhysics(static_cast<PhysicsComponent&>(component), data);
+			},
+			[](GameObject& gameObject, const ComponentProperties& properties) {
+				auto physics = gameObject.addComponent<SpherePhysics>(Internal::loadBodyType(properties));
+				Internal::loadPhysics(*physics, properties);
+			});
+
+		registerComponent("MeshPhysics", ComponentType::MeshPhysics,
+			[](Component& component, SceneData& data) {
+				auto& mesh = static_cast<MeshPhysics&>(component);
+				data.addText("shape", mesh.getShape() == MeshPhysics::Shape::CONVEX ? "convex" : "triangles");
+				Internal::savePhysics(mesh, data);
+			},
+			[](GameObject& gameObject, const ComponentProperties& properties) {
+				std::string shape = properties.getText("shape", "");
+				MeshPhysics::Shape meshShape = shape == "convex" ? MeshPhysics::Shape::CONVEX
+					: shape == "triangles" ? MeshPhysics::Shape::TRIANGLE_MESH : MeshPhysics::Shape::AUTO;
+				auto physics = gameObject.addComponent<MeshPhysics>(Internal::loadBodyType(properties), meshShape);
+				Internal::loadPhysics(*physics, properties);
+			});
+
+		registerComponent("Light", ComponentType::Light,
+			[](Component& component, SceneData& data) {
+				auto& light = static_cast<Light&>(component);
+				data.addText("type", Internal::toString(light.getType()));
+				data.addVec3("color", light.getColor());
+				data.addFloat("intensity", light.getIntensity());
+				data.addVec3("direction", light.getDirection());
+			},
+			[](GameObject& gameObject, const ComponentProperties& properties) {
+				auto light = gameObject.addComponent<Light>(Internal::toLightType(properties.getText("type", "point")),
+					gameObject.getWorldPosition(), properties.getVec3("direction", glm::vec3(0.0f)),
+					properties.getVec3("color", glm::vec3(1.0f)), properties.getFloat("intensity", 1.0f));
+				if (!Engine::isHeadless())
+					LightManager::addLight(light);
+			});
+	}
+
+	void capture(const std::vector<std::shared_ptr<GameObject>>& gameObjects, SceneData& data) {
+		// Parents first, SceneData requires it: a stable order by depth keeps siblings in place
+		std::vector<GameObject*> ordered;
+		ordered.reserve(gameObjects.size());
+		for (const auto& gameObject : gameObjects) ordered.push_back(gameObject.get());
+		auto depth = [](const GameObject* gameObject) {
+			size_t levels = 0;
+			for (const Transform* parent = gameObject->getParent(); parent; parent = parent->getParent()) levels++;
+			return levels;
+		};
+		std::stable_sort(ordered.begin(), ordered.end(), [&](const GameObject* a, const GameObject* b) {
+			return depth(a) < depth(b);
+		});
+		std::unordered_map<const Transform*, int32_t> indices;
+		indices.reserve(ordered.size());
+		const int32_t first = static_cast<int32_t>(data.getObjectCount());
+		for (size_t i = 0; i < ordered.size(); i++)
+			indices[ordered[i]] = first + static_cast<int32_t>(i);
+
+		size_t unsupported = 0;
+		for (GameObject* gameObject : ordered) {
+			auto parent = gameObject->getParent() ? indices.find(gameObject->getParent()) : indices.end();
+			// A parent outside the list: the object is saved where it is in the world
+			bool keepLocal = !gameObject->getParent() || parent != indices.end();
+			glm::vec3 position = gameObject->getPosition();
+			glm::quat rotation = gameObject->getRotationQuaternion();
+			glm::vec3 scale = gameObject->getScale();
+			if (!keepLocal) {
+				const glm::mat4& world = gameObject->getModelMatrix();
+				position = glm::vec3(world[3]);
+				scale = glm::vec3(glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2])));
+				rotation = glm::normalize(glm::quat_cast(glm::mat3(glm::vec3(world[0]) / scale.x,
+					glm::vec3(world[1]) / scale.y, glm::vec3(world[2]) / scale.z)));
+			}
+
+			data.addObject(gameObject->getName(), "", keepLocal && gameObject->getParent() ? parent->second : -1,
+				position, rotation, scale);
+			gameObject->forEachComponent<Component>([&](Component* component) {
+				const Internal::Serializer* serializer = Internal::byType[component->getTypeId()];
+				if (!serializer) {
+					unsupported++;
+					return;
+				}
+				data.addComponent(serializer->name);
+				serializer->save(*component, data);
+			});
+		}
+		if (unsupported)
+			std::cerr << "SceneFile: " << unsupported << " components without a serializer were not saved" << std::endl;
+	}
+
+	void createObjects(Scene& scene, const SceneData& data, size_t end, std::vector<std::shared_ptr<GameObject>>& objects, LoadStats* stats) {
+		auto start = std::chrono::steady_clock::now();
+		LoadStats local;
+		LoadStats& out = stats ? *stats : local;
+		const size_t begin = objects.size();
+		end = std::min(end, data.getObjectCount());
+
+		SceneMemory::Scope scope(scene.getMemory());
+		for (size_t i = begin; i < end; i++) {
+			const SceneFormat::Object& record = data.getObject(i);
+			glm::vec3 position(record.position[0], record.position[1], record.position[2]);
+			glm::quat rotation(record.rotation[3], record.rotation[0], record.rotation[1], record.rotation[2]);
+			glm::vec3 scale(record.scale[0], record.scale[1], record.scale[2]);
+
+			std::shared_ptr<GameObject> gameObject;
+			const char* prefab = data.getString(record.prefab);
+			if (record.componentCount == 0 && prefab[0] != '\0') {
+				gameObject = PrefabManager::instantiate(prefab, position);
+				if (!gameObject) {
+					std::cerr << "SceneFile: unknown prefab " << prefab << std::endl;
+					gameObject = GameObject::create(data.getString(record.name));
+				}
+			}
+			else {
+				gameObject = GameObject::create(data.getString(record.name));
+			}
+
+			// Parent first: physics components read the pose when they create their actor
+			if (record.parent >= 0)
+				gameObject->setParent(objects[record.parent].get());
+			// Also moves the body of a prefab, nothing else has one yet
+			gameObject->setPosition(position);
+			gameObject->setRotationQuaternion(rotation);
+			gameObject->setScale(scale);
+
+			for (uint32_t c = 0; c < record.componentCount; c++) {
+				const SceneFormat::Component& component = data.getComponent(record.firstComponent + c);
+				auto serializer = Internal::byName.find(data.getString(component.type));
+				if (serializer == Internal::byName.end()) {
+					if (out.skippedComponents++ == 0)
+						std::cerr << "SceneFile: no serializer for " << data.getString(component.type) << std::endl;
+					continue;
+				}
+				serializer->second.load(*gameObject, ComponentProperties(data, component));
+				out.components++;
+			}
+			objects.push_back(gameObject);
+		}
+		out.objects += end - begin;
+		out.createMs += Internal::elapsedMs(start);
+	}
+
+	bool instantiate(Scene& scene, const SceneData& data, LoadStats* stats, std::vector<std::shared_ptr<GameObject>>* created) {
+		std::vector<std::shared_ptr<GameObject>> objects;
+		objects.reserve(data.getObjectCount());
+		createObjects(scene, data, data.getObjectCount(), objects, stats);
+
+		auto start = std::chrono::steady_clock::now();
+		scene.addGameObjects(objects);
+		if (stats) stats->addMs += Internal::elapsedMs(start);
+
+		if (created)
+			created->insert(created->end(), objects.begin(), objects.end());
+		return true;
+	}
+
+	bool save(Scene& scene, const std::string& path) {
+		SceneData data;
+		capture(scene.getGameObjects(), data);
+		return Internal::endsWith(path, ".json") ? data.saveJson(path) : data.saveBinary(path);
+	}
+
+	bool load(Scene& scene, const std::string& path, LoadStats* stats) {
+		auto start = std::chrono::steady_clock::now();
+		SceneData data;
+		if (!data.load(path)) return false;
+		if (stats) stats->readMs += Internal::elapsedMs(start);
+		return instantiate(scene, data, stats);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+#include "SceneData.hpp"
+
+class Scene;
+class GameObject;
+class Component;
+
+// Saving and loading scene objects through SceneData. Each component type is written
+// by a registered serializer as named properties, so files survive new fields and
+// components without a serializer are skipped with a warning.
+//
+// Loading is split so the slow part can leave the main thread: SceneData::load (file
+// read, or just a mapping for a binary file) runs anywhere, instantiate builds the
+// objects on the main thread and adds every physics actor in one PhysX call.
+namespace SceneFile
+{
+	using SaveFunction = std::function<void(Component& component, SceneData& data)>;
+	using LoadFunction = std::function<void(GameObject& gameObject, const ComponentProperties& properties)>;
+
+	// `name` is what the files store, typeId the ComponentType of the component
+	void registerComponent(const std::string& name, uint32_t typeId, SaveFunction save, LoadFunction load);
+	// Renderers, physics components and lights of the engine
+	void registerBuiltinComponents();
+
+	struct LoadStats {
+		size_t objects = 0;
+		size_t components = 0;
+		size_t skippedComponents = 0;
+		double readMs = 0.0;      // SceneData::load, 0 for instantiate alone
+		double createMs = 0.0;    // objects and components
+		double addMs = 0.0;       // Scene::addGameObjects
+	};
+
+	// Appends the objects, parents are stored as indices when they are in the list
+	void capture(const std::vector<std::shared_ptr<GameObject>>& gameObjects, SceneData& data);
+	// Creates the objects of `data` from objects.size() up to `end` in the scene memory and
+	// appends them to `objects`, which holds the ones created before (parents are looked up
+	// there). They are not in the scene yet: a large file can be created a slice per frame.
+	void createObjects(Scene& scene, const SceneData& data, size_t end,
+		std::vector<std::shared_ptr<GameObject>>& objects, LoadStats* stats = nullptr);
+	// Creates the objects of `data` in the scene memory and adds them as one batch.
+	// `created` receives them in file order when set.
+	bool instantiate(Scene& scene, const SceneData& data, LoadStats* stats = nullptr,
+		std::vector<std::shared_ptr<GameObject>>* created = nullptr);
+
+	// Every object of the scene, JSON when the path ends in ".json", binary otherwise
+	bool save(Scene& scene, const std::string& path);
+	bool load(Scene& scene, const std::string& path, LoadStats* stats = nullptr);
+}
@@ -0,0 +1,50 @@
+#include "SceneMemory.hpp"
+#include <algorithm>
+
+namespace
+{
+	thread_local SceneMemory* currentMemory = nullptr;
+
+	std::pmr::pool_options poolOptions() {
+		std::pmr::pool_options options;
+		options.largest_required_pool_block = SceneMemory::largestPooledBlock;
+		return options;
+	}
+}
+
+SceneMemory::SceneMemory(size_t initialBlockSize)
+	: m_blocks(initialBlockSize, std::pmr::new_delete_resource()), m_pools(poolOptions(), &m_blocks) {}
+
+SceneMemory::Scope::Scope(SceneMemory& memory) : m_previous(currentMemory) {
+	currentMemory = &memory;
+}
+
+SceneMemory::Scope::~Scope() {
+	currentMemory = m_previous;
+}
+
+SceneMemory* SceneMemory::getCurrent() {
+	return currentMemory;
+}
+
+void* SceneMemory::do_allocate(size_t bytes, size_t alignment) {
+	// The monotonic blocks never give memory back, big blocks would pile up there
+	void* p = bytes > largestPooledBlock
+		? std::pmr::new_delete_resource()->allocate(bytes, alignment)
+		: m_pools.allocate(bytes, alignment);
+
+	m_liveCount++;
+	m_liveBytes += bytes;
+	m_peakBytes = std::max(m_peakBytes, m_liveBytes);
+	return p;
+}
+
+void SceneMemory::do_deallocate(void* p, size_t bytes, size_t alignment) {
+	if (bytes > largestPooledBlock)
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	else
+		m_pools.deallocate(p, bytes, alignment);
+
+	m_liveCount--;
+	m_liveBytes -= bytes;
+}
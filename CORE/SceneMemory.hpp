@@ -0,0 +1,46 @@
+#pragma once
+#include <memory_resource>
+#include <cstddef>
+
+// Memory of the objects of one Scene: the GameObjects, their components (with the
+// shared_ptr control blocks), names and component lists. Requests are served by
+// size-class pools (std::pmr::unsynchronized_pool_resource) carved from large blocks
+// (std::pmr::monotonic_buffer_resource). Freed slots go back to their pool, so a scene
+// spawning and despawning at a steady rate stops touching the global heap once warm,
+// and destroying the SceneMemory hands every block back at once. Main thread only.
+class SceneMemory : public std::pmr::memory_resource {
+public:
+	// Bigger requests bypass the pools and go to the global heap
+	static constexpr size_t largestPooledBlock = 4096;
+
+	explicit SceneMemory(size_t initialBlockSize = 256 * 1024);
+
+	// GameObject::create and PrefabManager::instantiate allocate from the memory of the
+	// innermost live Scope of the thread, from the global heap without one
+	class Scope {
+	public:
+		explicit Scope(SceneMemory& memory);
+		~Scope();
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	private:
+		SceneMemory* m_previous;
+	};
+	static SceneMemory* getCurrent();
+
+	size_t getLiveCount() const { return m_liveCount; }
+	size_t getLiveBytes() const { return m_liveBytes; }
+	size_t getPeakBytes() const { return m_peakBytes; }
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	std::pmr::monotonic_buffer_resource m_blocks;
+	std::pmr::unsynchronized_pool_resource m_pools;
+
+	size_t m_liveCount = 0;
+	size_t m_liveBytes = 0;
+	size_t m_peakBytes = 0;
+};
@@ -289,6 +289,14 @@ void ShaderProgram::setVec4(const std::string& name, float x, float y, float z,
     }
 }
 
+void ShaderProgram::setMat3(const std::string& name, const glm::mat3& value) {
+    if (GLint loc = getUniformLocation(name); loc != -1) {
+        GL_CLEAR_ERROR();
+        glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(value));
+        GL_CHECK_ERROR();
+    }
+}
+
 void ShaderProgram::setMat4(const std::string& name, const glm::mat4& value) {
     if (GLint loc = getUniformLocation(name); loc != -1) {
         GL_CLEAR_ERROR();
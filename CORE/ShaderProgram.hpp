@@ -51,6 +51,7 @@ public:
     void setVec3(const std::string& name, float x, float y, float z);
     void setVec3(const std::string& name, const glm::vec3& value);
     void setVec4(const std::string& name, float x, float y, float z, float w);
+    void setMat3(const std::string& name, const glm::mat3& value);
     void setMat4(const std::string& name, const glm::mat4& value);
     void setMat4(const std::string& name, const float* value);
     void setTexture(const std::string& name, int texture, int slot);
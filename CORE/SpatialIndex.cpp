@@ -0,0 +1,494 @@
+#include "SpatialIndex.hpp"
+#include <nlohmann/json.hpp>
+#include <unordered_map>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <cmath>
+
+namespace
+{
+	constexpr float infinity = std::numeric_limits<float>::max();
+	// Empty grid cells are kept below this
+	constexpr size_t minSweep = 4096;
+
+	void removeId(std::vector<SpatialIndex::Id>& ids, SpatialIndex::Id id) {
+		for (size_t i = 0; i < ids.size(); i++) {
+			if (ids[i] == id) {
+				ids[i] = ids.back();
+				ids.pop_back();
+				return;
+			}
+		}
+	}
+
+	glm::vec3 readVec3(const nlohmann::json& json, const char* name, const glm::vec3& fallback) {
+		if (!json.contains(name) || !json[name].is_array() || json[name].size() != 3) return fallback;
+		return glm::vec3(json[name][0].get<float>(), json[name][1].get<float>(), json[name][2].get<float>());
+	}
+
+	// Uniform cells hashed by coordinates, a proxy is listed in every cell its box touches
+	class HashGridIndex : public SpatialIndex {
+	public:
+		explicit HashGridIndex(const Settings& settings) : SpatialIndex(settings) {
+			m_cellSize = std::max(settings.cellSize, 0.001f);
+		}
+
+	protected:
+		void placeProxy(Id id) override {
+			Proxy& proxy = m_proxies[id];
+			cellRange(proxy.bounds, proxy.cellMin, proxy.cellMax);
+			if (isOversized(proxy)) {
+				m_oversized.push_back(id);
+				return;
+			}
+			forEachCell(proxy, [&](const glm::ivec3& coord) {
+				Cell& cell = m_cells[key(coord)];
+				cell.coord = coord;
+				if (cell.ids.empty() && cell.ids.capacity() > 0) m_emptyCells--;
+				cell.ids.push_back(id);
+			});
+		}
+
+		void moveProxy(Id id) override {
+			Proxy& proxy = m_proxies[id];
+			glm::ivec3 cellMin, cellMax;
+			cellRange(proxy.bounds, cellMin, cellMax);
+			// Same cells, the box alone changed
+			if (cellMin == proxy.cellMin && cellMax == proxy.cellMax) return;
+
+			removeProxy(id);
+			placeProxy(id);
+		}
+
+		void removeProxy(Id id) override {
+			Proxy& proxy = m_proxies[id];
+			if (isOversized(proxy)) {
+				removeId(m_oversized, id);
+				return;
+			}
+			forEachCell(proxy, [&](const glm::ivec3& coord) {
+				auto it = m_cells.find(key(coord));
+				if (it == m_cells.end()) return;
+				removeId(it->second.ids, id);
+				if (it->second.ids.empty()) m_emptyCells++;
+			});
+			sweepEmptyCells();
+		}
+
+		void clearProxies() override {
+			m_cells.clear();
+			m_oversized.clear();
+			m_emptyCells = 0;
+		}
+
+		void gather(const Aabb& region, const RegionTest& test, const Visitor& visit) const override {
+			for (Id id : m_oversized) visit(id);
+
+			glm::ivec3 cellMin, cellMax;
+			cellRange(region, cellMin, cellMax);
+			glm::dvec3 span = glm::dvec3(cellMax - cellMin) + 1.0;
+			// Small regions walk their cells, big ones (frustums, long rays) the occupied cells
+			if (span.x * span.y * span.z <= static_cast<double>(m_cells.size())) {
+				for (int x = cellMin.x; x <= cellMax.x; x++) {
+					for (int y = cellMin.y; y <= cellMax.y; y++) {
+						for (int z = cellMin.z; z <= cellMax.z; z++) {
+							auto it = m_cells.find(key(glm::ivec3(x, y, z)));
+							if (it == m_cells.end() || it->second.ids.empty() || !test(cellBounds(it->second.coord))) continue;
+							for (Id id : it->second.ids) visit(id);
+						}
+					}
+				}
+				return;
+			}
+
+			for (const auto& [cellKey, cell] : m_cells) {
+				if (cell.ids.empty()) continue;
+				Aabb bounds = cellBounds(cell.coord);
+				if (!bounds.intersects(region) || !test(bounds)) continue;
+				for (Id id : cell.ids) visit(id);
+			}
+		}
+
+	private:
+		struct Cell {
+			glm::ivec3 coord;
+			std::vector<Id> ids;
+		};
+
+		// 21 bits per axis
+		static constexpr int coordLimit = (1 << 20) - 1;
+
+		static uint64_t key(const glm::ivec3& coord) {
+			return (static_cast<uint64_t>(coord.x + coordLimit) << 42)
+				| (static_cast<uint64_t>(coord.y + coordLimit) << 21)
+				| static_cast<uint64_t>(coord.z + coordLimit);
+		}
+
+		int toCell(float value) const {
+			float cell = std::floor(value / m_cellSize);
+			return static_cast<int>(std::max(std::min(cell, static_cast<float>(coordLimit)), static_cast<float>(-coordLimit)));
+		}
+
+		void cellRange(const Aabb& box, glm::ivec3& cellMin, glm::ivec3& cellMax) const {
+			cellMin = glm::ivec3(toCell(box.min.x), toCell(box.min.y), toCell(box.min.z));
+			cellMax = glm::ivec3(toCell(box.max.x), toCell(box.max.y), toCell(box.max.z));
+		}
+
+		Aabb cellBounds(const glm::ivec3& coord) const {
+			glm::vec3 min = glm::vec3(coord) * m_cellSize;
+			return Aabb(min, min + glm::vec3(m_cellSize));
+		}
+
+		// Cells emptied by a move are kept for the next proxy coming in, and erased once they
+		// are half of the map
+		void sweepEmptyCells() {
+			if (m_emptyCells < minSweep || m_emptyCells * 2 < m_cells.size()) return;
+			for (auto it = m_cells.begin(); it != m_cells.end();) {
+				if (it->second.ids.empty()) it = m_cells.erase(it);
+				else ++it;
+			}
+			m_emptyCells = 0;
+		}
+
+		bool isOversized(const Proxy& proxy) const {
+			glm::dvec3 span = glm::dvec3(proxy.cellMax - proxy.cellMin) + 1.0;
+			return span.x * span.y * span.z > m_settings.maxCellsPerProxy;
+		}
+
+		template<typename F>
+		void forEachCell(const Proxy& proxy, F&& f) const {
+			for (int x = proxy.cellMin.x; x <= proxy.cellMax.x; x++) {
+				for (int y = proxy.cellMin.y; y <= proxy.cellMax.y; y++) {
+					for (int z = proxy.cellMin.z; z <= proxy.cellMax.z; z++) {
+						f(glm::ivec3(x, y, z));
+					}
+				}
+			}
+		}
+
+		float m_cellSize;
+		std::unordered_map<uint64_t, Cell> m_cells;
+		size_t m_emptyCells = 0;
+		std::vector<Id> m_oversized;
+	};
+
+	// Implicit octree over [worldMin, worldMax]: nodes exist while their subtree holds proxies.
+	// A proxy goes to the deepest node whose cell contains its center and whose loose
+	// bounds (the cell grown by looseness) contain its box.
+	class LooseOctreeIndex : public SpatialIndex {
+	public:
+		explicit LooseOctreeIndex(const Settings& settings) : SpatialIndex(settings) {
+			m_settings.maxDepth = std::min(m_settings.maxDepth, 15u); // the node key stores the level in 4 bits
+			m_settings.looseness = std::max(m_settings.looseness, 1.0f);
+			m_origin = settings.worldMin;
+			glm::vec3 size = settings.worldMax - settings.worldMin;
+			m_rootSize = std::max(std::max(size.x, size.y), std::max(size.z, 0.001f));
+		}
+
+	protected:
+		void placeProxy(Id id) override {
+			Proxy& proxy = m_proxies[id];
+			uint32_t level;
+			glm::ivec3 cell;
+			chooseNode(proxy.bounds, level, cell);
+			proxy.node = key(level, cell);
+			link(id, level, cell, 0);
+		}
+
+		void moveProxy(Id id) override {
+			Proxy& proxy = m_proxies[id];
+			uint32_t level;
+			glm::ivec3 cell;
+			chooseNode(proxy.bounds, level, cell);
+			// Still fits its node
+			uint64_t node = key(level, cell);
+			if (node == proxy.node) return;
+
+			// The nodes both paths share keep their counts, most moves go to a sibling or cousin
+			uint32_t oldLevel = static_cast<uint32_t>(proxy.node >> 60);
+			glm::ivec3 oldCell = decodeCell(proxy.node);
+			uint32_t shared = 0;
+			while (shared <= std::min(level, oldLevel)
+				&& (cell >> static_cast<int>(level - shared)) == (oldCell >> static_cast<int>(oldLevel - shared)))
+				shared++;
+
+			unlink(id, oldLevel, oldCell, shared);
+			link(id, level, cell, shared);
+			proxy.node = node;
+		}
+
+		void removeProxy(Id id) override {
+			Proxy& proxy = m_proxies[id];
+			unlink(id, static_cast<uint32_t>(proxy.node >> 60), decodeCell(proxy.node), 0);
+		}
+
+		void clearProxies() override {
+			m_nodes.clear();
+		}
+
+		void gather(const Aabb& region, const RegionTest& test, const Visitor& visit) const override {
+			gatherNode(0, glm::ivec3(0), region, test, visit);
+		}
+
+	private:
+		struct Node {
+			std::vector<Id> ids;
+			uint32_t subtreeCount = 0;
+			uint8_t childMask = 0;
+		};
+
+		// 4 bits of level, 20 bits per axis
+		static uint64_t key(uint32_t level, const glm::ivec3& cell) {
+			return (static_cast<uint64_t>(level) << 60)
+				| (static_cast<uint64_t>(cell.x) << 40)
+				| (static_cast<uint64_t>(cell.y) << 20)
+				| static_cast<uint64_t>(cell.z);
+		}
+
+		static glm::ivec3 decodeCell(uint64_t key) {
+			return glm::ivec3(static_cast<int>((key >> 40) & 0xFFFFF), static_cast<int>((key >> 20) & 0xFFFFF), static_cast<int>(key & 0xFFFFF));
+		}
+
+		static uint8_t childBit(const glm::ivec3& cell) {
+			glm::ivec3 child = cell & 1;
+			return static_cast<uint8_t>(1u << (child.x | (child.y << 1) | (child.z << 2)));
+		}
+
+		// Lists the proxy in the node (level, cell) and counts it in the path from level `from`
+		// down, creating the missing nodes. The nodes above `from` already count it.
+		void link(Id id, uint32_t level, const glm::ivec3& cell, uint32_t from) {
+			if (from > level) {
+				m_nodes[key(level, cell)].ids.push_back(id);
+				return;
+			}
+			if (from > 0)
+				m_nodes[key(from - 1, cell >> static_cast<int>(level - from + 1))].childMask |= childBit(cell >> static_cast<int>(level - from));
+
+			for (uint32_t l = from; l <= level; l++) {
+				Node& node = m_nodes[key(l, cell >> static_cast<int>(level - l))];
+				node.subtreeCount++;
+				if (l < level)
+					node.childMask |= childBit(cell >> static_cast<int>(level - l - 1));
+				else
+					node.ids.push_back(id);
+			}
+		}
+
+		// Opposite of link, nodes left empty go away
+		void unlink(Id id, uint32_t level, const glm::ivec3& cell, uint32_t from) {
+			if (from > level) {
+				auto it = m_nodes.find(key(level, cell));
+				if (it != m_nodes.end()) removeId(it->second.ids, id);
+				return;
+			}
+
+			for (uint32_t l = level + 1; l-- > from;) {
+				glm::ivec3 ancestor = cell >> static_cast<int>(level - l);
+				auto it = m_nodes.find(key(l, ancestor));
+				if (it == m_nodes.end()) return;
+				Node& node = it->second;
+				if (l == level) removeId(node.ids, id);
+				if (--node.subtreeCount > 0) continue;
+
+				m_nodes.erase(it);
+				if (l > 0) {
+					auto parent = m_nodes.find(key(l - 1, ancestor >> 1));
+					if (parent != m_nodes.end())
+						parent->second.childMask &= static_cast<uint8_t>(~childBit(ancestor));
+				}
+			}
+		}
+
+		void chooseNode(const Aabb& box, uint32_t& level, glm::ivec3& cell) const {
+			glm::vec3 center = (box.getCenter() - m_origin) / m_rootSize;
+			level = 0;
+			cell = glm::ivec3(0);
+			// Outside the world: the root, which every query visits
+			if (glm::any(glm::lessThan(center, glm::vec3(0.0f))) || glm::any(glm::greaterThanEqual(center, glm::vec3(1.0f))))
+				return;
+
+			glm::vec3 size = box.max - box.min;
+			float extent = std::max(std::max(size.x, size.y), size.z);
+			float cellSize = m_rootSize;
+			// The loose border on each side is (looseness - 1) / 2 cells
+			while (level < m_settings.maxDepth && extent <= cellSize * 0.5f * (m_settings.looseness - 1.0f)) {
+				level++;
+				cellSize *= 0.5f;
+			}
+			int cells = 1 << level;
+			cell = glm::clamp(glm::ivec3(center * static_cast<float>(cells)), glm::ivec3(0), glm::ivec3(cells - 1));
+		}
+
+		Aabb looseBounds(uint32_t level, const glm::ivec3& cell) const {
+			float cellSize = m_rootSize / static_cast<float>(1 << level);
+			glm::vec3 min = m_origin + glm::vec3(cell) * cellSize;
+			float border = cellSize * 0.5f * (m_settings.looseness - 1.0f);
+			return Aabb(min - glm::vec3(border), min + glm::vec3(cellSize + border));
+		}
+
+		void gatherNode(uint32_t level, const glm::ivec3& cell, const Aabb& region, const RegionTest& test, const Visitor& visit) const {
+			auto it = m_nodes.find(key(level, cell));
+			if (it == m_nodes.end()) return;
+
+			// The root also keeps what lies outside the world, it is never pruned
+			if (level > 0) {
+				Aabb bounds = looseBounds(level, cell);
+				if (!bounds.intersects(region) || !test(bounds)) return;
+			}
+
+			const Node& node = it->second;
+			for (Id id : node.ids) visit(id);
+			if (level >= m_settings.maxDepth) return;
+			for (int child = 0; child < 8; child++) {
+				if (!(node.childMask & (1u << child))) continue;
+				glm::ivec3 offset(child & 1, (child >> 1) & 1, (child >> 2) & 1);
+				gatherNode(level + 1, cell * 2 + offset, region, test, visit);
+			}
+		}
+
+		glm::vec3 m_origin;
+		float m_rootSize;
+		std::unordered_map<uint64_t, Node> m_nodes;
+	};
+}
+
+SpatialIndex::Settings SpatialIndex::loadSettings(const std::string& configPath) {
+	Settings settings;
+
+	std::ifstream file(configPath);
+	if (!file.is_open()) {
+		std::cout << "No spatial index config at " << configPath << ", using defaults" << std::endl;
+		return settings;
+	}
+
+	try {
+		auto json = nlohmann::json::parse(file, nullptr, true, true);
+		std::string type = json.value("type", std::string(toString(settings.type)));
+		settings.type = type == "octree" ? Type::LOOSE_OCTREE : Type::HASH_GRID;
+		settings.cellSize = json.value("cellSize", settings.cellSize);
+		settings.maxCellsPerProxy = json.value("maxCellsPerProxy", settings.maxCellsPerProxy);
+		settings.worldMin = readVec3(json, "worldMin", settings.worldMin);
+		settings.worldMax = readVec3(json, "worldMax", settings.worldMax);
+		settings.maxDepth = json.value("maxDepth", settings.maxDepth);
+		settings.looseness = json.value("looseness", settings.looseness);
+	}
+	catch (const nlohmann::json::exception& e) {
+		std::cerr << "Error loading spatial index config " << configPath << ": " << e.what() << std::endl;
+	}
+	return settings;
+}
+
+std::unique_ptr<SpatialIndex> SpatialIndex::create(const Settings& settings) {
+	if (settings.type == Type::LOOSE_OCTREE)
+		return std::make_unique<LooseOctreeIndex>(settings);
+	return std::make_unique<HashGridIndex>(settings);
+}
+
+const char* SpatialIndex::toString(Type type) {
+	return type == Type::LOOSE_OCTREE ? "octree" : "grid";
+}
+
+SpatialIndex::Id SpatialIndex::insert(void* userData, const Aabb& bounds) {
+	Id id;
+	if (!m_freeIds.empty()) {
+		id = m_freeIds.back();
+		m_freeIds.pop_back();
+	}
+	else {
+		id = static_cast<Id>(m_proxies.size());
+		m_proxies.emplace_back();
+	}
+
+	Proxy& proxy = m_proxies[id];
+	proxy = Proxy{};
+	proxy.bounds = bounds;
+	proxy.userData = userData;
+	proxy.used = true;
+	placeProxy(id);
+	m_count++;
+	return id;
+}
+
+void SpatialIndex::update(Id id, const Aabb& bounds) {
+	if (id >= m_proxies.size() || !m_proxies[id].used) return;
+	m_proxies[id].bounds = bounds;
+	moveProxy(id);
+}
+
+void SpatialIndex::remove(Id id) {
+	if (id >= m_proxies.size() || !m_proxies[id].used) return;
+	removeProxy(id);
+	m_proxies[id].used = false;
+	m_proxies[id].userData = nullptr;
+	m_freeIds.push_back(id);
+	m_count--;
+}
+
+void SpatialIndex::clear() {
+	clearProxies();
+	m_proxies.clear();
+	m_freeIds.clear();
+	m_count = 0;
+}
+
+uint32_t SpatialIndex::nextStamp() const {
+	if (++m_queryStamp == 0) {
+		for (const Proxy& proxy : m_proxies) proxy.queryStamp = 0;
+		m_queryStamp = 1;
+	}
+	return m_queryStamp;
+}
+
+void SpatialIndex::queryAabb(const Aabb& box, std::vector<Id>& out) const {
+	uint32_t stamp = nextStamp();
+	gather(box, [](const Aabb&) { return true; }, [&](Id id) {
+		const Proxy& proxy = m_proxies[id];
+		if (proxy.queryStamp == stamp) return;
+		proxy.queryStamp = stamp;
+		if (proxy.bounds.intersects(box)) out.push_back(id);
+	});
+}
+
+void SpatialIndex::querySphere(const glm::vec3& center, float radius, std::vector<Id>& out) const {
+	uint32_t stamp = nextStamp();
+	Aabb region = Aabb::fromCenter(center, glm::vec3(radius));
+	gather(region, [&](const Aabb& bounds) { return bounds.intersectsSphere(center, radius); }, [&](Id id) {
+		const Proxy& proxy = m_proxies[id];
+		if (proxy.queryStamp == stamp) return;
+		proxy.queryStamp = stamp;
+		if (proxy.bounds.intersectsSphere(center, radius)) out.push_back(id);
+	});
+}
+
+void SpatialIndex::queryFrustum(const Frustum& frustum, std::vector<Id>& out) const {
+	uint32_t stamp = nextStamp();
+	Aabb region(glm::vec3(-infinity), glm::vec3(infinity));
+	gather(region, [&](const Aabb& bounds) { return frustum.intersects(bounds); }, [&](Id id) {
+		const Proxy& proxy = m_proxies[id];
+		if (proxy.queryStamp == stamp) return;
+		proxy.queryStamp = stamp;
+		if (frustum.intersects(proxy.bounds)) out.push_back(id);
+	});
+}
+
+void SpatialIndex::queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<RayHit>& out) const {
+	uint32_t stamp = nextStamp();
+	glm::vec3 inverse = 1.0f / direction;
+	glm::vec3 end = origin + direction * std::min(maxDistance, infinity * 0.5f);
+	Aabb region(glm::min(origin, end), glm::max(origin, end));
+	size_t first = out.size();
+
+	gather(region, [&](const Aabb& bounds) {
+		float distance;
+		return bounds.intersectsRay(origin, inverse, maxDistance, distance);
+	}, [&](Id id) {
+		const Proxy& proxy = m_proxies[id];
+		if (proxy.queryStamp == stamp) return;
+		proxy.queryStamp = stamp;
+		float distance;
+		if (proxy.bounds.intersectsRay(origin, inverse, maxDistance, distance)) out.push_back({ id, distance });
+	});
+
+	std::sort(out.begin() + first, out.end(), [](const RayHit& a, const RayHit& b) { return a.distance < b.distance; });
+}
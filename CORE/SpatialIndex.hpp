@@ -0,0 +1,99 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include "Bounds.hpp"
+
+// Broad spatial lookup over world boxes: the objects of a Scene, the lights of the
+// LightManager. Two structures behind one interface, picked by Settings::type:
+// - HASH_GRID: uniform cells hashed in a map, best when objects have similar sizes
+// - LOOSE_OCTREE: each object sits in one node whose bounds are enlarged by `looseness`,
+//   so it only moves when it leaves that node, best for mixed sizes and large worlds
+// Updating a proxy that stays in its cells / node only stores the new box.
+// Queries mark the proxies they visit: one query at a time.
+class SpatialIndex {
+public:
+	enum class Type { HASH_GRID, LOOSE_OCTREE };
+
+	struct Settings {
+		Type type = Type::HASH_GRID;
+		float cellSize = 16.0f;                  // hash grid cell edge
+		uint32_t maxCellsPerProxy = 64;          // bigger proxies go to a list every query tests
+		glm::vec3 worldMin = glm::vec3(-2048.0f); // octree root, proxies outside stay in the root
+		glm::vec3 worldMax = glm::vec3(2048.0f);
+		uint32_t maxDepth = 10;                  // at most 15
+		float looseness = 2.0f;                  // node bounds / cell size
+	};
+
+	using Id = uint32_t;
+	static constexpr Id invalidId = UINT32_MAX;
+
+	struct RayHit {
+		Id id;
+		float distance;
+	};
+
+	// Missing file or fields keep the defaults
+	static Settings loadSettings(const std::string& configPath);
+	static std::unique_ptr<SpatialIndex> create(const Settings& settings);
+	static const char* toString(Type type);
+
+	virtual ~SpatialIndex() = default;
+
+	Id insert(void* userData, const Aabb& bounds);
+	void update(Id id, const Aabb& bounds);
+	void remove(Id id);
+	void clear();
+
+	void* getUserData(Id id) const { return m_proxies[id].userData; }
+	const Aabb& getBounds(Id id) const { return m_proxies[id].bounds; }
+	size_t getCount() const { return m_count; }
+	// Ids are below this, for arrays indexed by id
+	size_t getCapacity() const { return m_proxies.size(); }
+	const Settings& getSettings() const { return m_settings; }
+
+	// Ids whose box passes the test, appended to out in no particular order
+	void queryAabb(const Aabb& box, std::vector<Id>& out) const;
+	void querySphere(const glm::vec3& center, float radius, std::vector<Id>& out) const;
+	void queryFrustum(const Frustum& frustum, std::vector<Id>& out) const;
+	// Boxes crossed by the ray within maxDistance, nearest first
+	void queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<RayHit>& out) const;
+
+protected:
+	explicit SpatialIndex(const Settings& settings) : m_settings(settings) {}
+
+	struct Proxy {
+		Aabb bounds;
+		void* userData = nullptr;
+		// Placement kept by the structure: cell range of the grid, node key of the octree
+		glm::ivec3 cellMin = glm::ivec3(0);
+		glm::ivec3 cellMax = glm::ivec3(-1);
+		uint64_t node = 0;
+		mutable uint32_t queryStamp = 0;
+		bool used = false;
+	};
+
+	using RegionTest = std::function<bool(const Aabb&)>;
+	using Visitor = std::function<void(Id)>;
+
+	virtual void placeProxy(Id id) = 0;
+	// bounds already hold the new box
+	virtual void moveProxy(Id id) = 0;
+	virtual void removeProxy(Id id) = 0;
+	virtual void clearProxies() = 0;
+	// visit(id) for the proxies of every cell / node touching `region` and passing `test`,
+	// a proxy may come more than once
+	virtual void gather(const Aabb& region, const RegionTest& test, const Visitor& visit) const = 0;
+
+	std::vector<Proxy> m_proxies;
+	Settings m_settings;
+
+private:
+	uint32_t nextStamp() const;
+
+	std::vector<Id> m_freeIds;
+	size_t m_count = 0;
+	mutable uint32_t m_queryStamp = 0;
+};
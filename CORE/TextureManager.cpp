@@ -9,6 +9,7 @@
 
 #include "Shader.hpp"
 #include "Mesh/CubeMap.hpp"
+#include "Jobs/JobSystem.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -33,15 +34,40 @@ namespace TextureManager
 			return it->second;
 		}
 
+		DecodedImage image;
+		decodeImage(path, image);
+		return createTexture(path, name, image);
+	}
+
+	bool decodeImage(const std::string& path, DecodedImage& out, bool flipVertically)
+	{
+		// Per thread flag, set explicitly: stb falls back to its global one otherwise
+		stbi_set_flip_vertically_on_load_thread(flipVertically);
+		unsigned char* data = stbi_load(path.c_str(), &out.width, &out.height, &out.channels, 0);
+		if (!data)
+		{
+			std::cerr << "TextureManager: Failed to load texture: " << path << std::endl;
+			return false;
+		}
+		out.pixels = std::shared_ptr<unsigned char>(data, stbi_image_free);
+		return true;
+	}
+
+	std::shared_ptr<Texture> createTexture(const std::string& path, const std::string& name, const DecodedImage& image)
+	{
+		auto it = Internal::textures.find(name);
+		if (it != Internal::textures.end())
+		{
+			return it->second;
+		}
+
 		auto texture = std::make_shared<Texture>();
 		texture->id = 0;
 		texture->width = 0;
 		texture->height = 0;
+		texture->path = path;
 
-		// Load texture
-		int width, height, nrChannels;
-		unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-		if (data)
+		if (image.pixels)
 		{
 			glGenTextures(1, &texture->id);
 			glBindTexture(GL_TEXTURE_2D, texture->id);
@@ -51,27 +77,22 @@ namespace TextureManager
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 			// Load and generate the texture
-			if (nrChannels == 3)
+			if (image.channels == 3)
 			{
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.width, image.height, 0, GL_RGB, GL_UNSIGNED_BYTE, image.pixels.get());
 			}
-			else if (nrChannels == 4)
+			else if (image.channels == 4)
 			{
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.get());
 			}
 			else
 			{
-				std::cerr << "TextureManager: Unsupported number of channels: " << nrChannels << std::endl;
+				std::cerr << "TextureManager: Unsupported number of channels: " << image.channels << std::endl;
 			}
 			glGenerateMipmap(GL_TEXTURE_2D);
-			texture->width = width;
-			texture->height = height;
+			texture->width = image.width;
+			texture->height = image.height;
 		}
-		else
-		{
-			std::cerr << "TextureManager: Failed to load texture: " << path << std::endl;
-		}
-		stbi_image_free(data);
 
 		Internal::textures[name] = texture;
 		return texture;
@@ -98,14 +119,26 @@ namespace TextureManager
 		glGenTextures(1, &texture->id);
 		glBindTexture(GL_TEXTURE_CUBE_MAP, texture->id);
 
-		int width, height, nrChannels;
+		// Faces are decoded on the job system, the GL upload stays on this thread
+		struct Face {
+			unsigned char* data = nullptr;
+			int width = 0, height = 0, nrChannels = 0;
+		};
+		std::vector<Face> decoded(faces.size());
+		JobSystem::parallelFor(faces.size(), 1, [&](size_t begin, size_t end) {
+			// Cube faces are read top row first
+			stbi_set_flip_vertically_on_load_thread(false);
+			for (size_t i = begin; i < end; i++)
+				decoded[i].data = stbi_load(faces[i].c_str(), &decoded[i].width, &decoded[i].height, &decoded[i].nrChannels, 0);
+		});
+
 		for (unsigned int i = 0; i < faces.size(); i++)
 		{
-			unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
+			unsigned char* data = decoded[i].data;
 			if (data)
 			{
 				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-					0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data
+					0, GL_RGB, decoded[i].width, decoded[i].height, 0, GL_RGB, GL_UNSIGNED_BYTE, data
 				);
 				stbi_image_free(data);
 			}
@@ -205,7 +238,8 @@ namespace TextureManager
 		HDRTextureInfo info;
 		info.texture = std::make_shared<Texture>();
 
-		stbi_set_flip_vertically_on_load(true);
+		// Only this thread, every other load sets the flag it needs
+		stbi_set_flip_vertically_on_load_thread(true);
 		float* data = stbi_loadf(path.c_str(), &info.width, &info.height, nullptr, 3);
 
 		if (data) {
@@ -20,9 +20,20 @@ struct HDRTextureInfo {
 	int height = 0;
 };
 
+// Pixels of an image file, freed with the last copy
+struct DecodedImage {
+	std::shared_ptr<unsigned char> pixels;
+	int width = 0, height = 0, channels = 0;
+};
+
 namespace TextureManager
 {
 	std::shared_ptr<Texture> loadTexture(const std::string& path, const std::string& name);
+	// loadTexture in two steps: decoding is safe on any thread (streaming loads it on the
+	// workers), the GL upload of createTexture stays on the main thread. 2D textures are
+	// flipped so their first row is the bottom one, as OpenGL and the model UVs expect.
+	bool decodeImage(const std::string& path, DecodedImage& out, bool flipVertically = true);
+	std::shared_ptr<Texture> createTexture(const std::string& path, const std::string& name, const DecodedImage& image);
 	std::shared_ptr<Texture> loadCubemap(const std::vector<std::string>& faces, const std::string& name);
 	std::shared_ptr<Texture> loadCubemap(const std::vector<std::string>& faces);
 
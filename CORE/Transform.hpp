@@ -5,6 +5,9 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp> // This header contains toMat4
+#include <glm/gtc/matrix_inverse.hpp>
+#include <vector>
+#include <algorithm>
 
 class Transform {
 
@@ -14,53 +17,189 @@ public:
 		updateQuaternionFromEuler();
 	}
 
+	// Copies the local transform, not the place in the hierarchy
+	Transform(const Transform& other)
+		: m_position(other.m_position), m_rotation(other.getRotation()), m_rotationQuat(other.m_rotationQuat), m_scale(other.m_scale) {}
+	Transform& operator=(const Transform& other) {
+		m_position = other.m_position;
+		m_rotation = other.getRotation();
+		m_eulerDirty = false;
+		m_rotationQuat = other.m_rotationQuat;
+		m_scale = other.m_scale;
+		markDirty();
+		return *this;
+	}
+
+	~Transform() {
+		setParent(nullptr);
+		// Children become roots
+		for (Transform* child : m_children) {
+			child->m_parent = nullptr;
+			child->markDirty();
+		}
+	}
+
+	// Local values, relative to the parent (world values for a root)
 	const glm::vec3& getPosition() const { return m_position; }
-	const glm::vec3& getRotation() const { return m_rotation; }
+	const glm::vec3& getRotation() const {
+		// Euler angles are only derived from the quaternion when someone asks for them
+		if (m_eulerDirty) {
+			m_rotation = glm::degrees(glm::eulerAngles(m_rotationQuat));
+			m_eulerDirty = false;
+		}
+		return m_rotation;
+	}
 	const glm::quat& getRotationQuaternion() const { return m_rotationQuat; }
 	const glm::vec3& getScale() const { return m_scale; }
 
-	void setPosition(const glm::vec3& position) { m_position = position; }
+	void setPosition(const glm::vec3& position) { m_position = position; markDirty(); }
 	void setRotation(const glm::vec3& rotation) {
 		m_rotation = rotation;
+		m_eulerDirty = false;
 		updateQuaternionFromEuler();
+		markDirty();
 	}
 	void setRotationQuaternion(const glm::quat& quaternion) {
 		m_rotationQuat = quaternion;
-		// Update Euler angles for compatibility
-		m_rotation = glm::degrees(glm::eulerAngles(m_rotationQuat));
+		m_eulerDirty = true;
+		markDirty();
 	}
 
-	void setScale(const glm::vec3& scale) { m_scale = scale; }
+	void setScale(const glm::vec3& scale) { m_scale = scale; markDirty(); }
 
-	void move(const glm::vec3& offset) { m_position += offset; }
+	void move(const glm::vec3& offset) { m_position += offset; markDirty(); }
 	//void rotate(const glm::vec3& offset) { m_rotation += offset; }
 
 	void rotate(const glm::vec3& offset) {
-		m_rotation += offset;
+		m_rotation = getRotation() + offset;
 		updateQuaternionFromEuler();
+		markDirty();
+	}
+	void scale(const glm::vec3& offset) { m_scale += offset; markDirty(); }
+
+	// Parenting: the local values become relative to `parent`. With keepWorld the
+	// object stays where it is in the world, otherwise its local values are kept.
+	// Physics bodies are driven by local values, keep them on root objects.
+	void setParent(Transform* parent, bool keepWorld = false) {
+		if (parent == m_parent || parent == this) return;
+		// No cycles: the new parent cannot be one of our descendants
+		for (Transform* ancestor = parent; ancestor; ancestor = ancestor->m_parent) {
+			if (ancestor == this) return;
+		}
+
+		glm::mat4 world = keepWorld ? getModelMatrix() : glm::mat4(1.0f);
+
+		if (m_parent) {
+			auto& siblings = m_parent->m_children;
+			siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+		}
+		m_parent = parent;
+		if (m_parent)
+			m_parent->m_children.push_back(this);
+
+		if (keepWorld) {
+			glm::mat4 local = m_parent ? glm::inverse(m_parent->getModelMatrix()) * world : world;
+			m_position = glm::vec3(local[3]);
+			m_scale = glm::vec3(glm::length(glm::vec3(local[0])), glm::length(glm::vec3(local[1])), glm::length(glm::vec3(local[2])));
+			glm::mat3 rotation(glm::vec3(local[0]) / m_scale.x, glm::vec3(local[1]) / m_scale.y, glm::vec3(local[2]) / m_scale.z);
+			m_rotationQuat = glm::normalize(glm::quat_cast(rotation));
+			m_eulerDirty = true;
+		}
+		markDirty();
 	}
-	void scale(const glm::vec3& offset) { m_scale += offset; }
+	Transform* getParent() const { return m_parent; }
+	const std::vector<Transform*>& getChildren() const { return m_children; }
 
-	glm::mat4 getModelMatrix() const {
-		glm::mat4 model = glm::mat4(1.0f);
-		model = glm::translate(model, m_position);
+	// Parent-relative matrix, rebuilt only after a change
+	const glm::mat4& getLocalMatrix() const {
+		if (m_localDirty) {
+			m_localMatrix = glm::translate(glm::mat4(1.0f), m_position);
+			// Use quaternion for rotation instead of Euler angles
+			m_localMatrix *= glm::toMat4(m_rotationQuat);
+			m_localMatrix = glm::scale(m_localMatrix, m_scale);
+			m_localDirty = false;
+		}
+		return m_localMatrix;
+	}
 
-		// Use quaternion for rotation instead of Euler angles
-		model *= glm::toMat4(m_rotationQuat);
+	// World matrix, cached until this transform or one of its ancestors changes
+	const glm::mat4& getModelMatrix() const {
+		if (m_worldDirty) {
+			m_worldMatrix = m_parent ? m_parent->getModelMatrix() * getLocalMatrix() : getLocalMatrix();
+			m_worldDirty = false;
+			m_normalDirty = true;
+		}
+		return m_worldMatrix;
+	}
 
-		model = glm::scale(model, m_scale);
-		return model;
+	// Inverse transpose of the world rotation and scale, the "normalMatrix" shader uniform
+	const glm::mat3& getNormalMatrix() const {
+		const glm::mat4& world = getModelMatrix();
+		if (m_normalDirty) {
+			m_normalMatrix = glm::inverseTranspose(glm::mat3(world));
+			m_normalDirty = false;
+		}
+		return m_normalMatrix;
 	}
 
+	bool isWorldDirty() const { return m_worldDirty; }
+	// Set with the world dirty flag and left set until the owner of a cached copy of the
+	// placement (the Scene spatial index) takes it, the matrices may be clean since
+	bool hasMoved() const { return m_moved; }
+	void clearMoved() const { m_moved = false; }
+
+	// Matrices of a root transform computed elsewhere, see TransformBatch
+	void setCachedMatrices(const glm::mat4& world, const glm::mat3& normal) {
+		m_localMatrix = world;
+		m_worldMatrix = world;
+		m_normalMatrix = normal;
+		m_localDirty = false;
+		m_worldDirty = false;
+		m_normalDirty = false;
+	}
+
+	glm::vec3 getWorldPosition() const { return glm::vec3(getModelMatrix()[3]); }
+
+	// Brings the cached world matrix up to date, a flag test for unchanged objects.
+	// Scene::update calls it once per frame so both render passes only read the cache.
+	void updateWorldMatrix() const { if (m_worldDirty) getModelMatrix(); }
+
 protected:
 
+	// Derived classes writing the members directly must call it
+	void markDirty() {
+		m_localDirty = true;
+		markWorldDirty();
+	}
+
+	void markWorldDirty() {
+		// A dirty node has only dirty descendants, nothing more to do below it
+		if (m_worldDirty) return;
+		m_worldDirty = true;
+		m_moved = true;
+		for (Transform* child : m_children) child->markWorldDirty();
+	}
+
 	void updateQuaternionFromEuler() {
 		m_rotationQuat = glm::quat(glm::radians(m_rotation));
 	}
 
 	glm::vec3 m_position;
-	glm::vec3 m_rotation;
+	mutable glm::vec3 m_rotation; // Euler degrees, derived lazily after setRotationQuaternion
 	glm::quat m_rotationQuat; // Store rotation as quaternion
 	glm::vec3 m_scale;
 
+private:
+	mutable bool m_eulerDirty = false;
+	mutable bool m_localDirty = true;
+	mutable bool m_worldDirty = true;
+	mutable bool m_normalDirty = true;
+	mutable bool m_moved = true;
+	mutable glm::mat4 m_localMatrix = glm::mat4(1.0f);
+	mutable glm::mat4 m_worldMatrix = glm::mat4(1.0f);
+	mutable glm::mat3 m_normalMatrix = glm::mat3(1.0f);
+
+	Transform* m_parent = nullptr;
+	std::vector<Transform*> m_children;
+
 }; // class Transform
\ No newline at end of file
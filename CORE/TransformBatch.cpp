@@ -0,0 +1,300 @@
+#include "TransformBatch.hpp"
+#include "GameObject.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TRANSFORM_BATCH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(TRANSFORM_BATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TRANSFORM_BATCH_AVX2 __attribute__((target("avx2")))
+#else
+#define TRANSFORM_BATCH_AVX2
+#endif
+
+
+namespace TransformBatch
+{
+	namespace Internal {
+		Kernel forced = Kernel::AVX2;
+		bool hasForced = false;
+
+		// Scratch of updateWorldMatrices, kept between frames
+		Soa soa;
+		std::vector<Transform*> roots;
+		std::vector<glm::mat4> world;
+		std::vector<glm::mat3> normal;
+
+		bool detectAvx2() {
+#if !defined(TRANSFORM_BATCH_X86)
+			return false;
+#elif defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) return false;
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			// The OS has to save the YMM registers
+			if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#else
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+
+		void computeScalar(const Soa& in, size_t begin, size_t end, glm::mat4* world, glm::mat3* normal) {
+			for (size_t i = begin; i < end; i++) {
+				float x = in.qx[i], y = in.qy[i], z = in.qz[i], w = in.qw[i];
+				float xx = x * x, yy = y * y, zz = z * z;
+				float xy = x * y, xz = x * z, yz = y * z;
+				float wx = w * x, wy = w * y, wz = w * z;
+
+				// Rotation columns, same terms as glm::mat3_cast
+				glm::vec3 r0(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy));
+				glm::vec3 r1(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx));
+				glm::vec3 r2(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy));
+
+				glm::mat4& m = world[i];
+				m[0] = glm::vec4(r0 * in.sx[i], 0.0f);
+				m[1] = glm::vec4(r1 * in.sy[i], 0.0f);
+				m[2] = glm::vec4(r2 * in.sz[i], 0.0f);
+				m[3] = glm::vec4(in.px[i], in.py[i], in.pz[i], 1.0f);
+
+				// (R * S)^-T = R * S^-1
+				if (normal) {
+					glm::mat3& n = normal[i];
+					n[0] = r0 / in.sx[i];
+					n[1] = r1 / in.sy[i];
+					n[2] = r2 / in.sz[i];
+				}
+			}
+		}
+
+#if defined(TRANSFORM_BATCH_X86)
+		// Writes 4 transforms from their 16 (model) or 9 (normal) component registers.
+		// Each register holds one matrix element of the 4 transforms.
+		inline void storeModels(glm::mat4* out, __m128 c[4][4]) {
+			for (int col = 0; col < 4; col++) {
+				__m128 a = c[col][0], b = c[col][1], cc = c[col][2], d = c[col][3];
+				_MM_TRANSPOSE4_PS(a, b, cc, d);
+				_mm_storeu_ps(&out[0][col][0], a);
+				_mm_storeu_ps(&out[1][col][0], b);
+				_mm_storeu_ps(&out[2][col][0], cc);
+				_mm_storeu_ps(&out[3][col][0], d);
+			}
+		}
+
+		inline void storeNormals(glm::mat3* out, __m128 c[3][3]) {
+			alignas(16) float lanes[4][4];
+			for (int col = 0; col < 3; col++) {
+				__m128 a = c[col][0], b = c[col][1], cc = c[col][2], d = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(a, b, cc, d);
+				_mm_store_ps(lanes[0], a);
+				_mm_store_ps(lanes[1], b);
+				_mm_store_ps(lanes[2], cc);
+				_mm_store_ps(lanes[3], d);
+				// mat3 columns are 3 floats, a 4 wide store would run into the next matrix
+				for (int k = 0; k < 4; k++) std::memcpy(&out[k][col][0], lanes[k], 3 * sizeof(float));
+			}
+		}
+
+		void computeSse(const Soa& in, size_t begin, size_t end, glm::mat4* world, glm::mat3* normal) {
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 two = _mm_set1_ps(2.0f);
+			const __m128 zero = _mm_setzero_ps();
+
+			size_t i = begin;
+			for (; i + 4 <= end; i += 4) {
+				__m128 x = _mm_loadu_ps(&in.qx[i]), y = _mm_loadu_ps(&in.qy[i]);
+				__m128 z = _mm_loadu_ps(&in.qz[i]), w = _mm_loadu_ps(&in.qw[i]);
+				__m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+				__m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+				__m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+				__m128 r[3][3] = {
+					{ _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), _mm_mul_ps(two, _mm_add_ps(xy, wz)), _mm_mul_ps(two, _mm_sub_ps(xz, wy)) },
+					{ _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), _mm_mul_ps(two, _mm_add_ps(yz, wx)) },
+					{ _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))) },
+				};
+				__m128 s[3] = { _mm_loadu_ps(&in.sx[i]), _mm_loadu_ps(&in.sy[i]), _mm_loadu_ps(&in.sz[i]) };
+
+				__m128 m[4][4];
+				for (int col = 0; col < 3; col++) {
+					for (int row = 0; row < 3; row++) m[col][row] = _mm_mul_ps(r[col][row], s[col]);
+					m[col][3] = zero;
+				}
+				m[3][0] = _mm_loadu_ps(&in.px[i]);
+				m[3][1] = _mm_loadu_ps(&in.py[i]);
+				m[3][2] = _mm_loadu_ps(&in.pz[i]);
+				m[3][3] = one;
+				storeModels(world + i, m);
+
+				if (normal) {
+					__m128 n[3][3];
+					for (int col = 0; col < 3; col++) {
+						__m128 inv = _mm_div_ps(one, s[col]);
+						for (int row = 0; row < 3; row++) n[col][row] = _mm_mul_ps(r[col][row], inv);
+					}
+					storeNormals(normal + i, n);
+				}
+			}
+			computeScalar(in, i, end, world, normal);
+		}
+
+		TRANSFORM_BATCH_AVX2
+		void computeAvx2(const Soa& in, size_t begin, size_t end, glm::mat4* world, glm::mat3* normal) {
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 two = _mm256_set1_ps(2.0f);
+			const __m256 zero = _mm256_setzero_ps();
+
+			size_t i = begin;
+			for (; i + 8 <= end; i += 8) {
+				__m256 x = _mm256_loadu_ps(&in.qx[i]), y = _mm256_loadu_ps(&in.qy[i]);
+				__m256 z = _mm256_loadu_ps(&in.qz[i]), w = _mm256_loadu_ps(&in.qw[i]);
+				__m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+				__m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+				__m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+				__m256 r[3][3] = {
+					{ _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), _mm256_mul_ps(two, _mm256_add_ps(xy, wz)), _mm256_mul_ps(two, _mm256_sub_ps(xz, wy)) },
+					{ _mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), _mm256_mul_ps(two, _mm256_add_ps(yz, wx)) },
+					{ _mm256_mul_ps(two, _mm256_add_ps(xz, wy)), _mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))) },
+				};
+				__m256 s[3] = { _mm256_loadu_ps(&in.sx[i]), _mm256_loadu_ps(&in.sy[i]), _mm256_loadu_ps(&in.sz[i]) };
+
+				__m256 m[4][4];
+				for (int col = 0; col < 3; col++) {
+					for (int row = 0; row < 3; row++) m[col][row] = _mm256_mul_ps(r[col][row], s[col]);
+					m[col][3] = zero;
+				}
+				m[3][0] = _mm256_loadu_ps(&in.px[i]);
+				m[3][1] = _mm256_loadu_ps(&in.py[i]);
+				m[3][2] = _mm256_loadu_ps(&in.pz[i]);
+				m[3][3] = one;
+
+				// The stores work on 4 transforms, one half of the registers at a time
+				__m128 low[4][4], high[4][4];
+				for (int col = 0; col < 4; col++) {
+					for (int row = 0; row < 4; row++) {
+						low[col][row] = _mm256_castps256_ps128(m[col][row]);
+						high[col][row] = _mm256_extractf128_ps(m[col][row], 1);
+					}
+				}
+				storeModels(world + i, low);
+				storeModels(world + i + 4, high);
+
+				if (normal) {
+					__m128 nLow[3][3], nHigh[3][3];
+					for (int col = 0; col < 3; col++) {
+						__m256 inv = _mm256_div_ps(one, s[col]);
+						for (int row = 0; row < 3; row++) {
+							__m256 n = _mm256_mul_ps(r[col][row], inv);
+							nLow[col][row] = _mm256_castps256_ps128(n);
+							nHigh[col][row] = _mm256_extractf128_ps(n, 1);
+						}
+					}
+					storeNormals(normal + i, nLow);
+					storeNormals(normal + i + 4, nHigh);
+				}
+			}
+			computeSse(in, i, end, world, normal);
+		}
+#endif
+	}
+
+	void Soa::resize(size_t count) {
+		for (std::vector<float>* v : { &px, &py, &pz, &qx, &qy, &qz, &qw, &sx, &sy, &sz })
+			v->resize(count);
+	}
+
+	void Soa::set(size_t i, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+		px[i] = position.x; py[i] = position.y; pz[i] = position.z;
+		qx[i] = rotation.x; qy[i] = rotation.y; qz[i] = rotation.z; qw[i] = rotation.w;
+		sx[i] = scale.x; sy[i] = scale.y; sz[i] = scale.z;
+	}
+
+	bool isSupported(Kernel kernel) {
+		static const bool avx2 = Internal::detectAvx2();
+		switch (kernel) {
+		case Kernel::SCALAR: return true;
+#if defined(TRANSFORM_BATCH_X86)
+		case Kernel::SSE: return true; // SSE2 is part of every x86-64 CPU
+		case Kernel::AVX2: return avx2;
+#endif
+		default: return false;
+		}
+	}
+
+	Kernel getBestKernel() {
+		static const Kernel best = isSupported(Kernel::AVX2) ? Kernel::AVX2
+			: isSupported(Kernel::SSE) ? Kernel::SSE : Kernel::SCALAR;
+		return best;
+	}
+
+	Kernel getKernel() {
+		return Internal::hasForced ? Internal::forced : getBestKernel();
+	}
+
+	void setKernel(Kernel kernel) {
+		if (!isSupported(kernel)) return;
+		Internal::forced = kernel;
+		Internal::hasForced = true;
+	}
+
+	const char* toString(Kernel kernel) {
+		switch (kernel) {
+		case Kernel::SCALAR: return "scalar";
+		case Kernel::SSE: return "sse";
+		case Kernel::AVX2: return "avx2";
+		}
+		return "unknown";
+	}
+
+	void compute(const Soa& in, glm::mat4* world, glm::mat3* normal, Kernel kernel) {
+		if (!isSupported(kernel)) kernel = getBestKernel();
+#if defined(TRANSFORM_BATCH_X86)
+		if (kernel == Kernel::AVX2) {
+			Internal::computeAvx2(in, 0, in.size(), world, normal);
+			return;
+		}
+		if (kernel == Kernel::SSE) {
+			Internal::computeSse(in, 0, in.size(), world, normal);
+			return;
+		}
+#endif
+		Internal::computeScalar(in, 0, in.size(), world, normal);
+	}
+
+	size_t updateWorldMatrices(const std::vector<std::shared_ptr<GameObject>>& objects) {
+		Internal::roots.clear();
+		for (auto& gameObject : objects) {
+			if (gameObject->isWorldDirty() && !gameObject->getParent())
+				Internal::roots.push_back(gameObject.get());
+		}
+
+		size_t count = Internal::roots.size();
+		if (count == 0) return 0;
+
+		Internal::soa.resize(count);
+		for (size_t i = 0; i < count; i++) {
+			Transform* transform = Internal::roots[i];
+			Internal::soa.set(i, transform->getPosition(), transform->getRotationQuaternion(), transform->getScale());
+		}
+
+		if (Internal::world.size() < count) {
+			Internal::world.resize(count);
+			Internal::normal.resize(count);
+		}
+		compute(Internal::soa, Internal::world.data(), Internal::normal.data());
+
+		for (size_t i = 0; i < count; i++)
+			Internal::roots[i]->setCachedMatrices(Internal::world[i], Internal::normal[i]);
+		return count;
+	}
+}
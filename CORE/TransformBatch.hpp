@@ -0,0 +1,44 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class GameObject;
+
+// World and normal matrices of many translate * rotate * scale transforms at once.
+// Inputs are structure of arrays so the SIMD kernels load 4 (SSE) or 8 (AVX2)
+// transforms per instruction. The kernel is picked at runtime from what the CPU
+// supports, the scalar one works everywhere.
+namespace TransformBatch
+{
+	enum class Kernel { SCALAR, SSE, AVX2 };
+
+	struct Soa {
+		std::vector<float> px, py, pz;
+		std::vector<float> qx, qy, qz, qw;
+		std::vector<float> sx, sy, sz;
+
+		void resize(size_t count);
+		void set(size_t i, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+		size_t size() const { return px.size(); }
+	};
+
+	bool isSupported(Kernel kernel);
+	// Best supported kernel, detected once
+	Kernel getBestKernel();
+	// Kernel used by compute() without an explicit one, the best by default
+	Kernel getKernel();
+	void setKernel(Kernel kernel);
+	const char* toString(Kernel kernel);
+
+	// world[i] = T * R * S, normal[i] = inverse transpose of its upper 3x3 (normal may be null)
+	void compute(const Soa& in, glm::mat4* world, glm::mat3* normal, Kernel kernel);
+	inline void compute(const Soa& in, glm::mat4* world, glm::mat3* normal) { compute(in, world, normal, getKernel()); }
+
+	// Gathers the dirty root transforms of the objects, runs the kernel and stores the
+	// results in their caches. Children are left to Transform::updateWorldMatrix.
+	// Returns the number of transforms computed.
+	size_t updateWorldMatrices(const std::vector<std::shared_ptr<GameObject>>& objects);
+}
@@ -0,0 +1,133 @@
+#include "PhysicsStatsPanel.hpp"
+#include "../PhysicsActorPool.hpp"
+#include <algorithm>
+#include <cstdio>
+
+
+namespace UI {
+
+	void renderImGuiPhysicsStats(Scene* scene) {
+		if (!scene) return;
+
+		PhysicsStats& stats = scene->getPhysicsScene()->getStats();
+		const PhysicsStepStats& last = stats.getLast();
+
+		if (ImGui::Begin("Physics Stats")) {
+			// Step time graph
+			static float stepTimes[240];
+			int count = 0;
+			float maxMs = 0.0f;
+			stats.forEachHistory([&](const PhysicsStepStats& s) {
+				if (count < IM_ARRAYSIZE(stepTimes)) {
+					stepTimes[count] = static_cast<float>(s.totalMs);
+					maxMs = std::max(maxMs, stepTimes[count]);
+					count++;
+				}
+			});
+			char overlay[64];
+			snprintf(overlay, sizeof(overlay), "step %.3f ms", last.totalMs);
+			ImGui::PlotLines("##steps", stepTimes, count, 0, overlay, 0.0f, std::max(maxMs, 1.0f), ImVec2(0, 60));
+
+			if (ImGui::CollapsingHeader("Timing", ImGuiTreeNodeFlags_DefaultOpen)) {
+				ImGui::Text("simulate      %.3f ms", last.simulateMs);
+				ImGui::Text("fetchResults  %.3f ms", last.fetchResultsMs);
+				if (PhysicsProfiler::isInstalled()) {
+					ImGui::Text("broad phase   %.3f ms", last.broadPhaseMs);
+					ImGui::Text("narrow phase  %.3f ms", last.narrowPhaseMs);
+					ImGui::Text("solver        %.3f ms", last.solverMs);
+				}
+				else {
+					ImGui::TextDisabled("phase timings need the profiler (disabled or PVD on)");
+				}
+			}
+
+			if (ImGui::CollapsingHeader("Bodies", ImGuiTreeNodeFlags_DefaultOpen)) {
+				ImGui::Text("active dynamic    %u / %u", last.activeDynamicBodies, last.dynamicBodies);
+				ImGui::Text("active kinematic  %u", last.activeKinematicBodies);
+				ImGui::Text("static            %u", last.staticBodies);
+				ImGui::Text("aggregates        %u", last.aggregates);
+				ImGui::Text("active joints     %u", last.activeConstraints);
+			}
+
+			if (ImGui::CollapsingHeader("Pairs and contacts", ImGuiTreeNodeFlags_DefaultOpen)) {
+				ImGui::Text("broad phase adds/removes  %u / %u", last.broadPhaseAdds, last.broadPhaseRemoves);
+				ImGui::Text("new/lost pairs           %u / %u", last.newPairs, last.lostPairs);
+				ImGui::Text("new/lost touches         %u / %u", last.newTouches, last.lostTouches);
+				ImGui::Text("narrow phase pairs       %u", last.contactPairs);
+				ImGui::Text("  with contacts          %u", last.contactPairsWithContacts);
+				ImGui::Text("  cache hits             %u", last.contactPairsCacheHits);
+				ImGui::Text("solver partitions        %u", last.partitions);
+				PhysicsEventCollector& events = scene->getPhysicsScene()->getEvents();
+				ImGui::Text("events / dropped         %u / %llu", events.getLastEventCount(),
+					static_cast<unsigned long long>(events.getDroppedCount()));
+			}
+
+			if (ImGui::CollapsingHeader("Actor pool")) {
+				const PhysicsActorPool::PoolStats& pool = PhysicsActorPool::getStats();
+				ImGui::Text("pools / parked   %u / %u", pool.pools, pool.parked);
+				ImGui::Text("reused / created %llu / %llu",
+					static_cast<unsigned long long>(pool.reused), static_cast<unsigned long long>(pool.created));
+			}
+
+			if (ImGui::CollapsingHeader("Pose write-back")) {
+				PhysicsScene& physicsScene = *scene->getPhysicsScene();
+				ImGui::Text("bodies written  %zu", physicsScene.getFlushedPoseCount());
+				ImGui::Text("moves coalesced %zu", physicsScene.getCoalescedPoseCount());
+			}
+
+			if (ImGui::CollapsingHeader("Simulation LOD")) {
+				PhysicsCulling& culling = scene->getCulling();
+				bool enabled = culling.isEnabled();
+				if (ImGui::Checkbox("Distance culling", &enabled)) {
+					culling.setEnabled(enabled);
+					if (!enabled) culling.restoreAll(scene->getGameObjects());
+				}
+				PhysicsCulling::Settings settings = culling.getSettings();
+				bool changed = ImGui::DragFloat("Active radius", &settings.activeRadius, 1.0f, 1.0f, 10000.0f);
+				changed |= ImGui::DragFloat("Hysteresis", &settings.hysteresis, 0.5f, 0.0f, 1000.0f);
+				if (changed) culling.setSettings(settings);
+
+				const PhysicsCulling::Stats& lod = culling.getStats();
+				ImGui::Text("culled            %u", lod.culled);
+				ImGui::Text("in / out / queued %u / %u / %u", lod.activated, lod.deactivated, lod.pending);
+			}
+
+			if (ImGui::CollapsingHeader("Spatial index")) {
+				const SpatialIndex& index = scene->getSpatialIndex();
+				bool culling = scene->isFrustumCulling();
+				if (ImGui::Checkbox("Frustum culling", &culling))
+					scene->setFrustumCulling(culling);
+				ImGui::Text("type              %s", SpatialIndex::toString(index.getSettings().type));
+				ImGui::Text("objects / visible %zu / %zu", index.getCount(), scene->getVisibleCount());
+			}
+
+			WorldStreamer& streaming = scene->getStreaming();
+			if (streaming.isOpen() && ImGui::CollapsingHeader("World streaming")) {
+				const WorldStreamer::FrameStats& frame = streaming.getFrameStats();
+				ImGui::Text("cells loaded / loading  %u / %u of %zu", frame.loadedCells, frame.loadsInFlight, streaming.getCellCount());
+				if (frame.failedCells > 0)
+					ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "cells failed            %u", frame.failedCells);
+				ImGui::Text("commit                  %.3f ms (budget %.1f)", frame.commitMs, streaming.getSettings().frameBudgetMs);
+				for (size_t i = 0; i < streaming.getCellCount(); i++) {
+					const WorldStreamer::CellStats& cell = streaming.getCellStats(i);
+					if (cell.state == WorldStreamer::CellState::UNLOADED) continue;
+					ImGui::Text("%4d %4d %-10s %5zu obj  %7.1f KB  latency %7.2f ms  read %6.2f ms  commit %6.2f ms / %u frames",
+						cell.x, cell.z, WorldStreamer::toString(cell.state), cell.objects,
+						(cell.fileBytes + cell.textureBytes + cell.memoryBytes) / 1024.0, cell.latencyMs, cell.readMs,
+						cell.commitMs, cell.commitFrames);
+				}
+			}
+
+			// CSV dump toggle
+			static char csvPath[256] = "physics_stats.csv";
+			ImGui::InputText("CSV", csvPath, IM_ARRAYSIZE(csvPath));
+			if (stats.isWritingCsv()) {
+				if (ImGui::Button("Stop CSV")) stats.stopCsv();
+			}
+			else if (ImGui::Button("Start CSV")) {
+				stats.startCsv(csvPath);
+			}
+		}
+		ImGui::End();
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "../Scene.hpp"
+#include "imgui.h"
+
+namespace UI {
+
+	// Per step PhysX counters and timings of the scene physics
+	void renderImGuiPhysicsStats(Scene* scene);
+
+}
@@ -2,12 +2,30 @@
 
 
 namespace UI {
-	GameObject* g_SelectedObject = nullptr;
+	// Handle, not a pointer: a destroyed selection simply stops resolving
+	GameObjectHandle g_Selected;
+	Scene* g_SelectionScene = nullptr;
 	bool g_SelectedFromHierarchy = false;
 	bool g_JustSelectedFromHierarchy = false;
 
+	GameObject* getSelectedObject() {
+		return g_SelectionScene ? g_SelectionScene->resolve(g_Selected) : nullptr;
+	}
+
+	void clearSelection(const Scene* scene) {
+		if (g_SelectionScene != scene) return;
+		g_SelectionScene = nullptr;
+		g_Selected = GameObjectHandle{};
+		g_SelectedFromHierarchy = false;
+	}
+
 	void renderImGuiSceneHierarchy(Scene* scene) {
 		if (!scene) return;
+		// Another scene took over, handles of the previous one mean nothing here
+		if (g_SelectionScene != scene) {
+			g_Selected = GameObjectHandle{};
+			g_SelectionScene = scene;
+		}
 
 		if (ImGui::Begin("Scene Hierarchy")) {
 			// Search filter
@@ -27,9 +45,9 @@ namespace UI {
 				}
 
 				// Display selectable object
-				bool isSelected = (g_SelectedObject == obj.get());
+				bool isSelected = (g_Selected == obj->getHandle());
 				if (ImGui::Selectable(obj->getName(), isSelected)) {
-					g_SelectedObject = obj.get();
+					g_Selected = obj->getHandle();
 					g_SelectedFromHierarchy = true;
 					g_JustSelectedFromHierarchy = true;
 				}
@@ -44,13 +62,14 @@ namespace UI {
 	}
 
 	void renderImGuiObjectEditor() {
-		if (!g_SelectedObject) return;
+		GameObject* selected = getSelectedObject();
+		if (!selected) return;
 		ImGui::Begin(" ransform editor");
 		ImGui::Text("aaaaaaaaa");
 			ImGui::End();
 
 		if (ImGui::Begin("Object Editor")) {
-			ImGui::Text("Selected: %s", g_SelectedObject->getName());
+			ImGui::Text("Selected: %s", selected->getName());
 			if (!g_SelectedFromHierarchy) {
 				ImGui::SameLine();
 				ImGui::TextColored(ImVec4(1, 1, 0, 1), "(Raycast Selected)");
@@ -59,35 +78,35 @@ namespace UI {
 			// Position editor
 			if (ImGui::CollapsingHeader("Transform", ImGuiTreeNodeFlags_DefaultOpen)) {
 
-				glm::vec3 position = g_SelectedObject->getPosition();
+				glm::vec3 position = selected->getPosition();
 				if (ImGui::DragFloat3("Position", glm::value_ptr(position), 0.1f)) {
-					g_SelectedObject->setPosition(position, true);
+					selected->setPosition(position, true);
 				}
 
 				// Rotation editor with tabs for Euler/Quaternion
 				if (ImGui::BeginTabBar("RotationTabs")) {
 					// Euler angles tab
 					if (ImGui::BeginTabItem("Euler Angles")) {
-						glm::vec3 rotation = g_SelectedObject->getRotation();
+						glm::vec3 rotation = selected->getRotation();
 						if (ImGui::DragFloat3("Rotation", glm::value_ptr(rotation), 1.0f)) {
-							g_SelectedObject->setRotation(rotation, true);
+							selected->setRotation(rotation, true);
 						}
 						ImGui::EndTabItem();
 					}
 
 					// Quaternion tab
 					if (ImGui::BeginTabItem("Quaternion")) {
-						glm::quat rotQuat = g_SelectedObject->getRotationQuaternion();
+						glm::quat rotQuat = selected->getRotationQuaternion();
 						float quatValues[4] = { rotQuat.x, rotQuat.y, rotQuat.z, rotQuat.w };
 						if (ImGui::DragFloat4("Rotation", quatValues, 0.01f)) {
 							glm::quat newQuat(quatValues[3], quatValues[0], quatValues[1], quatValues[2]);
 							newQuat = glm::normalize(newQuat);
-							g_SelectedObject->setRotationQuaternion(newQuat, true);
+							selected->setRotationQuaternion(newQuat, true);
 						}
 
 						if (ImGui::Button("Normalize")) {
-							glm::quat normalized = glm::normalize(g_SelectedObject->getRotationQuaternion());
-							g_SelectedObject->setRotationQuaternion(normalized, true);
+							glm::quat normalized = glm::normalize(selected->getRotationQuaternion());
+							selected->setRotationQuaternion(normalized, true);
 						}
 						ImGui::EndTabItem();
 					}
@@ -95,9 +114,9 @@ namespace UI {
 				}
 
 				// Scale editor
-				glm::vec3 scale = g_SelectedObject->getScale();
+				glm::vec3 scale = selected->getScale();
 				if (ImGui::DragFloat3("Scale", glm::value_ptr(scale), 0.1f)) {
-					g_SelectedObject->setScale(scale);
+					selected->setScale(scale);
 
 				}
 			}
@@ -118,7 +137,7 @@ namespace UI {
 		// and if the mouse isn't over the ImGui window
 		if (!g_JustSelectedFromHierarchy && !ImGui::GetIO().WantCaptureMouse) {
 			if (hitObject && Input::isMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT)) {
-				g_SelectedObject = hitObject;
+				g_Selected = hitObject->getHandle();
 				g_SelectedFromHierarchy = false;
 			}
 		}
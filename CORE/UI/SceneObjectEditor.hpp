@@ -10,6 +10,10 @@ namespace UI {
 
 	void renderImGuiSceneHierarchy(Scene* scene);
 	void renderImGuiObjectEditor();
+	// Current selection, nullptr when nothing is selected or the object was destroyed
+	GameObject* getSelectedObject();
+	// Called by ~Scene: a selection in `scene` is dropped before the scene goes away
+	void clearSelection(const Scene* scene);
 	void setRaycastSelectedObject(GameObject* obj);
 	void handleRaycastSelection(GameObject* hitObject);
 
@@ -0,0 +1,382 @@
+#include "WorldStreamer.hpp"
+#include "Scene.hpp"
+#include "SceneData.hpp"
+#include "SceneFile.hpp"
+#include "Engine.hpp"
+#include "TextureManager.hpp"
+#include "Lights/LightManager.hpp"
+#include "Jobs/JobSystem.hpp"
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+// Filled by a worker, handed over once done is set
+struct WorldStreamer::LoadRequest {
+	SceneData data;
+	std::vector<std::pair<std::string, DecodedImage>> textures;
+	bool ok = false;
+	double readMs = 0.0;
+	std::atomic<bool> done{ false };
+};
+
+namespace
+{
+	const char* manifestName = "world.json";
+
+	double elapsedMs(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	std::string cellFileName(int32_t x, int32_t z) {
+		return "cell_" + std::to_string(x) + "_" + std::to_string(z) + ".clcs";
+	}
+
+	// Texture paths named by the components of a cell, each once
+	std::vector<std::string> findTextures(const SceneData& data) {
+		std::vector<std::string> paths;
+		std::unordered_set<uint32_t> seen;
+		for (size_t c = 0; c < data.getComponentCount(); c++) {
+			const SceneFormat::Component& component = data.getComponent(c);
+			for (uint32_t p = 0; p < component.propertyCount; p++) {
+				const SceneFormat::Property& property = data.getProperty(component.firstProperty + p);
+				if (property.kind != SceneFormat::PropertyKind::TEXT || property.text == 0) continue;
+				if (std::strcmp(data.getString(property.name), "texture") != 0) continue;
+				if (seen.insert(property.text).second)
+					paths.push_back(data.getString(property.text));
+			}
+		}
+		return paths;
+	}
+}
+
+const char* WorldStreamer::toString(CellState state) {
+	switch (state) {
+	case CellState::LOADING: return "loading";
+	case CellState::READY: return "ready";
+	case CellState::COMMITTING: return "committing";
+	case CellState::LOADED: return "loaded";
+	case CellState::FAILED: return "failed";
+	default: return "unloaded";
+	}
+}
+
+WorldStreamer::Settings WorldStreamer::loadSettings(const std::string& configPath) {
+	Settings settings;
+
+	std::ifstream file(configPath);
+	if (!file.is_open()) {
+		std::cout << "No streaming config at " << configPath << ", using defaults" << std::endl;
+		return settings;
+	}
+
+	try {
+		auto json = nlohmann::json::parse(file, nullptr, true, true);
+		settings.loadRadius = json.value("loadRadius", settings.loadRadius);
+		settings.unloadRadius = std::max(json.value("unloadRadius", settings.unloadRadius), settings.loadRadius);
+		settings.frameBudgetMs = json.value("frameBudgetMs", settings.frameBudgetMs);
+		settings.maxLoadsInFlight = std::max(1u, json.value("maxLoadsInFlight", settings.maxLoadsInFlight));
+		settings.sliceObjects = std::max(1u, json.value("sliceObjects", settings.sliceObjects));
+		settings.retryDelayMs = std::max(0.0f, json.value("retryDelayMs", settings.retryDelayMs));
+	}
+	catch (const nlohmann::json::exception& e) {
+		std::cerr << "Error loading streaming config " << configPath << ": " << e.what() << std::endl;
+	}
+	return settings;
+}
+
+size_t WorldStreamer::bake(const SceneData& world, float cellSize, const std::string& directory) {
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	// Roots pick their cell, children take the one of their parent (parents come first)
+	struct Key {
+		int32_t x, z;
+		bool operator==(const Key& other) const { return x == other.x && z == other.z; }
+	};
+	struct KeyHash {
+		size_t operator()(const Key& key) const { return std::hash<int64_t>()((int64_t(key.x) << 32) ^ uint32_t(key.z)); }
+	};
+	std::vector<Key> cellOf(world.getObjectCount());
+	std::unordered_map<Key, std::vector<uint32_t>, KeyHash> members;
+	std::vector<Key> order;
+	for (size_t i = 0; i < world.getObjectCount(); i++) {
+		const SceneFormat::Object& object = world.getObject(i);
+		if (object.parent >= 0) {
+			cellOf[i] = cellOf[object.parent];
+		}
+		else {
+			cellOf[i] = Key{ static_cast<int32_t>(std::floor(object.position[0] / cellSize)),
+				static_cast<int32_t>(std::floor(object.position[2] / cellSize)) };
+		}
+		auto& list = members[cellOf[i]];
+		if (list.empty()) order.push_back(cellOf[i]);
+		list.push_back(static_cast<uint32_t>(i));
+	}
+
+	nlohmann::json manifest;
+	manifest["cellSize"] = cellSize;
+	manifest["cells"] = nlohmann::json::array();
+	std::vector<int32_t> remap(world.getObjectCount(), -1);
+	for (const Key& key : order) {
+		SceneData cell;
+		for (uint32_t index : members[key]) {
+			int32_t parent = world.getObject(index).parent;
+			remap[index] = static_cast<int32_t>(cell.copyObject(world, index, parent >= 0 ? remap[parent] : -1));
+		}
+		std::string file = cellFileName(key.x, key.z);
+		if (!cell.saveBinary(directory + "/" + file)) return 0;
+
+		nlohmann::json entry;
+		entry["x"] = key.x;
+		entry["z"] = key.z;
+		entry["file"] = file;
+		entry["objects"] = cell.getObjectCount();
+		entry["bytes"] = cell.getByteSize();
+		manifest["cells"].push_back(entry);
+	}
+
+	std::ofstream out(directory + "/" + manifestName);
+	if (!out.is_open()) {
+		std::cerr << "Failed to write " << directory << "/" << manifestName << std::endl;
+		return 0;
+	}
+	out << manifest.dump(2) << std::endl;
+	return order.size();
+}
+
+bool WorldStreamer::open(const std::string& directory, const Settings& settings) {
+	std::string path = directory + "/" + manifestName;
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "Failed to open world manifest " << path << std::endl;
+		return false;
+	}
+
+	std::vector<Cell> cells;
+	float cellSize = 0.0f;
+	try {
+		auto json = nlohmann::json::parse(file);
+		cellSize = json.at("cellSize").get<float>();
+		for (const auto& entry : json.at("cells")) {
+			Cell cell;
+			cell.path = directory + "/" + entry.at("file").get<std::string>();
+			cell.stats.x = entry.at("x").get<int32_t>();
+			cell.stats.z = entry.at("z").get<int32_t>();
+			cell.stats.objects = entry.value("objects", size_t(0));
+			cell.stats.fileBytes = entry.value("bytes", size_t(0));
+			cells.push_back(std::move(cell));
+		}
+	}
+	catch (const nlohmann::json::exception& e) {
+		std::cerr << "Error loading world manifest " << path << ": " << e.what() << std::endl;
+		return false;
+	}
+	if (cellSize <= 0.0f) return false;
+
+	if (isOpen()) {
+		std::cerr << "WorldStreamer: a world is already open, close it first" << std::endl;
+		return false;
+	}
+	m_cells = std::move(cells);
+	m_cellSize = cellSize;
+	m_directory = directory;
+	m_settings = settings;
+	m_settings.unloadRadius = std::max(m_settings.unloadRadius, m_settings.loadRadius);
+	LOG_OK("World " << directory << ": " << m_cells.size() << " cells of " << cellSize << " m");
+	return true;
+}
+
+void WorldStreamer::close(Scene& scene) {
+	for (Cell& cell : m_cells) unload(scene, cell);
+	m_cells.clear();
+	m_order.clear();
+	m_cancelled.clear();
+	m_committed.clear();
+	m_frame = FrameStats{};
+}
+
+void WorldStreamer::startLoad(Cell& cell) {
+	auto request = std::make_shared<LoadRequest>();
+	cell.request = request;
+	cell.requested = Clock::now();
+	cell.stats.state = CellState::LOADING;
+
+	// Everything that does not touch the scene or GL: the file mapping, the checks of
+	// SceneData::load (which also faults the pages in) and the texture decoding. Background
+	// jobs: the physics step and waiting threads never queue behind a cell read.
+	bool decodeTextures = !Engine::isHeadless();
+	JobSystem::runBackground([request, path = cell.path, decodeTextures] {
+		auto start = Clock::now();
+		request->ok = request->data.load(path);
+		if (request->ok && decodeTextures) {
+			for (const std::string& texture : findTextures(request->data)) {
+				DecodedImage image;
+				if (TextureManager::decodeImage(texture, image))
+					request->textures.emplace_back(texture, std::move(image));
+			}
+		}
+		request->readMs = elapsedMs(start);
+		request->done.store(true, std::memory_order_release);
+	});
+}
+
+bool WorldStreamer::commit(Scene& scene, Cell& cell, Clock::time_point frameStart) {
+	auto start = Clock::now();
+	LoadRequest& request = *cell.request;
+	CellStats& stats = cell.stats;
+
+	if (stats.state == CellState::READY) {
+		stats.readMs = request.readMs;
+		stats.fileBytes = request.data.getByteSize();
+		stats.objects = request.data.getObjectCount();
+		stats.textureBytes = 0;
+		stats.memoryBytes = 0;
+		stats.commitMs = 0.0;
+		stats.commitFrames = 0;
+		// Uploads first, the renderers find them by path
+		for (auto& [path, image] : request.textures) {
+			stats.textureBytes += size_t(image.width) * image.height * image.channels;
+			TextureManager::createTexture(path, path, image);
+		}
+		request.textures.clear();
+		cell.pending.reserve(request.data.getObjectCount());
+		stats.state = CellState::COMMITTING;
+	}
+	stats.commitFrames++;
+
+	SceneMemory& memory = scene.getMemory();
+	const double budgetMs = m_settings.frameBudgetMs;
+	bool complete = false;
+	while (true) {
+		size_t before = memory.getLiveBytes();
+		SceneFile::createObjects(scene, request.data, cell.pending.size() + m_settings.sliceObjects, cell.pending);
+		if (memory.getLiveBytes() > before)
+			stats.memoryBytes += memory.getLiveBytes() - before;
+		complete = cell.pending.size() >= request.data.getObjectCount();
+		// One slice at least, the nearest cell always makes progress
+		if (complete || elapsedMs(frameStart) >= budgetMs) break;
+	}
+
+	if (complete) {
+		// Every actor of the cell in one PhysX call
+		scene.addGameObjects(cell.pending);
+		cell.objects.clear();
+		cell.objects.reserve(cell.pending.size());
+		for (const auto& gameObject : cell.pending) cell.objects.push_back(gameObject->getHandle());
+		cell.pending.clear();
+		cell.request.reset();
+		stats.state = CellState::LOADED;
+		stats.loads++;
+		stats.failures = 0;
+		stats.latencyMs = elapsedMs(cell.requested);
+		m_frame.committedCells++;
+		m_committed.push_back(static_cast<uint32_t>(&cell - m_cells.data()));
+	}
+	stats.commitMs += elapsedMs(start);
+	return complete;
+}
+
+void WorldStreamer::unload(Scene& scene, Cell& cell) {
+	switch (cell.stats.state) {
+	case CellState::LOADING:
+		m_cancelled.push_back(std::move(cell.request));
+		break;
+	case CellState::LOADED:
+		for (GameObjectHandle handle : cell.objects) {
+			// Gameplay may have destroyed it already
+			if (scene.resolve(handle))
+				scene.destroyGameObject(handle);
+		}
+		m_frame.unloadedCells++;
+		break;
+	default:
+		break;
+	}
+	// Created objects were never added to the scene, they just go away
+	for (const auto& gameObject : cell.pending)
+		gameObject->forEachComponent<Light>([](Light* light) { LightManager::removeLight(light); });
+	cell.pending.clear();
+	cell.objects.clear();
+	cell.request.reset();
+	cell.stats.state = CellState::UNLOADED;
+	cell.stats.memoryBytes = 0;
+}
+
+void WorldStreamer::update(Scene& scene, const glm::vec3& cameraPosition) {
+	if (m_cells.empty()) return;
+	auto frameStart = Clock::now();
+	m_frame.committedCells = 0;
+	m_frame.unloadedCells = 0;
+	m_committed.clear();
+
+	m_cancelled.erase(std::remove_if(m_cancelled.begin(), m_cancelled.end(),
+		[](const std::shared_ptr<LoadRequest>& request) { return request->done.load(std::memory_order_acquire); }),
+		m_cancelled.end());
+
+	// Distance from the camera to each cell rectangle on the XZ plane
+	m_order.clear();
+	uint32_t inFlight = static_cast<uint32_t>(m_cancelled.size());
+	for (Cell& cell : m_cells) {
+		float minX = cell.stats.x * m_cellSize, minZ = cell.stats.z * m_cellSize;
+		float dx = std::max({ minX - cameraPosition.x, 0.0f, cameraPosition.x - (minX + m_cellSize) });
+		float dz = std::max({ minZ - cameraPosition.z, 0.0f, cameraPosition.z - (minZ + m_cellSize) });
+		cell.distance = std::sqrt(dx * dx + dz * dz);
+
+		if (cell.stats.state != CellState::UNLOADED && cell.distance > m_settings.unloadRadius) {
+			unload(scene, cell);
+			continue;
+		}
+		if (cell.stats.state == CellState::LOADING) {
+			if (!cell.request->done.load(std::memory_order_acquire)) {
+				inFlight++;
+			}
+			else if (cell.request->ok) {
+				cell.stats.state = CellState::READY;
+			}
+			else {
+				// Read again after a delay that doubles with each failure in a row
+				cell.request.reset();
+				cell.stats.state = CellState::FAILED;
+				cell.stats.failures++;
+				float delayMs = m_settings.retryDelayMs * float(1u << std::min(cell.stats.failures - 1, 6u));
+				cell.retryAt = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(delayMs));
+				std::cerr << "WorldStreamer: cell " << cell.stats.x << " " << cell.stats.z << " failed to load, retry in "
+					<< delayMs << " ms" << std::endl;
+			}
+		}
+		// Cells already read finish committing even past the load radius, their data is here
+		if (cell.distance <= m_settings.loadRadius
+			|| cell.stats.state == CellState::READY || cell.stats.state == CellState::COMMITTING)
+			m_order.push_back(&cell);
+	}
+	std::sort(m_order.begin(), m_order.end(), [](const Cell* a, const Cell* b) { return a->distance < b->distance; });
+
+	// Nearest first: new loads while workers are free, commits while the budget lasts
+	bool budgetLeft = true;
+	for (Cell* cell : m_order) {
+		bool retry = cell->stats.state == CellState::FAILED && frameStart >= cell->retryAt;
+		if ((cell->stats.state == CellState::UNLOADED || retry) && inFlight < m_settings.maxLoadsInFlight) {
+			startLoad(*cell);
+			inFlight++;
+		}
+		else if (budgetLeft && (cell->stats.state == CellState::READY || cell->stats.state == CellState::COMMITTING)) {
+			budgetLeft = commit(scene, *cell, frameStart) && elapsedMs(frameStart) < m_settings.frameBudgetMs;
+		}
+	}
+
+	m_frame.loadsInFlight = inFlight;
+	m_frame.loadedCells = 0;
+	m_frame.failedCells = 0;
+	for (const Cell& cell : m_cells) {
+		if (cell.stats.state == CellState::LOADED) m_frame.loadedCells++;
+		else if (cell.stats.state == CellState::FAILED) m_frame.failedCells++;
+	}
+	m_frame.commitMs = elapsedMs(frameStart);
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <glm/glm.hpp>
+#include "GameObject.hpp"
+
+class Scene;
+class SceneData;
+
+// World partition: a level baked into square cells on the XZ plane, one binary scene
+// file each, listed in a world.json manifest. Cells around the camera are read on the
+// JobSystem workers (file mapping and validation, texture decoding), then created on the
+// main thread a slice at a time within a per-frame budget and added to the scene in one
+// batch. Cells past the unload radius are destroyed. A Scene owns one (getStreaming).
+class WorldStreamer {
+public:
+	struct Settings {
+		float loadRadius = 192.0f;      // distance from the camera to the cell rectangle
+		float unloadRadius = 256.0f;    // above loadRadius so a cell at the border does not flicker
+		float frameBudgetMs = 2.0f;     // main thread time spent creating objects per frame
+		uint32_t maxLoadsInFlight = 4;  // JobSystem also runs at most getThreadCount() - 1 at once
+		uint32_t sliceObjects = 32;     // objects created between two budget checks
+		float retryDelayMs = 1000.0f;   // before a failed cell is read again, doubled per failure
+	};
+	static Settings loadSettings(const std::string& configPath);
+
+	enum class CellState { UNLOADED, LOADING, READY, COMMITTING, LOADED, FAILED };
+	static const char* toString(CellState state);
+
+	struct CellStats {
+		int32_t x = 0;
+		int32_t z = 0;
+		CellState state = CellState::UNLOADED;
+		size_t objects = 0;
+		size_t fileBytes = 0;       // tables of the cell file
+		size_t textureBytes = 0;    // pixels decoded by the worker
+		size_t memoryBytes = 0;     // scene memory held by the cell objects
+		double readMs = 0.0;        // worker time
+		double latencyMs = 0.0;     // request to commit
+		double commitMs = 0.0;      // main thread time, summed over the frames
+		uint32_t commitFrames = 0;
+		uint32_t loads = 0;
+		uint32_t failures = 0;      // reads that failed in a row
+	};
+
+	struct FrameStats {
+		uint32_t loadedCells = 0;
+		uint32_t failedCells = 0;
+		uint32_t loadsInFlight = 0;
+		uint32_t committedCells = 0;
+		uint32_t unloadedCells = 0;
+		double commitMs = 0.0;
+	};
+
+	// Cells of each `cellSize` square of the root object positions (children follow their
+	// root) written to `directory` with the manifest. Returns the number of cells.
+	static size_t bake(const SceneData& world, float cellSize, const std::string& directory);
+
+	WorldStreamer() = default;
+	WorldStreamer(const WorldStreamer&) = delete;
+	WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+	// Reads the manifest of a baked world
+	bool open(const std::string& directory, const Settings& settings = Settings{});
+	// Unloads every cell, loads still running finish in the background
+	void close(Scene& scene);
+	bool isOpen() const { return !m_cells.empty(); }
+
+	void setSettings(const Settings& settings) { m_settings = settings; }
+	const Settings& getSettings() const { return m_settings; }
+
+	// Once per frame, before the physics step
+	void update(Scene& scene, const glm::vec3& cameraPosition);
+
+	float getCellSize() const { return m_cellSize; }
+	size_t getCellCount() const { return m_cells.size(); }
+	const CellStats& getCellStats(size_t index) const { return m_cells[index].stats; }
+	const FrameStats& getFrameStats() const { return m_frame; }
+	// Indices of the cells that finished loading during the last update
+	const std::vector<uint32_t>& getCommittedCells() const { return m_committed; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+	struct LoadRequest;
+
+	struct Cell {
+		std::string path;
+		CellStats stats;
+		float distance = 0.0f;
+		Clock::time_point requested;
+		Clock::time_point retryAt;  // FAILED
+		std::shared_ptr<LoadRequest> request;
+		// Created, not in the scene yet (COMMITTING)
+		std::vector<std::shared_ptr<GameObject>> pending;
+		// In the scene (LOADED)
+		std::vector<GameObjectHandle> objects;
+	};
+
+	void startLoad(Cell& cell);
+	// False when the budget ran out before the cell was complete
+	bool commit(Scene& scene, Cell& cell, Clock::time_point frameStart);
+	void unload(Scene& scene, Cell& cell);
+
+	Settings m_settings;
+	float m_cellSize = 0.0f;
+	std::string m_directory;
+	std::vector<Cell> m_cells;
+	// Cells to load or commit by distance, rebuilt each update
+	std::vector<Cell*> m_order;
+	// Dropped while loading, they still occupy a worker
+	std::vector<std::shared_ptr<LoadRequest>> m_cancelled;
+	FrameStats m_frame;
+	std::vector<uint32_t> m_committed;
+};
@@ -7,12 +7,13 @@ out vec3 FragPos;
 out vec3 Normal;
 
 uniform mat4 model;
+uniform mat3 normalMatrix;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal; // Correct normal transformation
+    Normal = normalMatrix * aNormal;  // inverse transpose of the model, computed on the CPU once per object
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
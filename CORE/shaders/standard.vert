@@ -13,6 +13,7 @@ out vec2 TexCoords;
 out vec4 FragPosLightSpace;  // Add this output
 
 uniform mat4 model;
+uniform mat3 normalMatrix;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat4 lightSpaceMatrix;  // Add this uniform
@@ -20,7 +21,7 @@ uniform mat4 lightSpaceMatrix;  // Add this uniform
 void main() {
     // Transform the vertex position
     FragPos = vec3(model * vec4(aPos, 1.0));  // World-space position
-    Normal = mat3(transpose(inverse(model))) * aNormal;  // Correct normal transformation
+    Normal = normalMatrix * aNormal;  // inverse transpose of the model, computed on the CPU once per object
     TexCoords = aTexCoord;
     
     // Calculate fragment position in light space for shadow mapping
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+
+// Headless benchmark modes, each returns the process exit code
+namespace Bench
+{
+	int runBroadPhase(int argc, char** argv);
+	int runThroughput(int argc, char** argv);
+	int runWorlds(int argc, char** argv);
+	int runReplay(int argc, char** argv);
+	int runTransforms(int argc, char** argv);
+	int runComponents(int argc, char** argv);
+	int runSpatial(int argc, char** argv);
+	int runScene(int argc, char** argv);
+	int runStreaming(int argc, char** argv);
+
+	// Reads "--name value" from the command line
+	inline std::string getArg(int argc, char** argv, const std::string& name, const std::string& fallback) {
+		for (int i = 0; i + 1 < argc; i++) {
+			if (name == argv[i])
+				return argv[i + 1];
+		}
+		return fallback;
+	}
+
+	inline uint32_t getArgU32(int argc, char** argv, const std::string& name, uint32_t fallback) {
+		std::string value = getArg(argc, argv, name, "");
+		return value.empty() ? fallback : static_cast<uint32_t>(std::stoul(value));
+	}
+
+	// p in [0, 100], samples get sorted
+	inline double percentile(std::vector<double>& samples, double p) {
+		if (samples.empty()) return 0.0;
+		std::sort(samples.begin(), samples.end());
+		size_t index = static_cast<size_t>(p / 100.0 * (samples.size() - 1) + 0.5);
+		return samples[std::min(index, samples.size() - 1)];
+	}
+}
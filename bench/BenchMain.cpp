@@ -0,0 +1,43 @@
+#include "Bench.hpp"
+#include <iostream>
+#include <cstring>
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cout << "usage: CLC_Bench <mode> [options]\n"
+			"  broadphase  [--static N] [--dynamic N] [--extent M] [--frames N]\n"
+			"  throughput  [--counts 1000,5000] [--threads 1,2,4] [--layout grid|pile|clusters]\n"
+			"              [--prefab cube|sphere|mixed] [--aggregates 0|1] [--frames N] [--warmup N]\n"
+			"              [--out file.json]\n"
+			"  worlds      [--worlds N] [--bodies N] [--frames N] [--threads N]\n"
+			"  replay      --in session.clcr [--runs N] [--out file.json]\n"
+			"  transforms  [--count N] [--frames N]\n"
+			"  components  [--count N] [--work N] [--frames N] [--threads N]\n"
+			"  spatial     [--count N] [--moving %] [--queries N] [--frames N] [--type grid|octree|both]\n"
+			"  scene       [--count N] [--out file.clcs]\n"
+			"  streaming   [--count N] [--extent M] [--cell M] [--speed M/s] [--frames N] [--dir path]\n";
+		return 1;
+	}
+
+	if (std::strcmp(argv[1], "broadphase") == 0)
+		return Bench::runBroadPhase(argc, argv);
+	if (std::strcmp(argv[1], "throughput") == 0)
+		return Bench::runThroughput(argc, argv);
+	if (std::strcmp(argv[1], "worlds") == 0)
+		return Bench::runWorlds(argc, argv);
+	if (std::strcmp(argv[1], "replay") == 0)
+		return Bench::runReplay(argc, argv);
+	if (std::strcmp(argv[1], "transforms") == 0)
+		return Bench::runTransforms(argc, argv);
+	if (std::strcmp(argv[1], "components") == 0)
+		return Bench::runComponents(argc, argv);
+	if (std::strcmp(argv[1], "spatial") == 0)
+		return Bench::runSpatial(argc, argv);
+	if (std::strcmp(argv[1], "scene") == 0)
+		return Bench::runScene(argc, argv);
+	if (std::strcmp(argv[1], "streaming") == 0)
+		return Bench::runStreaming(argc, argv);
+
+	std::cerr << "Unknown benchmark mode: " << argv[1] << std::endl;
+	return 1;
+}
@@ -0,0 +1,155 @@
+#include "Bench.hpp"
+#include "CORE/Physics.hpp"
+#include "CORE/PhysicsScene.hpp"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <cmath>
+
+// Compares step times of the broadphase / solver settings on a generated
+// large world: a grid of static tiles plus dynamic boxes raining on it.
+namespace Bench
+{
+	namespace
+	{
+		struct WorldParams {
+			uint32_t nbStatic = 20000;
+			uint32_t nbDynamic = 5000;
+			float extent = 4000.0f; // world is [-extent/2, extent/2] on x and z
+			uint32_t frames = 300;
+		};
+
+		struct Result {
+			double firstStepMs = 0.0;
+			double meanMs = 0.0;
+			double p50Ms = 0.0;
+			double p95Ms = 0.0;
+			double maxMs = 0.0;
+			double broadPhaseMs = 0.0;
+			uint32_t activeBodies = 0;
+		};
+
+		void populate(PhysicsScene& scene, const WorldParams& params) {
+			PxPhysics* physics = Physics::getPhysics();
+			PxMaterial* material = physics->createMaterial(0.5f, 0.5f, 0.2f);
+
+			uint32_t tilesPerSide = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(params.nbStatic))));
+			float tileSize = params.extent / tilesPerSide;
+			float half = params.extent * 0.5f;
+
+			std::mt19937 rng(1234);
+			std::uniform_real_distribution<float> height(0.0f, 2.0f);
+			std::uniform_real_distribution<float> position(-half, half);
+			std::uniform_real_distribution<float> drop(5.0f, 50.0f);
+
+			for (uint32_t i = 0; i < params.nbStatic; i++) {
+				float x = -half + (i % tilesPerSide + 0.5f) * tileSize;
+				float z = -half + (i / tilesPerSide + 0.5f) * tileSize;
+				PxRigidStatic* tile = PxCreateStatic(*physics, PxTransform(PxVec3(x, height(rng), z)),
+					PxBoxGeometry(tileSize * 0.5f, 0.5f, tileSize * 0.5f), *material);
+				scene.addActor(tile);
+			}
+
+			for (uint32_t i = 0; i < params.nbDynamic; i++) {
+				PxRigidDynamic* box = PxCreateDynamic(*physics, PxTransform(PxVec3(position(rng), drop(rng), position(rng))),
+					PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, 1.0f);
+				scene.addActor(box);
+			}
+			material->release(); // shapes keep it alive
+		}
+
+		Result run(const Physics::SceneConfig& config, const WorldParams& params) {
+			PhysicsScene scene;
+			scene.init(config);
+			populate(scene, params);
+
+			std::vector<double> samples;
+			samples.reserve(params.frames);
+			double broadPhase = 0.0;
+			Result result;
+
+			for (uint32_t frame = 0; frame < params.frames; frame++) {
+				scene.update(1.0f / 60.0f);
+				const PhysicsStepStats& stats = scene.getStats().getLast();
+				if (frame == 0) {
+					// first step pays for inserting everything in the broadphase
+					result.firstStepMs = stats.totalMs;
+					continue;
+				}
+				samples.push_back(stats.totalMs);
+				broadPhase += stats.broadPhaseMs;
+				result.activeBodies = stats.activeDynamicBodies;
+			}
+
+			double sum = 0.0;
+			for (double s : samples) sum += s;
+			result.meanMs = samples.empty() ? 0.0 : sum / samples.size();
+			result.broadPhaseMs = samples.empty() ? 0.0 : broadPhase / samples.size();
+			result.p50Ms = percentile(samples, 50.0);
+			result.p95Ms = percentile(samples, 95.0);
+			result.maxMs = samples.empty() ? 0.0 : samples.back();
+
+			// PxScene::release leaves the actors alive
+			PxScene* pxScene = scene.getScene();
+			PxActorTypeFlags types = PxActorTypeFlag::eRIGID_STATIC | PxActorTypeFlag::eRIGID_DYNAMIC;
+			std::vector<PxActor*> actors(pxScene->getNbActors(types));
+			pxScene->getActors(types, actors.data(), static_cast<PxU32>(actors.size()));
+			for (PxActor* actor : actors) actor->release();
+
+			scene.shutdown();
+			return result;
+		}
+	}
+
+	int runBroadPhase(int argc, char** argv) {
+		WorldParams params;
+		params.nbStatic = getArgU32(argc, argv, "--static", params.nbStatic);
+		params.nbDynamic = getArgU32(argc, argv, "--dynamic", params.nbDynamic);
+		params.extent = std::stof(getArg(argc, argv, "--extent", std::to_string(params.extent)));
+		params.frames = getArgU32(argc, argv, "--frames", params.frames);
+
+		Physics::init();
+
+		std::cout << "broadphase benchmark: " << params.nbStatic << " static, " << params.nbDynamic
+			<< " dynamic, extent " << params.extent << " m, " << params.frames << " frames\n\n";
+		std::cout << std::left << std::setw(6) << "bp" << std::setw(5) << "slv" << std::setw(7) << "limits"
+			<< std::right << std::setw(11) << "first ms" << std::setw(10) << "mean ms" << std::setw(10) << "p50 ms"
+			<< std::setw(10) << "p95 ms" << std::setw(10) << "max ms" << std::setw(10) << "bp ms" << std::setw(9) << "active" << "\n";
+
+		const Physics::BroadPhaseType broadPhases[] = {
+			Physics::BroadPhaseType::SAP, Physics::BroadPhaseType::MBP,
+			Physics::BroadPhaseType::ABP, Physics::BroadPhaseType::PABP };
+		const Physics::SolverType solvers[] = { Physics::SolverType::PGS, Physics::SolverType::TGS };
+
+		for (Physics::BroadPhaseType broadPhase : broadPhases) {
+			for (Physics::SolverType solver : solvers) {
+				for (int useLimits = 0; useLimits < 2; useLimits++) {
+					Physics::SceneConfig config;
+					config.broadPhase = broadPhase;
+					config.solver = solver;
+					config.hasWorldBounds = true;
+					config.worldMin = glm::vec3(-params.extent * 0.5f, -100.0f, -params.extent * 0.5f);
+					config.worldMax = glm::vec3(params.extent * 0.5f, 200.0f, params.extent * 0.5f);
+					config.mbpSubdivisions = 8;
+					if (useLimits) {
+						config.maxActors = params.nbStatic + params.nbDynamic;
+						config.maxBodies = params.nbDynamic;
+						config.maxStaticShapes = params.nbStatic;
+						config.maxDynamicShapes = params.nbDynamic;
+					}
+
+					Result r = run(config, params);
+					std::cout << std::left << std::setw(6) << Physics::toString(broadPhase)
+						<< std::setw(5) << Physics::toString(solver) << std::setw(7) << (useLimits ? "yes" : "no")
+						<< std::right << std::fixed << std::setprecision(3)
+						<< std::setw(11) << r.firstStepMs << std::setw(10) << r.meanMs << std::setw(10) << r.p50Ms
+						<< std::setw(10) << r.p95Ms << std::setw(10) << r.maxMs << std::setw(10) << r.broadPhaseMs
+						<< std::setw(9) << r.activeBodies << std::endl;
+				}
+			}
+		}
+
+		Physics::shutdown();
+		return 0;
+	}
+}
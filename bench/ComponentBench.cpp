@@ -0,0 +1,87 @@
+#include "Bench.hpp"
+#include "CORE/GameObject.hpp"
+#include "CORE/ComponentRegistry.hpp"
+#include "CORE/Jobs/JobSystem.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <cmath>
+
+// Logic-heavy component updates: N objects each carrying a component that integrates a
+// small oscillator and writes its owner's position, updated serially and then in
+// parallel chunks through ComponentRegistry::update.
+namespace Bench
+{
+	namespace
+	{
+		class BenchLogic : public Component {
+			COMPONENT_TYPE_ID(BenchLogic, Component, ComponentType::FirstUser)
+			COMPONENT_UPDATE(PRE_PHYSICS, ComponentAccess::NONE, ComponentAccess::TRANSFORM)
+		public:
+			BenchLogic(float phase, uint32_t iterations) : m_phase(phase), m_iterations(iterations) {}
+
+			void update(float dt) override {
+				float x = m_phase;
+				for (uint32_t i = 0; i < m_iterations; i++) {
+					x += dt * std::sin(x) * std::cos(x * 0.5f);
+				}
+				m_phase = x;
+				getGameObject()->setPosition(glm::vec3(std::sin(x), std::cos(x), x * 0.001f), false);
+			}
+
+		private:
+			float m_phase;
+			uint32_t m_iterations;
+		};
+
+		double runFrames(ComponentRegistry& registry, uint32_t frames) {
+			auto start = std::chrono::high_resolution_clock::now();
+			for (uint32_t frame = 0; frame < frames; frame++) {
+				registry.update(UpdatePhase::PRE_PHYSICS, 1.0f / 60.0f);
+			}
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+	}
+
+	int runComponents(int argc, char** argv) {
+		uint32_t count = getArgU32(argc, argv, "--count", 100000);
+		uint32_t frames = getArgU32(argc, argv, "--frames", 100);
+		uint32_t iterations = getArgU32(argc, argv, "--work", 32);
+		JobSystem::init(getArgU32(argc, argv, "--threads", 0));
+
+		ComponentRegistry registry;
+		std::vector<std::shared_ptr<GameObject>> objects;
+		objects.reserve(count);
+		for (uint32_t i = 0; i < count; i++) {
+			auto object = std::make_shared<GameObject>();
+			object->addComponent<BenchLogic>(static_cast<float>(i) * 0.01f, iterations);
+			object->setRegistry(&registry);
+			objects.push_back(object);
+		}
+
+		std::cout << "component benchmark: " << count << " components, " << iterations << " iterations each, "
+			<< frames << " frames, " << JobSystem::getThreadCount() << " pool threads\n";
+
+		registry.setValidation(true);
+		runFrames(registry, 1);
+		registry.setValidation(false);
+		if (registry.getConflictCount() > 0)
+			std::cerr << registry.getConflictCount() << " conflicts reported by validation" << std::endl;
+
+		registry.setParallelEnabled(false);
+		double serialMs = runFrames(registry, frames);
+		registry.setParallelEnabled(true);
+		double parallelMs = runFrames(registry, frames);
+
+		std::cout << std::fixed << std::setprecision(3)
+			<< "serial    " << std::setw(10) << serialMs / frames << " ms/frame\n"
+			<< "parallel  " << std::setw(10) << parallelMs / frames << " ms/frame  x"
+			<< std::setprecision(2) << (parallelMs > 0.0 ? serialMs / parallelMs : 0.0) << "\n";
+
+		for (auto& object : objects) object->setRegistry(nullptr);
+		objects.clear();
+		JobSystem::shutdown();
+		return 0;
+	}
+}
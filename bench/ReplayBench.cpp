@@ -0,0 +1,74 @@
+#include "Bench.hpp"
+#include "CORE/Engine.hpp"
+#include "CORE/PhysicsRecorder.hpp"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+
+// Replays a recorded session headlessly and reports its step timings, so the same
+// session can be compared across builds. The state hash checks the runs stayed identical.
+namespace Bench
+{
+	int runReplay(int argc, char** argv) {
+		std::string inPath = getArg(argc, argv, "--in", "");
+		std::string outPath = getArg(argc, argv, "--out", "physics_replay.json");
+		uint32_t runs = std::max(1u, getArgU32(argc, argv, "--runs", 1));
+		if (inPath.empty()) {
+			std::cerr << "replay needs --in <recording>" << std::endl;
+			return 1;
+		}
+
+		Engine::initHeadless();
+
+		nlohmann::json report;
+		report["benchmark"] = "physics_replay";
+		report["recording"] = inPath;
+		report["timestamp"] = static_cast<int64_t>(std::time(nullptr));
+		report["runs"] = nlohmann::json::array();
+
+		bool ok = true;
+		uint64_t firstHash = 0;
+		for (uint32_t run = 0; run < runs && ok; run++) {
+			PhysicsRecorder::ReplayResult result;
+			ok = PhysicsRecorder::replay(inPath, result);
+
+			double sum = 0.0;
+			for (double ms : result.stepMs) sum += ms;
+			std::stringstream hash;
+			hash << std::hex << std::setw(16) << std::setfill('0') << result.stateHash;
+
+			nlohmann::json entry;
+			entry["steps"] = result.steps;
+			entry["skipped_commands"] = result.skippedCommands;
+			entry["state_hash"] = hash.str();
+			entry["step_ms"]["total"] = sum;
+			entry["step_ms"]["mean"] = result.stepMs.empty() ? 0.0 : sum / result.stepMs.size();
+			entry["step_ms"]["p50"] = percentile(result.stepMs, 50.0);
+			entry["step_ms"]["p95"] = percentile(result.stepMs, 95.0);
+			entry["step_ms"]["p99"] = percentile(result.stepMs, 99.0);
+			entry["step_ms"]["max"] = result.stepMs.empty() ? 0.0 : result.stepMs.back();
+			report["runs"].push_back(entry);
+
+			if (run == 0)
+				firstHash = result.stateHash;
+			else if (result.stateHash != firstHash)
+				std::cerr << "Run " << run << " diverged from the first one (state hash " << hash.str() << ")" << std::endl;
+
+			std::cerr << "run " << run << ": " << result.steps << " steps, " << sum << " ms, hash " << hash.str() << std::endl;
+		}
+
+		Engine::shutdown();
+
+		std::ofstream file(outPath);
+		if (!file.is_open()) {
+			std::cerr << "Failed to write " << outPath << std::endl;
+			return 1;
+		}
+		file << report.dump(2) << std::endl;
+		std::cout << "Results written to " << outPath << std::endl;
+		return ok ? 0 : 1;
+	}
+}
@@ -0,0 +1,79 @@
+#include "Bench.hpp"
+#include "CORE/Engine.hpp"
+#include "CORE/Scene.hpp"
+#include "CORE/SceneFile.hpp"
+#include "CORE/Prefabs/PrefabManager.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+// Building a level object by object with PrefabManager (as DevScene does) against
+// loading the same level from a binary and a JSON scene file.
+namespace Bench
+{
+	namespace
+	{
+		double elapsedMs(std::chrono::steady_clock::time_point start) {
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// Static cubes on a grid with a dynamic one on every fourth
+		void build(Scene& scene, uint32_t count) {
+			uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+			for (uint32_t i = 0; i < count; i++) {
+				glm::vec3 position((i % side) * 2.0f, 0.0f, (i / side) * 2.0f);
+				if (i % 4 == 3) position.y = 3.0f;
+				scene.spawnPrefab(i % 4 == 3 ? "DynamicCubePrefab" : "WorldPrefab", position)->setScale(glm::vec3(1.0f));
+			}
+		}
+
+		void clear(Scene& scene) {
+			scene.clearGameObjects();
+			scene.getPhysicsScene()->shutdown();
+		}
+	}
+
+	int runScene(int argc, char** argv) {
+		uint32_t count = getArgU32(argc, argv, "--count", 20000);
+		std::string binaryPath = getArg(argc, argv, "--out", "bench_scene.clcs");
+		std::string jsonPath = binaryPath + ".json";
+
+		Engine::initHeadless();
+
+		std::cout << std::fixed << std::setprecision(2);
+		{
+			Scene scene;
+			auto start = std::chrono::steady_clock::now();
+			build(scene, count);
+			std::cout << count << " objects, prefab by prefab: " << elapsedMs(start) << " ms" << std::endl;
+
+			start = std::chrono::steady_clock::now();
+			SceneFile::save(scene, binaryPath);
+			double saveBinaryMs = elapsedMs(start);
+			start = std::chrono::steady_clock::now();
+			SceneFile::save(scene, jsonPath);
+			double saveJsonMs = elapsedMs(start);
+			std::cout << "save: binary " << saveBinaryMs << " ms, json " << saveJsonMs << " ms" << std::endl;
+			clear(scene);
+		}
+
+		for (const std::string& path : { binaryPath, jsonPath }) {
+			Scene scene;
+			SceneFile::LoadStats stats;
+			auto start = std::chrono::steady_clock::now();
+			bool ok = SceneFile::load(scene, path, &stats);
+			double totalMs = elapsedMs(start);
+			std::cout << path << ": " << (ok ? "" : "FAILED ") << totalMs << " ms (read " << stats.readMs
+				<< ", create " << stats.createMs << ", add " << stats.addMs << "), "
+				<< stats.objects << " objects, " << stats.components << " components" << std::endl;
+			clear(scene);
+		}
+
+		Engine::shutdown();
+		std::remove(binaryPath.c_str());
+		std::remove(jsonPath.c_str());
+		return 0;
+	}
+}
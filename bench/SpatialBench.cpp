@@ -0,0 +1,135 @@
+#include "Bench.hpp"
+#include "CORE/SpatialIndex.hpp"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+
+// N boxes of mixed sizes drifting each frame: incremental updates of the moving ones,
+// then sphere, box and ray queries, for each index type. A linear scan of the same
+// queries is the baseline and checks the hit counts.
+namespace Bench
+{
+	namespace
+	{
+		double millisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+		struct Query {
+			glm::vec3 center;
+			float radius;
+			glm::vec3 direction;
+		};
+	}
+
+	int runSpatial(int argc, char** argv) {
+		uint32_t count = getArgU32(argc, argv, "--count", 100000);
+		uint32_t frames = getArgU32(argc, argv, "--frames", 60);
+		uint32_t moving = std::min(getArgU32(argc, argv, "--moving", 100), 100u);
+		uint32_t queries = getArgU32(argc, argv, "--queries", 200);
+		std::string type = getArg(argc, argv, "--type", "both");
+		const float extent = 1000.0f;
+
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> position(-extent, extent);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> size(0.25f, 2.0f);
+
+		std::vector<Aabb> boxes(count);
+		std::vector<glm::vec3> velocities(count);
+		for (uint32_t i = 0; i < count; i++) {
+			// One in a hundred is a building-sized box
+			float half = i % 100 == 0 ? size(rng) * 20.0f : size(rng);
+			boxes[i] = Aabb::fromCenter(glm::vec3(position(rng), position(rng), position(rng)), glm::vec3(half));
+			velocities[i] = glm::vec3(unit(rng), unit(rng), unit(rng)) * 0.5f;
+		}
+		std::vector<Query> queryList(queries);
+		for (Query& query : queryList) {
+			query.center = glm::vec3(position(rng), position(rng), position(rng));
+			query.radius = 10.0f + 40.0f * (unit(rng) * 0.5f + 0.5f);
+			query.direction = glm::vec3(unit(rng), unit(rng), unit(rng));
+			query.direction = query.direction / std::max(glm::length(query.direction), 0.001f);
+		}
+		const uint32_t movingCount = static_cast<uint32_t>(static_cast<uint64_t>(count) * moving / 100);
+
+		std::cout << "spatial benchmark: " << count << " boxes, " << movingCount << " moving, "
+			<< queries << " queries x3 per frame, " << frames << " frames\n";
+
+		// Linear scan of the first frame, the reference hit count
+		size_t scanHits = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (const Query& query : queryList) {
+			Aabb box = Aabb::fromCenter(query.center, glm::vec3(query.radius));
+			glm::vec3 inverse = 1.0f / query.direction;
+			for (const Aabb& bounds : boxes) {
+				float distance;
+				scanHits += bounds.intersectsSphere(query.center, query.radius);
+				scanHits += bounds.intersects(box);
+				scanHits += bounds.intersectsRay(query.center, inverse, query.radius * 4.0f, distance);
+			}
+		}
+		double scanMs = millisecondsSince(start);
+		std::cout << std::left << std::setw(10) << "scan" << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(10) << scanMs << " ms/frame queries  " << scanHits << " hits\n";
+
+		for (SpatialIndex::Type indexType : { SpatialIndex::Type::HASH_GRID, SpatialIndex::Type::LOOSE_OCTREE }) {
+			if (type != "both" && type != SpatialIndex::toString(indexType)) continue;
+
+			SpatialIndex::Settings settings;
+			settings.type = indexType;
+			settings.worldMin = glm::vec3(-extent * 1.5f);
+			settings.worldMax = glm::vec3(extent * 1.5f);
+			std::unique_ptr<SpatialIndex> index = SpatialIndex::create(settings);
+			std::vector<Aabb> current = boxes;
+			std::vector<SpatialIndex::Id> ids(count);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < count; i++) ids[i] = index->insert(nullptr, current[i]);
+			double buildMs = millisecondsSince(start);
+
+			std::vector<SpatialIndex::Id> found;
+			std::vector<SpatialIndex::RayHit> hits;
+			size_t firstFrameHits = 0;
+			double updateMs = 0.0;
+			double queryMs = 0.0;
+			for (uint32_t frame = 0; frame < frames; frame++) {
+				start = std::chrono::high_resolution_clock::now();
+				// The first frame queries the initial boxes, to compare with the scan
+				if (frame > 0) {
+					for (uint32_t i = 0; i < movingCount; i++) {
+						current[i].min += velocities[i];
+						current[i].max += velocities[i];
+						index->update(ids[i], current[i]);
+					}
+				}
+				updateMs += millisecondsSince(start);
+
+				start = std::chrono::high_resolution_clock::now();
+				size_t frameHits = 0;
+				for (const Query& query : queryList) {
+					found.clear();
+					index->querySphere(query.center, query.radius, found);
+					frameHits += found.size();
+					found.clear();
+					index->queryAabb(Aabb::fromCenter(query.center, glm::vec3(query.radius)), found);
+					frameHits += found.size();
+					hits.clear();
+					index->queryRay(query.center, query.direction, query.radius * 4.0f, hits);
+					frameHits += hits.size();
+				}
+				queryMs += millisecondsSince(start);
+				if (frame == 0) firstFrameHits = frameHits;
+			}
+
+			std::cout << std::left << std::setw(10) << SpatialIndex::toString(indexType) << std::right << std::fixed << std::setprecision(3)
+				<< std::setw(10) << queryMs / frames << " ms/frame queries  "
+				<< std::setw(8) << updateMs / std::max(frames - 1, 1u) << " ms/frame updates  "
+				<< std::setw(8) << buildMs << " ms build  x"
+				<< std::setprecision(1) << (queryMs > 0.0 ? scanMs * frames / queryMs : 0.0) << "\n";
+			if (firstFrameHits != scanHits)
+				std::cerr << SpatialIndex::toString(indexType) << " found " << firstFrameHits << " hits, the scan " << scanHits << std::endl;
+		}
+		return 0;
+	}
+}
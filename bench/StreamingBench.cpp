@@ -0,0 +1,104 @@
+#include "Bench.hpp"
+#include "CORE/Engine.hpp"
+#include "CORE/Scene.hpp"
+#include "CORE/SceneData.hpp"
+#include "CORE/WorldStreamer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <chrono>
+#include <cmath>
+
+// A flat world of static and dynamic cubes baked into cells, crossed by a point moving
+// in a straight line. Reports the main thread time spent on streaming per frame and the
+// latency and memory of each cell load.
+namespace Bench
+{
+	namespace
+	{
+		void buildWorld(SceneData& world, uint32_t count, float extent) {
+			uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+			float spacing = extent / side;
+			for (uint32_t i = 0; i < count; i++) {
+				bool dynamic = i % 4 == 3;
+				glm::vec3 position((i % side) * spacing, dynamic ? 3.0f : 0.0f, (i / side) * spacing);
+				world.addObject("cube" + std::to_string(i), "", -1, position, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+				world.addComponent("CubeRenderer");
+				world.addVec4("color", glm::vec4(0.8f, 0.8f, 0.8f, 1.0f));
+				world.addComponent("CubePhysics");
+				world.addText("body", dynamic ? "dynamic" : "static");
+				world.addFloat("mass", 1.0f);
+			}
+		}
+	}
+
+	int runStreaming(int argc, char** argv) {
+		uint32_t count = getArgU32(argc, argv, "--count", 200000);
+		float extent = static_cast<float>(getArgU32(argc, argv, "--extent", 4096));
+		float cellSize = static_cast<float>(getArgU32(argc, argv, "--cell", 64));
+		uint32_t frames = getArgU32(argc, argv, "--frames", 1200);
+		float speed = static_cast<float>(getArgU32(argc, argv, "--speed", 60));
+		std::string directory = getArg(argc, argv, "--dir", "bench_world");
+
+		Engine::initHeadless();
+
+		{
+			auto start = std::chrono::steady_clock::now();
+			SceneData world;
+			buildWorld(world, count, extent);
+			size_t cells = WorldStreamer::bake(world, cellSize, directory);
+			std::cout << count << " objects baked into " << cells << " cells in "
+				<< std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+		}
+
+		std::vector<double> frameMs;
+		std::vector<double> latencyMs, readMs, memoryKb;
+		uint32_t maxLoaded = 0, committed = 0, unloaded = 0, failed = 0;
+		{
+			Scene scene;
+			WorldStreamer& streaming = scene.getStreaming();
+			if (!streaming.open(directory, WorldStreamer::loadSettings("../../../Config/streaming.json")))
+				frames = 0;
+
+			// Diagonal across the world, at walking height
+			const float dt = 1.0f / 60.0f;
+			glm::vec3 position(0.0f, 2.0f, 0.0f);
+			glm::vec3 direction = glm::vec3(1.0f, 0.0f, 1.0f) / std::sqrt(2.0f);
+			for (uint32_t frame = 0; frame < frames; frame++) {
+				position += direction * speed * dt;
+				streaming.update(scene, position);
+				scene.update(dt);
+
+				const WorldStreamer::FrameStats& stats = streaming.getFrameStats();
+				frameMs.push_back(stats.commitMs);
+				maxLoaded = std::max(maxLoaded, stats.loadedCells);
+				unloaded += stats.unloadedCells;
+				failed = std::max(failed, stats.failedCells);
+				for (uint32_t index : streaming.getCommittedCells()) {
+					const WorldStreamer::CellStats& cell = streaming.getCellStats(index);
+					latencyMs.push_back(cell.latencyMs);
+					readMs.push_back(cell.readMs);
+					memoryKb.push_back((cell.fileBytes + cell.textureBytes + cell.memoryBytes) / 1024.0);
+				}
+				committed += stats.committedCells;
+			}
+			streaming.close(scene);
+			scene.clearGameObjects();
+			scene.getPhysicsScene()->shutdown();
+		}
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << frames << " frames, " << committed << " cells committed, " << unloaded << " unloaded, "
+			<< maxLoaded << " loaded at most, " << failed << " failed at most" << std::endl;
+		std::cout << "streaming ms/frame  p50 " << percentile(frameMs, 50.0) << "  p99 " << percentile(frameMs, 99.0)
+			<< "  max " << (frameMs.empty() ? 0.0 : frameMs.back()) << std::endl;
+		std::cout << "cell latency ms     p50 " << percentile(latencyMs, 50.0) << "  p99 " << percentile(latencyMs, 99.0) << std::endl;
+		std::cout << "cell read ms        p50 " << percentile(readMs, 50.0) << "  p99 " << percentile(readMs, 99.0) << std::endl;
+		std::cout << "cell memory KB      p50 " << percentile(memoryKb, 50.0) << "  max " << (memoryKb.empty() ? 0.0 : memoryKb.back()) << std::endl;
+
+		Engine::shutdown();
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+		return 0;
+	}
+}
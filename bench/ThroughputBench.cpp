@@ -0,0 +1,239 @@
+#include "Bench.hpp"
+#include "CORE/Engine.hpp"
+#include "CORE/Scene.hpp"
+#include "CORE/Prefabs/PrefabManager.hpp"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+// Scales a pile / grid of prefab bodies over the WorldPrefab ground, for every
+// body count x dispatcher thread count, and reports step percentiles as JSON.
+namespace Bench
+{
+	namespace
+	{
+		struct ThroughputParams {
+			std::vector<uint32_t> bodyCounts = { 1000, 5000, 10000 };
+			std::vector<uint32_t> threadCounts = { 1, 2, 4, 8 };
+			std::string layout = "grid";   // grid | pile | clusters
+			bool aggregates = true;        // clusters layout: CubePilePrefab groups as PxAggregates
+			std::string prefab = "mixed";  // cube | sphere | mixed
+			uint32_t frames = 600;
+			uint32_t warmup = 30;
+			float spacing = 2.5f;
+		};
+
+		// Resident and peak resident memory of the process, in bytes
+		void getMemory(uint64_t& current, uint64_t& peak) {
+			current = 0;
+			peak = 0;
+#ifdef _WIN32
+			PROCESS_MEMORY_COUNTERS counters;
+			if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+				current = counters.WorkingSetSize;
+				peak = counters.PeakWorkingSetSize;
+			}
+#else
+			std::ifstream status("/proc/self/status");
+			std::string line;
+			while (std::getline(status, line)) {
+				if (line.rfind("VmRSS:", 0) == 0)
+					current = std::stoull(line.substr(6)) * 1024;
+				else if (line.rfind("VmHWM:", 0) == 0)
+					peak = std::stoull(line.substr(6)) * 1024;
+			}
+#endif
+		}
+
+		std::vector<uint32_t> parseList(const std::string& text, const std::vector<uint32_t>& fallback) {
+			if (text.empty()) return fallback;
+			std::vector<uint32_t> values;
+			std::stringstream ss(text);
+			std::string item;
+			while (std::getline(ss, item, ',')) {
+				if (!item.empty())
+					values.push_back(static_cast<uint32_t>(std::stoul(item)));
+			}
+			return values;
+		}
+
+		const char* prefabFor(const ThroughputParams& params, uint32_t i) {
+			if (params.prefab == "cube") return "DynamicCubePrefab";
+			if (params.prefab == "sphere") return "SpherePrefab";
+			return i % 2 ? "SpherePrefab" : "DynamicCubePrefab";
+		}
+
+		// Grid: one layer spread on the ground. Pile: a compact column that collapses.
+		glm::vec3 spawnPosition(const ThroughputParams& params, uint32_t i, uint32_t count) {
+			if (params.layout == "pile") {
+				uint32_t side = std::max(1u, static_cast<uint32_t>(std::cbrt(static_cast<float>(count))));
+				uint32_t x = i % side, z = (i / side) % side, y = i / (side * side);
+				float half = side * params.spacing * 0.5f;
+				return glm::vec3(x * params.spacing - half, 2.0f + y * params.spacing, z * params.spacing - half);
+			}
+			uint32_t side = std::max(1u, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count)))));
+			float half = side * params.spacing * 0.5f;
+			return glm::vec3((i % side) * params.spacing - half, 2.0f, (i / side) * params.spacing - half);
+		}
+
+		nlohmann::json percentiles(std::vector<double>& samples) {
+			double sum = 0.0;
+			for (double s : samples) sum += s;
+			nlohmann::json out;
+			out["mean"] = samples.empty() ? 0.0 : sum / samples.size();
+			out["p50"] = percentile(samples, 50.0);
+			out["p95"] = percentile(samples, 95.0);
+			out["p99"] = percentile(samples, 99.0);
+			out["max"] = samples.empty() ? 0.0 : samples.back();
+			return out;
+		}
+
+		nlohmann::json run(const ThroughputParams& params, uint32_t bodyCount, uint32_t threads) {
+			uint64_t memoryBefore, peakBefore;
+			getMemory(memoryBefore, peakBefore);
+
+			// Measures PhysX's own dispatcher at each thread count, not the shared pool
+			Physics::SceneConfig config;
+			config.useJobSystem = false;
+			config.dispatcherThreads = threads;
+			Scene scene(config);
+			// Bodies and their components come from the scene pools
+			SceneMemory::Scope memoryScope(scene.getMemory());
+
+			// Ground sized to the spawn area, it sits at WorldPrefab's default height
+			auto ground = PrefabManager::instantiate("WorldPrefab");
+			float side = std::ceil(std::sqrt(static_cast<float>(bodyCount))) * params.spacing + 20.0f;
+			ground->setScale(glm::vec3(std::max(side, 100.0f), 1.0f, std::max(side, 100.0f)));
+			scene.addGameObject(ground);
+
+			glm::vec3 origin = ground->getPosition() + glm::vec3(0.0f, 0.5f, 0.0f);
+			if (params.layout == "clusters") {
+				// 64 cube piles on a grid, spaced so each pile keeps its own spot
+				const uint32_t pileSize = 64;
+				uint32_t nbPiles = std::max(1u, bodyCount / pileSize);
+				ThroughputParams pileGrid = params;
+				pileGrid.layout = "grid";
+				pileGrid.spacing = 8.0f;
+				for (uint32_t i = 0; i < nbPiles; i++) {
+					PrefabGroup pile = PrefabManager::instantiateGroup("CubePilePrefab", origin + spawnPosition(pileGrid, i, nbPiles));
+					scene.addGameObjects(pile.objects, params.aggregates, pile.selfCollision);
+				}
+			}
+			else {
+				for (uint32_t i = 0; i < bodyCount; i++) {
+					auto body = PrefabManager::instantiate(prefabFor(params, i), origin + spawnPosition(params, i, bodyCount));
+					scene.addGameObject(body);
+				}
+			}
+
+			const float dt = 1.0f / 60.0f;
+			for (uint32_t frame = 0; frame < params.warmup; frame++) {
+				scene.update(dt);
+			}
+
+			std::vector<double> stepMs, frameMs;
+			stepMs.reserve(params.frames);
+			frameMs.reserve(params.frames);
+			uint64_t activeSum = 0;
+			uint32_t activeMax = 0;
+			uint64_t newPairsSum = 0, contactPairsSum = 0;
+			uint32_t aggregates = 0;
+
+			for (uint32_t frame = 0; frame < params.frames; frame++) {
+				auto start = std::chrono::high_resolution_clock::now();
+				scene.update(dt);
+				frameMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+
+				const PhysicsStepStats& stats = scene.getPhysicsScene()->getStats().getLast();
+				stepMs.push_back(stats.totalMs);
+				activeSum += stats.activeDynamicBodies;
+				activeMax = std::max(activeMax, stats.activeDynamicBodies);
+				newPairsSum += stats.newPairs;
+				contactPairsSum += stats.contactPairs;
+				aggregates = stats.aggregates;
+			}
+
+			uint64_t memoryAfter, peakAfter;
+			getMemory(memoryAfter, peakAfter);
+
+			nlohmann::json result;
+			result["bodies"] = static_cast<uint32_t>(scene.getGameObjects().size() - 1); // clusters round to whole piles
+			result["threads"] = threads;
+			result["step_ms"] = percentiles(stepMs);
+			result["frame_ms"] = percentiles(frameMs);
+			result["active_bodies_mean"] = params.frames ? static_cast<double>(activeSum) / params.frames : 0.0;
+			result["active_bodies_max"] = activeMax;
+			result["aggregates"] = aggregates;
+			result["new_pairs_mean"] = params.frames ? static_cast<double>(newPairsSum) / params.frames : 0.0;
+			result["contact_pairs_mean"] = params.frames ? static_cast<double>(contactPairsSum) / params.frames : 0.0;
+			result["memory_bytes"] = memoryAfter;
+			result["memory_delta_bytes"] = static_cast<int64_t>(memoryAfter) - static_cast<int64_t>(memoryBefore);
+			result["peak_memory_bytes"] = peakAfter;
+
+			// Actors go before their scene
+			scene.clearGameObjects();
+			scene.getPhysicsScene()->shutdown();
+			return result;
+		}
+	}
+
+	int runThroughput(int argc, char** argv) {
+		ThroughputParams params;
+		params.bodyCounts = parseList(getArg(argc, argv, "--counts", ""), params.bodyCounts);
+		params.threadCounts = parseList(getArg(argc, argv, "--threads", ""), params.threadCounts);
+		params.layout = getArg(argc, argv, "--layout", params.layout);
+		params.prefab = getArg(argc, argv, "--prefab", params.prefab);
+		params.aggregates = getArgU32(argc, argv, "--aggregates", params.aggregates ? 1 : 0) != 0;
+		params.frames = getArgU32(argc, argv, "--frames", params.frames);
+		params.warmup = getArgU32(argc, argv, "--warmup", params.warmup);
+		// Engine init logs to stdout, so the report goes to a file
+		std::string outPath = getArg(argc, argv, "--out", "physics_throughput.json");
+
+		Engine::initHeadless();
+
+		nlohmann::json report;
+		report["benchmark"] = "physics_throughput";
+		report["timestamp"] = static_cast<int64_t>(std::time(nullptr));
+		report["physx_version"] = std::to_string(PX_PHYSICS_VERSION_MAJOR) + "." + std::to_string(PX_PHYSICS_VERSION_MINOR)
+			+ "." + std::to_string(PX_PHYSICS_VERSION_BUGFIX);
+		report["hardware_threads"] = std::thread::hardware_concurrency();
+		report["layout"] = params.layout;
+		report["prefab"] = params.prefab;
+		report["aggregates"] = params.aggregates;
+		report["frames"] = params.frames;
+		report["warmup"] = params.warmup;
+		report["results"] = nlohmann::json::array();
+
+		for (uint32_t count : params.bodyCounts) {
+			for (uint32_t threads : params.threadCounts) {
+				nlohmann::json result = run(params, count, threads);
+				std::cerr << count << " bodies, " << threads << " threads: p50 "
+					<< result["step_ms"]["p50"].get<double>() << " ms, p99 "
+					<< result["step_ms"]["p99"].get<double>() << " ms" << std::endl;
+				report["results"].push_back(result);
+			}
+		}
+
+		Engine::shutdown();
+
+		std::ofstream file(outPath);
+		if (!file.is_open()) {
+			std::cerr << "Failed to write " << outPath << std::endl;
+			return 1;
+		}
+		file << report.dump(2) << std::endl;
+		std::cout << "Results written to " << outPath << std::endl;
+		return 0;
+	}
+}
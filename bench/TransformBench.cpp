@@ -0,0 +1,97 @@
+#include "Bench.hpp"
+#include "CORE/Transform.hpp"
+#include "CORE/TransformBatch.hpp"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+// World and normal matrices of N moving transforms per frame: one at a time through
+// Transform::getModelMatrix (GLM), then through every TransformBatch kernel the CPU runs.
+namespace Bench
+{
+	namespace
+	{
+		double millisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+		void report(const char* name, uint32_t count, uint32_t frames, double ms, double baselineMs) {
+			double perSecond = ms > 0.0 ? count * static_cast<double>(frames) / (ms / 1000.0) : 0.0;
+			std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(3)
+				<< std::setw(10) << ms / frames << " ms/frame  "
+				<< std::setprecision(1) << std::setw(8) << perSecond / 1.0e6 << " M matrices/s  x"
+				<< std::setprecision(2) << (ms > 0.0 ? baselineMs / ms : 0.0) << "\n";
+		}
+	}
+
+	int runTransforms(int argc, char** argv) {
+		uint32_t count = getArgU32(argc, argv, "--count", 50000);
+		uint32_t frames = getArgU32(argc, argv, "--frames", 100);
+
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+		std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+		std::vector<Transform> transforms(count);
+		TransformBatch::Soa soa;
+		soa.resize(count);
+		for (uint32_t i = 0; i < count; i++) {
+			transforms[i].setPosition(glm::vec3(position(rng), position(rng), position(rng)));
+			transforms[i].setRotation(glm::vec3(angle(rng), angle(rng), angle(rng)));
+			transforms[i].setScale(glm::vec3(scale(rng), scale(rng), scale(rng)));
+			soa.set(i, transforms[i].getPosition(), transforms[i].getRotationQuaternion(), transforms[i].getScale());
+		}
+
+		std::cout << "transform benchmark: " << count << " transforms, " << frames << " frames, best kernel "
+			<< TransformBatch::toString(TransformBatch::getBestKernel()) << "\n";
+
+		// Every transform moves each frame, the cache is rebuilt through GLM one by one
+		float checksum = 0.0f;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t frame = 0; frame < frames; frame++) {
+			for (Transform& transform : transforms) {
+				transform.move(glm::vec3(0.0f, 0.001f, 0.0f));
+				checksum += transform.getModelMatrix()[3][1];
+				checksum += transform.getNormalMatrix()[0][0];
+			}
+		}
+		double glmMs = millisecondsSince(start);
+		report("glm getModelMatrix", count, frames, glmMs, glmMs);
+
+		std::vector<glm::mat4> world(count);
+		std::vector<glm::mat3> normal(count);
+		std::vector<glm::mat4> reference(count);
+		TransformBatch::compute(soa, reference.data(), nullptr, TransformBatch::Kernel::SCALAR);
+
+		for (TransformBatch::Kernel kernel : { TransformBatch::Kernel::SCALAR, TransformBatch::Kernel::SSE, TransformBatch::Kernel::AVX2 }) {
+			if (!TransformBatch::isSupported(kernel)) {
+				std::cout << std::left << std::setw(20) << TransformBatch::toString(kernel) << "unsupported on this CPU\n";
+				continue;
+			}
+
+			start = std::chrono::high_resolution_clock::now();
+			for (uint32_t frame = 0; frame < frames; frame++) {
+				TransformBatch::compute(soa, world.data(), normal.data(), kernel);
+				checksum += world[frame % count][3][1];
+			}
+			double ms = millisecondsSince(start);
+			report(TransformBatch::toString(kernel), count, frames, ms, glmMs);
+
+			float maxError = 0.0f;
+			for (uint32_t i = 0; i < count; i++) {
+				for (int c = 0; c < 4; c++) {
+					for (int r = 0; r < 4; r++) maxError = std::max(maxError, std::abs(world[i][c][r] - reference[i][c][r]));
+				}
+			}
+			if (maxError > 1e-3f)
+				std::cerr << TransformBatch::toString(kernel) << " differs from the scalar kernel by " << maxError << std::endl;
+		}
+
+		// Keeps the loops from being optimized away
+		std::cout << "checksum " << checksum << std::endl;
+		return 0;
+	}
+}
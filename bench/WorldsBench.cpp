@@ -0,0 +1,118 @@
+#include "Bench.hpp"
+#include "CORE/Physics.hpp"
+#include "CORE/PhysicsScene.hpp"
+#include "CORE/PhysicsWorldStepper.hpp"
+#include "CORE/Jobs/JobSystem.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+
+// Many small independent worlds (a ground plus a stack of boxes each), stepped one
+// after the other and then concurrently through PhysicsWorldStepper.
+namespace Bench
+{
+	namespace
+	{
+		struct WorldsParams {
+			uint32_t nbWorlds = 64;
+			uint32_t bodiesPerWorld = 200;
+			uint32_t frames = 300;
+		};
+
+		std::vector<std::unique_ptr<PhysicsScene>> createWorlds(const WorldsParams& params) {
+			PxPhysics* physics = Physics::getPhysics();
+			PxMaterial* material = Physics::getDefaultMaterial();
+
+			// No dispatcher threads: the stepper pool is the only source of parallelism
+			Physics::SceneConfig config;
+			config.useJobSystem = false;
+			config.dispatcherThreads = 0;
+
+			std::vector<std::unique_ptr<PhysicsScene>> worlds;
+			for (uint32_t w = 0; w < params.nbWorlds; w++) {
+				auto world = std::make_unique<PhysicsScene>();
+				world->init(config);
+				world->addActor(PxCreatePlane(*physics, PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material));
+				for (uint32_t i = 0; i < params.bodiesPerWorld; i++) {
+					// Loose columns of 10 so every world keeps colliding for a while
+					PxVec3 position((i % 10) * 1.1f, 1.0f + (i / 10) * 1.05f, (w % 7) * 0.01f);
+					world->addActor(PxCreateDynamic(*physics, PxTransform(position), PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, 1.0f));
+				}
+				worlds.push_back(std::move(world));
+			}
+			return worlds;
+		}
+
+		void destroyWorlds(std::vector<std::unique_ptr<PhysicsScene>>& worlds) {
+			PxActorTypeFlags types = PxActorTypeFlag::eRIGID_STATIC | PxActorTypeFlag::eRIGID_DYNAMIC;
+			for (auto& world : worlds) {
+				PxScene* pxScene = world->getScene();
+				std::vector<PxActor*> actors(pxScene->getNbActors(types));
+				pxScene->getActors(types, actors.data(), static_cast<PxU32>(actors.size()));
+				for (PxActor* actor : actors) actor->release();
+				world->shutdown();
+			}
+			worlds.clear();
+		}
+
+		double runSerial(const WorldsParams& params) {
+			auto worlds = createWorlds(params);
+			auto start = std::chrono::high_resolution_clock::now();
+			for (uint32_t frame = 0; frame < params.frames; frame++) {
+				for (auto& world : worlds) world->update(1.0f / 60.0f);
+			}
+			double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			destroyWorlds(worlds);
+			return ms;
+		}
+
+		double runStepper(const WorldsParams& params, double& slowestWorldMs) {
+			auto worlds = createWorlds(params);
+			PhysicsWorldStepper stepper;
+			for (auto& world : worlds) {
+				stepper.addWorld(world.get(), 60.0f);
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (uint32_t frame = 0; frame < params.frames; frame++) {
+				stepper.advance(1.0f / 60.0f);
+			}
+			double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+			slowestWorldMs = 0.0;
+			for (size_t w = 0; w < stepper.getWorldCount(); w++) {
+				slowestWorldMs = std::max(slowestWorldMs, stepper.getTiming(w).totalMs);
+			}
+			stepper.clear();
+			destroyWorlds(worlds);
+			return ms;
+		}
+	}
+
+	int runWorlds(int argc, char** argv) {
+		WorldsParams params;
+		params.nbWorlds = getArgU32(argc, argv, "--worlds", params.nbWorlds);
+		params.bodiesPerWorld = getArgU32(argc, argv, "--bodies", params.bodiesPerWorld);
+		params.frames = getArgU32(argc, argv, "--frames", params.frames);
+
+		JobSystem::init(getArgU32(argc, argv, "--threads", 0));
+		Physics::init();
+
+		std::cout << "multi world benchmark: " << params.nbWorlds << " worlds x " << params.bodiesPerWorld
+			<< " bodies, " << params.frames << " frames, " << JobSystem::getThreadCount() << " pool threads\n";
+
+		double serialMs = runSerial(params);
+		double slowestWorldMs = 0.0;
+		double stepperMs = runStepper(params, slowestWorldMs);
+
+		std::cout << std::fixed << std::setprecision(3)
+			<< "serial   " << serialMs << " ms (" << serialMs / params.frames << " ms/frame)\n"
+			<< "stepper  " << stepperMs << " ms (" << stepperMs / params.frames << " ms/frame)\n"
+			<< "slowest world " << slowestWorldMs << " ms total" << std::endl;
+
+		Physics::shutdown();
+		JobSystem::shutdown();
+		return 0;
+	}
+}
@@ -9,6 +9,7 @@ out vec2 TexCoords;
 out vec4 FragPosLightSpace;
 
 uniform mat4 model;
+uniform mat3 normalMatrix;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat4 lightSpaceMatrix;
@@ -16,7 +17,7 @@ uniform mat4 lightSpaceMatrix;
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
+    Normal = normalMatrix * aNormal;  // inverse transpose of the model, computed on the CPU once per object
     TexCoords = vec2(aTexCoords.x, 1.0 - aTexCoords.y);
     FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
     gl_Position = projection * view * vec4(FragPos, 1.0);
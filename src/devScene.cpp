@@ -1,8 +1,7 @@
 #include "devScene.hpp"
 
 void DevScene::init() {
-	auto prefCube = PrefabManager::instantiate("DynamicCubePrefab");
-	addGameObject(prefCube);
+	auto prefCube = spawnPrefab("DynamicCubePrefab");
 
 	prefCube->setPosition(glm::vec3(0.0f, 10.0f, 0.0f));
 
@@ -150,12 +149,10 @@ void DevScene::onImGuiRender() {
 			auto cameraDir = getCamera()->getRotation();
 			PxRaycastHit hitInfo;
 			if (Physics::raycast(getPhysicsScene()->getScene(), cameraPos, glm::normalize(cameraDir), 1000.0f, hitInfo)) {
-				GameObject* hitObject = static_cast<GameObject*>(hitInfo.actor->userData);
+				GameObject* hitObject = PhysicsComponent::getHitObject(hitInfo.actor, hitInfo.shape);
 				UI::handleRaycastSelection(hitObject);
 				if (Input::isKeyPressed(GLFW_KEY_P)) {
-					addGameObject(
-						PrefabManager::instantiate("CubePrefab",
-							glm::vec3(hitInfo.position.x, hitInfo.position.y, hitInfo.position.z)));
+					spawnPrefab("CubePrefab", glm::vec3(hitInfo.position.x, hitInfo.position.y, hitInfo.position.z));
 				}
 			}
 		}
@@ -181,6 +178,32 @@ void DevScene::onImGuiRender() {
 	}
 	ImGui::End();
 
+	//physics snapshot save / reset
+	ImGui::Begin("Physics");
+	if (ImGui::Button("Save snapshot")) {
+		savePhysicsSnapshot(physicsSnapshot);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Restore snapshot") && !physicsSnapshot.empty()) {
+		loadPhysicsSnapshot(physicsSnapshot);
+	}
+	ImGui::Text("Snapshot size: %zu bytes", physicsSnapshot.data.size());
+
+	// Session recording for headless replays (CLC_Bench replay --in session.clcr)
+	ImGui::Separator();
+	if (!PhysicsRecorder::isRecording(this)) {
+		if (ImGui::Button("Start recording")) {
+			PhysicsRecorder::start(this);
+		}
+	}
+	else {
+		if (ImGui::Button("Stop recording")) {
+			PhysicsRecorder::stop("session.clcr");
+		}
+		ImGui::Text("%u steps, %zu bytes", PhysicsRecorder::getStepCount(), PhysicsRecorder::getStreamSize());
+	}
+	ImGui::End();
+
 	//farplan and ortho size edit
 	ImGui::Begin("LGITH");
 	float farPlane = LightManager::getShadowMapper()->getFarPlane();
@@ -13,6 +13,7 @@
 #include "../CORE/UI/SceneObjectEditor.hpp"
 #include "../CORE/RenderComponents/ModelRenderer.hpp"
 #include "../CORE/Cameras/CameraMC.hpp"
+#include "../CORE/PhysicsRecorder.hpp"
 
 
 class DevScene : public Scene {
@@ -26,5 +27,6 @@ public:
 	private:
 	
 		std::shared_ptr<Light> sunLight;
+		PhysicsSnapshot physicsSnapshot;
 
 };
\ No newline at end of file
@@ -8,7 +8,10 @@ int main() {
 
 	// Create scene
 	DevScene scene;
+	scene.setSpatialIndex(SpatialIndex::loadSettings("../../../Config/spatial.json"));
 	scene.init();
+	// Level is loaded, static pieces can share actors from now on
+	scene.mergeStaticColliders();
 
 
 	// Enable depth testing